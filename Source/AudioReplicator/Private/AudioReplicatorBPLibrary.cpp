@@ -1,7 +1,16 @@
 #include "AudioReplicatorBPLibrary.h"
 #include "OpusCodec.h"
+#include "AudioReplicatorCodecPoolSubsystem.h"
 #include "PcmWavUtils.h"
 #include "Chunking.h"
+#include "PackedClip.h"
+#include "OggOpusUtils.h"
+#include "OpusPacketList.h"
+#include "OpusRepacketizer.h"
+#include "OpusResampler.h"
+#include "OpusMultistream.h"
+#include "OpusProjection.h"
+#include "OpusCustom.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
 
@@ -15,29 +24,118 @@ static void Int32ToInt16(const TArray<int32>& In, TArray<int16>& Out)
         Out[i] = (int16)v;
     }
 }
-static void Int16ToInt32(const TArray<int16>& In, TArray<int32>& Out)
+static void Int16ToInt32(TConstArrayView<int16> In, TArray<int32>& Out)
 {
     Out.Reset(In.Num());
     Out.AddUninitialized(In.Num());
     for (int32 i = 0; i < In.Num(); ++i) Out[i] = (int32)In[i];
 }
 
-static void WrapPackets(const TArray<TArray<uint8>>& In, TArray<FOpusPacket>& Out)
+// Surround (more than two channels): multistream codec with the family 1 layout, which the decode helpers
+// below rebuild from the channel count alone.
+template <typename SampleType>
+static bool EncodeSurround(TConstArrayView<SampleType> Pcm, int32 SR, int32 Ch, int32 Bitrate, int32 FrameSize, FOpusPacketList& OutPackets)
 {
-    Out.Reset(In.Num());
-    for (const auto& P : In)
+    FOpusMultistreamEncoder Encoder;
+    if (!Encoder.Init(SR, Ch, Bitrate)) return false;
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        return Encoder.EncodeFloatToPacketList(Pcm, FrameSize, OutPackets);
+    }
+    else
     {
-        FOpusPacket W; W.Data = P;
-        Out.Add(MoveTemp(W));
+        return Encoder.EncodePcm16ToPacketList(Pcm, FrameSize, OutPackets);
     }
 }
-static void UnwrapPackets(const TArray<FOpusPacket>& In, TArray<TArray<uint8>>& Out)
+
+static bool InitSurroundDecoder(FOpusMultistreamDecoder& Decoder, int32 SR, int32 Ch)
 {
-    Out.Reset(In.Num());
-    for (const auto& W : In)
+    int32 Streams = 0, Coupled = 0;
+    TArray<uint8> Mapping;
+    return FOpusMultistreamEncoder::GetSurroundLayout(SR, Ch, Streams, Coupled, Mapping)
+        && Decoder.Init(SR, Ch, Streams, Coupled, Mapping);
+}
+
+static bool DecodeViewsToFloat(TConstArrayView<FOpusPacketView> Views, int32 SR, int32 Ch, TArray<float>& OutPcm)
+{
+    if (Ch > 2)
     {
-        Out.Add(W.Data);
+        FOpusMultistreamDecoder Decoder;
+        return InitSurroundDecoder(Decoder, SR, Ch) && Decoder.DecodePacketsToFloat(Views, OutPcm);
     }
+
+    FOpusDecoderLease Decoder = UAudioReplicatorCodecPoolSubsystem::AcquireDecoder(SR, Ch);
+    if (!Decoder) return false;
+
+    return Decoder->DecodePacketsToFloat(Views, OutPcm);
+}
+
+// Decode with Header's layout, keeping the pre-skip and end trim.
+static bool DecodeViewsUntrimmed(TConstArrayView<FOpusPacketView> Views, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate)
+{
+    if (IsOpusCustom(Header))
+    {
+        // Custom-mode streams decode at their own rate only.
+        OutSampleRate = Header.SampleRate;
+        FOpusCustomDecoder Decoder;
+        return Decoder.InitFromHeader(Header) && Decoder.DecodePacketsToFloat(Views, OutPcm);
+    }
+
+    OutSampleRate = GetOpusDecodeSampleRate(Rate, Header.SampleRate);
+    if (IsOpusProjection(Header))
+    {
+        FOpusProjectionDecoder Decoder;
+        return Decoder.InitFromHeader(Header, OutSampleRate) && Decoder.DecodePacketsToFloat(Views, OutPcm);
+    }
+    if (IsOpusMultistream(Header))
+    {
+        FOpusMultistreamDecoder Decoder;
+        return Decoder.InitFromHeader(Header, OutSampleRate) && Decoder.DecodePacketsToFloat(Views, OutPcm);
+    }
+    return DecodeViewsToFloat(Views, OutSampleRate, Header.Channels, OutPcm);
+}
+
+// Shared by the packet array and packed buffer entry points.
+static bool DecodeViewsAtRate(TConstArrayView<FOpusPacketView> Views, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate)
+{
+    if (!DecodeViewsUntrimmed(Views, Header, Rate, OutPcm, OutSampleRate)) return false;
+    TrimOpusDecodedPcm(Header, OutSampleRate, Header.Channels, OutPcm);
+    return true;
+}
+
+// Decode DurationSec from StartSec with PackedClip::SeekPreRollMs of discarded decoder warm-up.
+static bool DecodeReaderRange(const FPackedClipReader& Reader, float StartSec, float DurationSec, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels)
+{
+    OutPcm.Reset();
+    const FOpusStreamHeader& Header = Reader.GetHeader();
+    const int32 StreamRate = Header.SampleRate;
+    const int64 PlayStart = Reader.GetPlayStartSample();
+    const int64 PlayEnd = Reader.GetPlayEndSample();
+    const int64 StartSample = FMath::Clamp<int64>(PlayStart + FMath::RoundToInt64(double(FMath::Max(StartSec, 0.0f)) * StreamRate), PlayStart, PlayEnd);
+    const int64 EndSample = FMath::Clamp<int64>(StartSample + FMath::RoundToInt64(double(FMath::Max(DurationSec, 0.0f)) * StreamRate), StartSample, PlayEnd);
+    const int64 PreRollSamples = GetOpusFrameSamples(StreamRate, PackedClip::SeekPreRollMs);
+
+    TArray<FOpusPacketView> Views;
+    int32 FirstPacket = 0;
+    int64 FirstSample = 0;
+    if (!Reader.ReadRange(StartSample - PreRollSamples, EndSample, Views, FirstPacket, FirstSample)) return false;
+
+    // Decode with the clip's own layout; adaptive startup frames only apply when the range starts inside them.
+    FOpusStreamHeader RangeHeader = Header;
+    RangeHeader.StartupFrames = FMath::Max(0, Header.StartupFrames - FirstPacket);
+
+    TArray<float> Decoded;
+    if (!DecodeViewsUntrimmed(Views, RangeHeader, Rate, Decoded, OutSampleRate)) return false;
+    OutChannels = Header.Channels;
+
+    // Drop the pre-roll and anything past the end; both are in stream samples, the output may be at a lower rate.
+    const int64 Skip = (StartSample - FirstSample) * OutSampleRate / StreamRate;
+    const int64 Keep = (EndSample - StartSample) * OutSampleRate / StreamRate;
+    const int64 Available = Decoded.Num() / FMath::Max(1, OutChannels);
+    const int64 First = FMath::Min(Skip, Available);
+    const int64 Count = FMath::Min(Keep, Available - First);
+    OutPcm.Append(Decoded.GetData() + First * OutChannels, (int32)(Count * OutChannels));
+    return true;
 }
 
 FString UAudioReplicatorBPLibrary::ResolveProjectPath(const FString& Path)
@@ -59,27 +157,123 @@ bool UAudioReplicatorBPLibrary::ProjectDirectoryExists(const FString& Path)
 
 bool UAudioReplicatorBPLibrary::LoadWavToPcm16(const FString& WavPath, TArray<int32>& OutPcm16, int32& OutSampleRate, int32& OutChannels)
 {
-    TArray<int16> Pcm;
-    if (!PcmWav::LoadWavFileToPcm16(WavPath, Pcm, OutSampleRate, OutChannels)) return false;
-    Int16ToInt32(Pcm, OutPcm16);
+    // Widen straight from the mapped file instead of going through an int16 copy.
+    PcmWav::FWavFileView Wav;
+    if (!Wav.Open(WavPath, /*bAllowFloat=*/false, TEXT("LoadWavToPcm16"))) return false;
+    Int16ToInt32(Wav.GetPcm16(), OutPcm16);
+    OutSampleRate = Wav.GetSampleRate();
+    OutChannels = Wav.GetChannels();
     return true;
 }
 
-bool UAudioReplicatorBPLibrary::EncodePcm16ToOpusPackets(const TArray<int32>& Pcm16, int32 SR, int32 Ch, int32 Bitrate, int32 FrameMs, TArray<FOpusPacket>& OutPackets)
+bool UAudioReplicatorBPLibrary::EncodePcm16ToOpusPackets(const TArray<int32>& Pcm16, int32 SR, int32 Ch, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets)
 {
-    const int32 FrameSize = (SR / 1000) * FrameMs; // per channel
+    if (!IsValidOpusFrameMs(FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EncodePcm16ToOpusPackets: %g ms is not an Opus frame duration"), FrameMs);
+        return false;
+    }
+    const int32 FrameSize = GetOpusFrameSamples(SR, FrameMs); // per channel
     TArray<int16> Pcm16s; Int32ToInt16(Pcm16, Pcm16s);
 
-    auto Codec = FOpusCodec::Create(SR, Ch, Bitrate);
-    if (!Codec) return false;
+    FOpusPacketList PacketList;
+    if (Ch > 2)
+    {
+        if (!EncodeSurround<int16>(Pcm16s, SR, Ch, Bitrate, FrameSize, PacketList)) return false;
+        PacketList.ToPackets(OutPackets);
+        return true;
+    }
+
+    FOpusEncoderLease Encoder = UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(SR, Ch, Bitrate);
+    if (!Encoder) return false;
 
-    TArray<TArray<uint8>> RawPackets;
-    if (!Codec->EncodePcm16ToPackets(Pcm16s, FrameSize, RawPackets)) return false;
+    if (!Encoder->EncodePcm16ToPacketList(Pcm16s, FrameSize, PacketList)) return false;
 
-    WrapPackets(RawPackets, OutPackets);
+    PacketList.ToPackets(OutPackets);
     return true;
 }
 
+bool UAudioReplicatorBPLibrary::LoadWavToFloat(const FString& WavPath, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels)
+{
+    return PcmWav::LoadWavFileToFloat(WavPath, OutPcm, OutSampleRate, OutChannels);
+}
+
+bool UAudioReplicatorBPLibrary::EncodeFloatToOpusPackets(const TArray<float>& Pcm, int32 SR, int32 Ch, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets)
+{
+    if (!IsValidOpusFrameMs(FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EncodeFloatToOpusPackets: %g ms is not an Opus frame duration"), FrameMs);
+        return false;
+    }
+    const int32 FrameSize = GetOpusFrameSamples(SR, FrameMs); // per channel
+
+    FOpusPacketList PacketList;
+    if (Ch > 2)
+    {
+        if (!EncodeSurround<float>(Pcm, SR, Ch, Bitrate, FrameSize, PacketList)) return false;
+        PacketList.ToPackets(OutPackets);
+        return true;
+    }
+
+    FOpusEncoderLease Encoder = UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(SR, Ch, Bitrate);
+    if (!Encoder) return false;
+
+    if (!Encoder->EncodeFloatToPacketList(Pcm, FrameSize, PacketList)) return false;
+
+    PacketList.ToPackets(OutPackets);
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::EncodeAmbisonicsToOpusPackets(const TArray<float>& Pcm, int32 SR, int32 Ch, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader)
+{
+    if (!IsValidOpusFrameMs(FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EncodeAmbisonicsToOpusPackets: %g ms is not an Opus frame duration"), FrameMs);
+        return false;
+    }
+
+    FOpusProjectionEncoder Encoder;
+    if (!Encoder.Init(SR, Ch, Bitrate)) return false;
+
+    FOpusPacketList PacketList;
+    if (!Encoder.EncodeFloatToPacketList(Pcm, GetOpusFrameSamples(SR, FrameMs), PacketList)) return false;
+
+    OutHeader = FOpusStreamHeader();
+    OutHeader.SampleRate = SR;
+    OutHeader.Channels = Ch;
+    OutHeader.Bitrate = Bitrate;
+    OutHeader.FrameMs = FrameMs;
+    OutHeader.NumPackets = PacketList.Num();
+    Encoder.WriteLayout(OutHeader);
+
+    PacketList.ToPackets(OutPackets);
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::DecodeOpusPacketsToFloat(const TArray<FOpusPacket>& Packets, int32 SR, int32 Ch, TArray<float>& OutPcm)
+{
+    TArray<FOpusPacketView> Views;
+    GetOpusPacketViews(Packets, Views);
+    return DecodeViewsToFloat(Views, SR, Ch, OutPcm);
+}
+
+bool UAudioReplicatorBPLibrary::ResamplePcmFloat(const TArray<float>& Pcm, int32 InSampleRate, int32 Channels, int32 OutSampleRate, TArray<float>& OutPcm)
+{
+    if (InSampleRate == OutSampleRate)
+    {
+        OutPcm = Pcm;
+        return true;
+    }
+
+    FOpusResampler Resampler;
+    return Resampler.Init(InSampleRate, OutSampleRate, Channels) && Resampler.Process(Pcm, OutPcm);
+}
+
+int32 UAudioReplicatorBPLibrary::GetOpusSampleRateFor(int32 SampleRate)
+{
+    return FOpusResampler::GetOpusRateFor(SampleRate);
+}
+
 void UAudioReplicatorBPLibrary::PackOpusPackets(const TArray<FOpusPacket>& Packets, TArray<uint8>& OutBuffer)
 {
     Chunking::PackWithLengths(Packets, OutBuffer);
@@ -87,35 +281,179 @@ void UAudioReplicatorBPLibrary::PackOpusPackets(const TArray<FOpusPacket>& Packe
 
 bool UAudioReplicatorBPLibrary::UnpackOpusPackets(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets)
 {
-    return Chunking::UnpackWithLengths(Buffer, OutPackets);
+    FOpusStreamHeader Header;
+    return UnpackOpusClip(Buffer, OutPackets, Header);
 }
 
-bool UAudioReplicatorBPLibrary::DecodeOpusPacketsToPcm16(const TArray<FOpusPacket>& Packets, int32 SR, int32 Ch, TArray<int32>& OutPcm16)
+void UAudioReplicatorBPLibrary::PackOpusClip(const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header, TArray<uint8>& OutBuffer)
+{
+    PackedClip::Pack(Header, FOpusPacketList::FromPackets(Packets), OutBuffer);
+}
+
+bool UAudioReplicatorBPLibrary::UnpackOpusClip(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader)
+{
+    if (!PackedClip::IsContainer(Buffer))
+    {
+        OutHeader = FOpusStreamHeader();
+        return Chunking::UnpackWithLengths(Buffer, OutPackets);
+    }
+
+    TArray<FOpusPacketView> Views;
+    if (!PackedClip::UnpackViews(Buffer, OutHeader, Views)) return false;
+
+    OutPackets.Reset(Views.Num());
+    for (const FOpusPacketView& View : Views)
+    {
+        OutPackets.AddDefaulted_GetRef().Data = View;
+    }
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::SaveOggOpusFile(const FString& Path, const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header)
 {
-    auto Codec = FOpusCodec::Create(SR, Ch, 32000);
-    if (!Codec) return false;
+    return OggOpus::SaveOggOpusFile(Path, Header, FOpusPacketList::FromPackets(Packets));
+}
 
-    TArray<TArray<uint8>> RawPackets;
-    UnwrapPackets(Packets, RawPackets);
+bool UAudioReplicatorBPLibrary::LoadOggOpusFile(const FString& Path, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader)
+{
+    FOpusPacketList Packets;
+    if (!OggOpus::LoadOggOpusFile(Path, OutHeader, Packets))
+        return false;
+    Packets.ToPackets(OutPackets);
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::RepacketizeOpusPackets(const TArray<FOpusPacket>& Packets, int32 FramesPerPacket, TArray<FOpusPacket>& OutPackets)
+{
+    FOpusPacketList Merged;
+    FOpusRepacketizer Repacketizer;
+    if (!Repacketizer.Merge(FOpusPacketList::FromPackets(Packets), FMath::Max(1, FramesPerPacket), Merged))
+        return false;
+    Merged.ToPackets(OutPackets);
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::SplitOpusPackets(const TArray<FOpusPacket>& Packets, TArray<FOpusPacket>& OutPackets)
+{
+    FOpusPacketList Split;
+    FOpusRepacketizer Repacketizer;
+    if (!Repacketizer.Split(FOpusPacketList::FromPackets(Packets), Split))
+        return false;
+    Split.ToPackets(OutPackets);
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::DecodeOpusPacketsToPcm16(const TArray<FOpusPacket>& Packets, int32 SR, int32 Ch, TArray<int32>& OutPcm16)
+{
+    // Decode through views: no per-packet copies, one output allocation.
+    TArray<FOpusPacketView> Views;
+    GetOpusPacketViews(Packets, Views);
 
     TArray<int16> Pcm;
-    if (!Codec->DecodePacketsToPcm16(RawPackets, Pcm)) return false;
+    if (Ch > 2)
+    {
+        FOpusMultistreamDecoder Decoder;
+        if (!InitSurroundDecoder(Decoder, SR, Ch) || !Decoder.DecodePacketsToPcm16(Views, Pcm)) return false;
+        Int16ToInt32(Pcm, OutPcm16);
+        return true;
+    }
+
+    FOpusDecoderLease Decoder = UAudioReplicatorCodecPoolSubsystem::AcquireDecoder(SR, Ch);
+    if (!Decoder) return false;
+
+    if (!Decoder->DecodePacketsToPcm16(Views, Pcm)) return false;
     Int16ToInt32(Pcm, OutPcm16);
     return true;
 }
 
+bool UAudioReplicatorBPLibrary::DecodeOpusPacketsAtRate(const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate)
+{
+    TArray<FOpusPacketView> Views;
+    GetOpusPacketViews(Packets, Views);
+    return DecodeViewsAtRate(Views, Header, Rate, OutPcm, OutSampleRate);
+}
+
+bool UAudioReplicatorBPLibrary::DecodePackedOpusAtRate(const TArray<uint8>& Packed, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate)
+{
+    // Views point straight into Packed: one validation pass, no payload copies.
+    FOpusStreamHeader ClipHeader = Header;
+    TArray<FOpusPacketView> Views;
+    if (!PackedClip::UnpackViews(Packed, ClipHeader, Views)) return false;
+    return DecodeViewsAtRate(Views, ClipHeader, Rate, OutPcm, OutSampleRate);
+}
+
+bool UAudioReplicatorBPLibrary::GetPackedClipInfo(const TArray<uint8>& Packed, FOpusStreamHeader& OutHeader, float& OutDurationSec)
+{
+    FPackedClipReader Reader;
+    if (!Reader.Open(Packed)) return false;
+
+    OutHeader = Reader.GetHeader();
+    OutDurationSec = (float)Reader.GetDurationSec();
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::DecodePackedRange(const TArray<uint8>& Packed, float StartSec, float DurationSec, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels)
+{
+    OutPcm.Reset();
+    FPackedClipReader Reader;
+    if (!Reader.Open(Packed)) return false;
+
+    return DecodeReaderRange(Reader, StartSec, DurationSec, Rate, OutPcm, OutSampleRate, OutChannels);
+}
+
+bool UAudioReplicatorBPLibrary::SaveOpusClipFile(const FString& Path, const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header)
+{
+    return PackedClip::SaveToFile(Path, Header, FOpusPacketList::FromPackets(Packets));
+}
+
+bool UAudioReplicatorBPLibrary::GetPackedClipFileInfo(const FString& Path, FOpusStreamHeader& OutHeader, float& OutDurationSec)
+{
+    FMappedPackedClip Clip;
+    if (!Clip.Open(Path)) return false;
+
+    OutHeader = Clip.GetReader().GetHeader();
+    OutDurationSec = (float)Clip.GetReader().GetDurationSec();
+    return true;
+}
+
+bool UAudioReplicatorBPLibrary::DecodePackedFileRange(const FString& Path, float StartSec, float DurationSec, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels)
+{
+    OutPcm.Reset();
+    FMappedPackedClip Clip;
+    if (!Clip.Open(Path)) return false;
+
+    return DecodeReaderRange(Clip.GetReader(), StartSec, DurationSec, Rate, OutPcm, OutSampleRate, OutChannels);
+}
+
 bool UAudioReplicatorBPLibrary::SavePcm16ToWav(const FString& OutPath, const TArray<int32>& Pcm16, int32 SR, int32 Ch)
 {
     TArray<int16> Pcm16s; Int32ToInt16(Pcm16, Pcm16s);
     return PcmWav::SavePcm16ToWavFile(OutPath, Pcm16s, SR, Ch);
 }
 
-bool UAudioReplicatorBPLibrary::TranscodeWavToOpusAndBack(const FString& InWavPath, const FString& OutWavPath, int32 Bitrate, int32 FrameMs)
+bool UAudioReplicatorBPLibrary::TranscodeWavToOpusAndBack(const FString& InWavPath, const FString& OutWavPath, int32 Bitrate, float FrameMs)
 {
     int32 SR = 0, Ch = 0;
     TArray<int32> Pcm;
     if (!LoadWavToPcm16(InWavPath, Pcm, SR, Ch)) return false;
 
+    // Non-Opus rates are converted on the way in; the round-tripped WAV is written at the Opus rate.
+    if (!FOpusResampler::IsOpusRate(SR))
+    {
+        TArray<int16> Pcm16s; Int32ToInt16(Pcm, Pcm16s);
+        TArray<float> Resampled;
+        FOpusResampler Resampler;
+        const int32 OpusRate = FOpusResampler::GetOpusRateFor(SR);
+        if (!Resampler.Init(SR, OpusRate, Ch) || !Resampler.Process(Pcm16s, Resampled)) return false;
+
+        Pcm.SetNumUninitialized(Resampled.Num());
+        for (int32 i = 0; i < Resampled.Num(); ++i)
+        {
+            Pcm[i] = FMath::Clamp(FMath::RoundToInt(Resampled[i] * 32767.0f), -32768, 32767);
+        }
+        SR = OpusRate;
+    }
+
     TArray<FOpusPacket> Packets;
     if (!EncodePcm16ToOpusPackets(Pcm, SR, Ch, Bitrate, FrameMs, Packets)) return false;
 
@@ -131,7 +469,7 @@ static FString FmtF(double V, int32 Dec = 2) { return FString::Printf(TEXT("%.*f
 FString UAudioReplicatorBPLibrary::FormatAudioTestReport(
     int32 SampleRate,
     int32 Channels,
-    int32 FrameMs,
+    float FrameMs,
     int32 BitrateKbps,
     int32 PcmSamplesTotal,
     int32 DecPcmSamplesTotal,
@@ -141,10 +479,10 @@ FString UAudioReplicatorBPLibrary::FormatAudioTestReport(
     // Sanity checks and preparation
     const int32 Ch = FMath::Max(1, Channels);
     const int32 SR = FMath::Max(1, SampleRate);
-    const int32 FrmMs = FMath::Clamp(FrameMs, 2, 120); // typically 2.5/5/10/20/40/60
+    const float FrmMs = SnapOpusFrameMs(FrameMs); // 2.5/5/10/20/40/60/80/100/120
     const double Den = double(SR) * double(Ch);
 
-    const int32 FrameSampPerCh = (SR / 1000) * FrmMs;
+    const int32 FrameSampPerCh = GetOpusFrameSamples(SR, FrmMs);
     const int32 FrameSampTotal = FrameSampPerCh * Ch;
 
     // Durations
@@ -163,7 +501,7 @@ FString UAudioReplicatorBPLibrary::FormatAudioTestReport(
     // Packets
     const double AvgPktBytes = (PacketCount > 0) ? double(BufferBytes) / double(PacketCount) : 0.0;
     const double PktsPerSec = (DurInSec > 0.0) ? double(PacketCount) / DurInSec : 0.0;
-    const double ExpPktCount = (DurInSec > 0.0 && FrmMs > 0) ? DurInSec * (1000.0 / double(FrmMs)) : 0.0;
+    const double ExpPktCount = (DurInSec > 0.0) ? DurInSec * (1000.0 / double(FrmMs)) : 0.0;
     const double PktCountDiff = double(PacketCount) - ExpPktCount;
 
     // "Effective" average bitrate based on the resulting buffer
@@ -172,7 +510,7 @@ FString UAudioReplicatorBPLibrary::FormatAudioTestReport(
     // Summary
     FString Out;
     Out += TEXT("=== Audio Replicator · Local Test ===\n");
-    Out += FString::Printf(TEXT("SR=%d Hz  Ch=%d  Frame=%d ms  Target Bitrate≈%d bps\n"),
+    Out += FString::Printf(TEXT("SR=%d Hz  Ch=%d  Frame=%g ms  Target Bitrate≈%d bps\n"),
         SR, Ch, FrmMs, BitrateKbps);
     Out += FString::Printf(TEXT("PCM: Samples=%d  Bytes=%lld  Dur≈%s s\n"),
         PcmSamplesTotal, (long long)PcmBytes, *FmtF(DurInSec, 3));
@@ -204,12 +542,21 @@ FString UAudioReplicatorBPLibrary::FormatAudioTestReport(
 
 FString UAudioReplicatorBPLibrary::OpusStreamHeaderToString(const FOpusStreamHeader& Header)
 {
-    return FString::Printf(TEXT("Opus Header: SR=%d Hz  Ch=%d  Bitrate=%d bps  Frame=%d ms  Packets=%d"),
+    return FString::Printf(TEXT("Opus Header: SR=%d Hz  Ch=%d  Bitrate=%d bps  Frame=%g ms  Packets=%d  Frames/Packet=%d  Profile=%s%s%s%s"),
         Header.SampleRate,
         Header.Channels,
         Header.Bitrate,
         Header.FrameMs,
-        Header.NumPackets);
+        Header.NumPackets,
+        Header.FramesPerPacket,
+        *StaticEnum<EOpusEncoderProfile>()->GetNameStringByValue((int64)Header.Profile),
+        IsOpusMultistream(Header)
+            ? *FString::Printf(TEXT("  Streams=%d (%d coupled)%s"), Header.Streams, Header.CoupledStreams, IsOpusProjection(Header) ? TEXT(" ambisonics") : TEXT(""))
+            : TEXT(""),
+        (Header.StartupFrameMs > 0.0f && Header.StartupFrames > 0)
+            ? *FString::Printf(TEXT("  Startup=%d x %g ms"), Header.StartupFrames, Header.StartupFrameMs)
+            : TEXT(""),
+        IsOpusCustom(Header) ? TEXT("  Custom (low delay)") : TEXT(""));
 }
 
 static FString JoinIntArray(const TArray<int32>& Values)
@@ -0,0 +1,760 @@
+#include "AudioReplicatorBenchmarkLibrary.h"
+#include "OpusCodec.h"
+#include "OpusPacketList.h"
+#include "OpusParallelEncode.h"
+#include "OpusResampler.h"
+#include "OpusProjection.h"
+#include "OpusCustom.h"
+#include "OpusJitterBuffer.h"
+#include "Chunking.h"
+#include "PackedClip.h"
+#include "Crc32c.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    // Deterministic speech-like test signal: a few harmonics with slow vibrato plus a little noise.
+    void MakeTestSignal(int32 SampleRate, int32 Channels, float DurationSec, TArray<float>& Out)
+    {
+        const int32 Frames = FMath::Max(1, FMath::RoundToInt(DurationSec * SampleRate));
+        Out.SetNumUninitialized(Frames * Channels);
+
+        FRandomStream Rng(1234);
+        double Phase = 0.0;
+        for (int32 i = 0; i < Frames; ++i)
+        {
+            const double T = double(i) / SampleRate;
+            const double F0 = 180.0 + 40.0 * FMath::Sin(2.0 * PI * 0.7 * T);
+            Phase += 2.0 * PI * F0 / SampleRate;
+
+            const double Env = 0.5 + 0.5 * FMath::Sin(2.0 * PI * 2.0 * T);
+            const double V = Env * (0.5 * FMath::Sin(Phase) + 0.25 * FMath::Sin(2.0 * Phase) + 0.12 * FMath::Sin(3.0 * Phase))
+                + 0.02 * (Rng.FRand() * 2.0 - 1.0);
+
+            for (int32 c = 0; c < Channels; ++c)
+            {
+                Out[i * Channels + c] = (float)V;
+            }
+        }
+    }
+
+    // AmbiX (ACN/SN3D) scene: the test signal circling the listener on the horizon over a faint diffuse bed.
+    // Channels past the ambisonic ones (6 and 11) carry the dry source as a head-locked stereo pair.
+    void MakeAmbisonicSignal(int32 SampleRate, int32 Channels, float DurationSec, TArray<float>& Out)
+    {
+        TArray<float> Source;
+        MakeTestSignal(SampleRate, 1, DurationSec, Source);
+
+        const int32 AmbiChannels = (Channels >= 9) ? 9 : 4;
+        const int32 Frames = Source.Num();
+        Out.SetNumUninitialized(Frames * Channels);
+
+        FRandomStream Rng(4321);
+        const double Sqrt3Half = FMath::Sqrt(3.0) / 2.0;
+        for (int32 i = 0; i < Frames; ++i)
+        {
+            const double Az = 2.0 * PI * 0.25 * double(i) / SampleRate;
+            const double S = Source[i];
+            float* Frame = &Out[i * Channels];
+
+            // Elevation 0: Z, T and S vanish, R is constant.
+            Frame[0] = float(S);                          // W
+            Frame[1] = float(S * FMath::Sin(Az));         // Y
+            Frame[2] = 0.0f;                              // Z
+            Frame[3] = float(S * FMath::Cos(Az));         // X
+            if (AmbiChannels == 9)
+            {
+                Frame[4] = float(S * Sqrt3Half * FMath::Sin(2.0 * Az)); // V
+                Frame[5] = 0.0f;                                        // T
+                Frame[6] = float(S * -0.5);                             // R
+                Frame[7] = 0.0f;                                        // S
+                Frame[8] = float(S * Sqrt3Half * FMath::Cos(2.0 * Az)); // U
+            }
+            for (int32 c = 0; c < AmbiChannels; ++c)
+            {
+                Frame[c] += 0.01f * (Rng.FRand() * 2.0f - 1.0f);
+            }
+            for (int32 c = AmbiChannels; c < Channels; ++c)
+            {
+                Frame[c] = float(S);
+            }
+        }
+    }
+
+    // Run Body Iterations times and return the fastest wall-clock time in seconds.
+    template <typename FuncType>
+    double TimeBest(int32 Iterations, FuncType&& Body)
+    {
+        double Best = TNumericLimits<double>::Max();
+        for (int32 i = 0; i < FMath::Max(1, Iterations); ++i)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Body();
+            Best = FMath::Min(Best, FPlatformTime::Seconds() - Start);
+        }
+        return Best;
+    }
+
+    // Where one variant of BenchmarkLatency spends its delay, in milliseconds.
+    struct FLatencyBreakdown
+    {
+        bool bValid = false;
+        double LookaheadMs = 0.0;
+        double CodecMs = 0.0;  // 99th percentile of encode + decode for one frame
+        double BufferMs = 0.0; // mean audio waiting in the jitter buffer while playing
+        double TargetMs = 0.0;
+        int32 Underruns = 0;
+        int32 Concealed = 0;
+        double Kbps = 0.0;
+    };
+
+    // Encode and decode Source one frame at a time, then replay the packets through a jitter buffer over a link whose
+    // arrivals wobble by up to NetworkJitterMs (in order, no loss). Playout runs on an idealised 1 ms clock so the
+    // device buffer does not hide the codec's share.
+    FLatencyBreakdown MeasureLatency(const FOpusStreamHeader& Header, TConstArrayView<float> Source, int32 LookaheadSamples,
+        TFunctionRef<bool(TConstArrayView<float>, FOpusPacketList&)> EncodeFrame,
+        TFunctionRef<int32(FOpusPacketView, TArrayView<float>)> DecodeFrame,
+        float NetworkJitterMs, int32 MinBufferMs)
+    {
+        FLatencyBreakdown Result;
+        const int32 FrameSamples = GetOpusFrameSamples(Header.SampleRate, Header.FrameMs) * Header.Channels;
+        const int32 NumFrames = Source.Num() / FrameSamples;
+        if (NumFrames == 0)
+            return Result;
+
+        FOpusPacketList Packets;
+        TArray<float> Pcm;
+        Pcm.SetNumUninitialized(FrameSamples);
+        TArray<double> CodecSec;
+        CodecSec.Reserve(NumFrames);
+        for (int32 i = 0; i < NumFrames; ++i)
+        {
+            const double T0 = FPlatformTime::Seconds();
+            if (!EncodeFrame(Source.Slice(i * FrameSamples, FrameSamples), Packets) || DecodeFrame(Packets.GetPacket(i), Pcm) < 0)
+                return Result;
+            CodecSec.Add(FPlatformTime::Seconds() - T0);
+        }
+        CodecSec.Sort();
+        Result.CodecMs = CodecSec[FMath::Min(NumFrames - 1, FMath::FloorToInt32(0.99 * NumFrames))] * 1000.0;
+        Result.LookaheadMs = LookaheadSamples * 1000.0 / Header.SampleRate;
+
+        const double FrameSec = Header.FrameMs / 1000.0;
+        Result.Kbps = Packets.GetTotalBytes() * 8.0 / (NumFrames * FrameSec) / 1000.0;
+
+        FOpusJitterBufferSettings Settings;
+        Settings.MinDelayMs = MinBufferMs;
+        Settings.bUseFec = false;
+        FOpusJitterBuffer Jitter;
+        if (!Jitter.Init(Header.SampleRate, Header, Settings))
+            return Result;
+
+        // A packet leaves once its frame is captured and coded; RPCs are not reordered, so arrivals never go backwards.
+        FRandomStream Rng(777);
+        TArray<double> Arrival;
+        Arrival.Reserve(NumFrames);
+        for (int32 i = 0; i < NumFrames; ++i)
+        {
+            const double Sent = (i + 1) * FrameSec + Result.CodecMs / 1000.0;
+            Arrival.Add(FMath::Max(i > 0 ? Arrival[i - 1] : 0.0, Sent + Rng.FRand() * NetworkJitterMs / 1000.0));
+        }
+
+        constexpr double TickSec = 0.001;
+        double BufferedSum = 0.0;
+        int32 BufferedSamples = 0;
+        int32 Next = 0;
+        for (double Now = 0.0; !Jitter.IsDrained() && Now < Arrival.Last() + 1.0; Now += TickSec)
+        {
+            while (Next < NumFrames && Arrival[Next] <= Now)
+            {
+                Jitter.Push(Next, Packets.GetPacket(Next), 0, Now);
+                ++Next;
+            }
+            if (Next == NumFrames)
+            {
+                Jitter.MarkEnded();
+            }
+
+            Pcm.Reset();
+            Jitter.PopDue(Now, Pcm);
+
+            const FAudioReplicatorJitterStats Stats = Jitter.GetStats();
+            if (Stats.FramesPlayed > 0 && Next < NumFrames)
+            {
+                BufferedSum += Stats.CurrentDelayMs;
+                ++BufferedSamples;
+            }
+        }
+
+        const FAudioReplicatorJitterStats Stats = Jitter.GetStats();
+        Result.BufferMs = BufferedSamples > 0 ? BufferedSum / BufferedSamples : 0.0;
+        Result.TargetMs = Stats.TargetDelayMs;
+        Result.Underruns = Stats.Underruns;
+        Result.Concealed = Stats.ConcealedFrames;
+        Result.bValid = true;
+        return Result;
+    }
+
+    FString FmtMs(double Seconds) { return FString::Printf(TEXT("%.2f ms"), Seconds * 1000.0); }
+    FString FmtX(double AudioSec, double CpuSec) { return FString::Printf(TEXT("%.1fx"), CpuSec > 0.0 ? AudioSec / CpuSec : 0.0); }
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkFloatVsPcm16(int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, float DurationSec, int32 Iterations)
+{
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs);
+
+    FOpusEncoderState Encoder;
+    FOpusDecoderState Decoder;
+    if (FrameSize <= 0 || !Encoder.Init(SampleRate, Channels, Bitrate) || !Decoder.Init(SampleRate, Channels))
+    {
+        return FString::Printf(TEXT("BenchmarkFloatVsPcm16: unsupported format SR=%d Ch=%d Frame=%g ms"), SampleRate, Channels, FrameMs);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(SampleRate, Channels, DurationSec, Source);
+    const double AudioSec = double(Source.Num()) / (double(SampleRate) * Channels);
+
+    FOpusPacketList Packets;
+    TArray<FOpusPacketView> Views;
+    TArray<int16> Pcm16;
+    TArray<int16> Decoded16;
+    TArray<float> DecodedF;
+
+    // int16 path: mixer float -> int16 -> encode -> decode int16 -> float for playback.
+    double Enc16 = 0.0, Dec16 = 0.0;
+    const double Total16 = TimeBest(Iterations, [&]()
+    {
+        const double T0 = FPlatformTime::Seconds();
+        Pcm16.SetNumUninitialized(Source.Num());
+        for (int32 i = 0; i < Source.Num(); ++i)
+        {
+            Pcm16[i] = (int16)FMath::Clamp(FMath::RoundToInt(Source[i] * 32767.0f), -32768, 32767);
+        }
+        Encoder.Reset();
+        Encoder.EncodePcm16ToPacketList(Pcm16, FrameSize, Packets);
+        const double T1 = FPlatformTime::Seconds();
+
+        Packets.GetViews(Views);
+        Decoder.Reset();
+        Decoder.DecodePacketsToPcm16(Views, Decoded16);
+        DecodedF.SetNumUninitialized(Decoded16.Num());
+        for (int32 i = 0; i < Decoded16.Num(); ++i)
+        {
+            DecodedF[i] = Decoded16[i] * (1.0f / 32768.0f);
+        }
+        const double T2 = FPlatformTime::Seconds();
+
+        // Report the encode/decode split of the fastest run.
+        if (T2 - T0 < Enc16 + Dec16 || Enc16 + Dec16 == 0.0)
+        {
+            Enc16 = T1 - T0;
+            Dec16 = T2 - T1;
+        }
+    });
+    const int32 Bytes16 = Packets.GetTotalBytes();
+
+    // Float path: mixer float -> encode -> decode float, no conversions.
+    double EncF = 0.0, DecF = 0.0;
+    const double TotalF = TimeBest(Iterations, [&]()
+    {
+        const double T0 = FPlatformTime::Seconds();
+        Encoder.Reset();
+        Encoder.EncodeFloatToPacketList(Source, FrameSize, Packets);
+        const double T1 = FPlatformTime::Seconds();
+
+        Packets.GetViews(Views);
+        Decoder.Reset();
+        Decoder.DecodePacketsToFloat(Views, DecodedF);
+        const double T2 = FPlatformTime::Seconds();
+
+        // Report the encode/decode split of the fastest run.
+        if (T2 - T0 < EncF + DecF || EncF + DecF == 0.0)
+        {
+            EncF = T1 - T0;
+            DecF = T2 - T1;
+        }
+    });
+    const int32 BytesF = Packets.GetTotalBytes();
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Float vs PCM16 ===\n");
+    Out += FString::Printf(TEXT("SR=%d Hz  Ch=%d  Frame=%g ms  Bitrate=%d bps  Audio=%.2f s  Iterations=%d (best of)\n"),
+        SampleRate, Channels, FrameMs, Bitrate, AudioSec, FMath::Max(1, Iterations));
+    Out += FString::Printf(TEXT("PCM16: total=%s (enc=%s dec=%s)  realtime=%s  bytes=%d\n"),
+        *FmtMs(Total16), *FmtMs(Enc16), *FmtMs(Dec16), *FmtX(AudioSec, Total16), Bytes16);
+    Out += FString::Printf(TEXT("Float: total=%s (enc=%s dec=%s)  realtime=%s  bytes=%d\n"),
+        *FmtMs(TotalF), *FmtMs(EncF), *FmtMs(DecF), *FmtX(AudioSec, TotalF), BytesF);
+    Out += FString::Printf(TEXT("Speedup (PCM16/Float): %.2fx\n"), TotalF > 0.0 ? Total16 / TotalF : 0.0);
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkAmbisonics(int32 Channels, int32 Bitrate, int32 MonoBitrate, float FrameMs, float DurationSec, int32 Iterations)
+{
+    constexpr int32 SampleRate = 48000;
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs);
+
+    FOpusProjectionEncoder Projection;
+    if (FrameSize <= 0 || !Projection.Init(SampleRate, Channels, Bitrate))
+    {
+        return FString::Printf(TEXT("BenchmarkAmbisonics: unsupported format Ch=%d Frame=%g ms (use 4, 6, 9 or 11 channels)"), Channels, FrameMs);
+    }
+    FOpusStreamHeader Header;
+    Header.SampleRate = SampleRate;
+    Header.Channels = Channels;
+    Projection.WriteLayout(Header);
+
+    TArray<float> Source;
+    MakeAmbisonicSignal(SampleRate, Channels, DurationSec, Source);
+    const int32 Frames = Source.Num() / Channels;
+    const double AudioSec = double(Frames) / SampleRate;
+
+    FOpusProjectionDecoder ProjectionDecoder;
+    if (!ProjectionDecoder.InitFromHeader(Header, SampleRate))
+    {
+        return TEXT("BenchmarkAmbisonics: projection decoder init failed");
+    }
+
+    // Projection: one encoder for the whole scene. Codecs are created up front and only reset in the timed
+    // region, like the mono baseline below, so the CPU ratio compares coding work alone.
+    FOpusPacketList Packets;
+    TArray<FOpusPacketView> Views;
+    TArray<float> Decoded;
+    double ProjEnc = 0.0, ProjDec = 0.0;
+    TimeBest(Iterations, [&]()
+    {
+        const double T0 = FPlatformTime::Seconds();
+        Projection.Reset();
+        Projection.EncodeFloatToPacketList(Source, FrameSize, Packets);
+        const double T1 = FPlatformTime::Seconds();
+
+        Packets.GetViews(Views);
+        ProjectionDecoder.Reset();
+        ProjectionDecoder.DecodePacketsToFloat(Views, Decoded);
+        const double T2 = FPlatformTime::Seconds();
+
+        if (T2 - T0 < ProjEnc + ProjDec || ProjEnc + ProjDec == 0.0)
+        {
+            ProjEnc = T1 - T0;
+            ProjDec = T2 - T1;
+        }
+    });
+    const int32 ProjBytes = Packets.GetTotalBytes();
+    const int32 ProjStreams = Projection.GetStreams();
+    const int32 ProjCoupled = Projection.GetCoupledStreams();
+
+    // Baseline: every channel as an independent mono stream.
+    TArray<TArray<float>> Mono;
+    Mono.SetNum(Channels);
+    for (int32 c = 0; c < Channels; ++c)
+    {
+        Mono[c].SetNumUninitialized(Frames);
+        for (int32 i = 0; i < Frames; ++i)
+        {
+            Mono[c][i] = Source[i * Channels + c];
+        }
+    }
+
+    TArray<FOpusEncoderState> Encoders;
+    TArray<FOpusDecoderState> Decoders;
+    Encoders.SetNum(Channels);
+    Decoders.SetNum(Channels);
+    for (int32 c = 0; c < Channels; ++c)
+    {
+        if (!Encoders[c].Init(SampleRate, 1, MonoBitrate) || !Decoders[c].Init(SampleRate, 1))
+        {
+            return FString::Printf(TEXT("BenchmarkAmbisonics: mono codec init failed at %d bps"), MonoBitrate);
+        }
+    }
+
+    int32 MonoBytes = 0;
+    double MonoEnc = 0.0, MonoDec = 0.0;
+    TimeBest(Iterations, [&]()
+    {
+        double Enc = 0.0, Dec = 0.0;
+        int32 Bytes = 0;
+        for (int32 c = 0; c < Channels; ++c)
+        {
+            const double T0 = FPlatformTime::Seconds();
+            Encoders[c].Reset();
+            Encoders[c].EncodeFloatToPacketList(Mono[c], FrameSize, Packets);
+            const double T1 = FPlatformTime::Seconds();
+
+            Packets.GetViews(Views);
+            Decoders[c].Reset();
+            Decoders[c].DecodePacketsToFloat(Views, Decoded);
+            const double T2 = FPlatformTime::Seconds();
+
+            Enc += T1 - T0;
+            Dec += T2 - T1;
+            Bytes += Packets.GetTotalBytes();
+        }
+        if (Enc + Dec < MonoEnc + MonoDec || MonoEnc + MonoDec == 0.0)
+        {
+            MonoEnc = Enc;
+            MonoDec = Dec;
+        }
+        MonoBytes = Bytes;
+    });
+
+    auto Kbps = [AudioSec](int32 Bytes) { return AudioSec > 0.0 ? Bytes * 8.0 / AudioSec / 1000.0 : 0.0; };
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Ambisonics ===\n");
+    Out += FString::Printf(TEXT("SR=48000 Hz  Ch=%d  Frame=%g ms  Audio=%.2f s  Iterations=%d (best of, single core)\n"),
+        Channels, FrameMs, AudioSec, FMath::Max(1, Iterations));
+    Out += FString::Printf(TEXT("Projection (%d bps, %d streams / %d coupled): enc=%s dec=%s  realtime=%s  %.1f kbps\n"),
+        Bitrate, ProjStreams, ProjCoupled, *FmtMs(ProjEnc), *FmtMs(ProjDec), *FmtX(AudioSec, ProjEnc + ProjDec), Kbps(ProjBytes));
+    Out += FString::Printf(TEXT("%d x mono (%d bps each):              enc=%s dec=%s  realtime=%s  %.1f kbps\n"),
+        Channels, MonoBitrate, *FmtMs(MonoEnc), *FmtMs(MonoDec), *FmtX(AudioSec, MonoEnc + MonoDec), Kbps(MonoBytes));
+    Out += FString::Printf(TEXT("Bandwidth (mono/projection): %.2fx   CPU (mono/projection): %.2fx\n"),
+        ProjBytes > 0 ? double(MonoBytes) / ProjBytes : 0.0,
+        ProjEnc + ProjDec > 0.0 ? (MonoEnc + MonoDec) / (ProjEnc + ProjDec) : 0.0);
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkLatency(int32 Channels, int32 Bitrate, float StandardFrameMs, float CustomFrameMs, float NetworkJitterMs, int32 MinBufferMs, float DurationSec)
+{
+    constexpr int32 SampleRate = 48000;
+    if (Channels < 1 || Channels > 2 || !IsValidOpusFrameMs(StandardFrameMs) || !FOpusCustomEncoder::IsSupportedFormat(SampleRate, CustomFrameMs))
+    {
+        return FString::Printf(TEXT("BenchmarkLatency: unsupported format Ch=%d Standard=%g ms Custom=%g ms (custom frames are 2.5 or 5 ms)"),
+            Channels, StandardFrameMs, CustomFrameMs);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(SampleRate, Channels, DurationSec, Source);
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Latency ===\n");
+    Out += FString::Printf(TEXT("SR=48000 Hz  Ch=%d  Bitrate=%d bps  Audio=%.2f s  Link jitter=0..%g ms  Min buffer=%d ms (network base delay not included)\n"),
+        Channels, Bitrate, DurationSec, NetworkJitterMs, MinBufferMs);
+
+    auto AddRow = [&Out](const TCHAR* Name, float FrameMs, const FLatencyBreakdown& R)
+    {
+        if (!R.bValid)
+        {
+            Out += FString::Printf(TEXT("%-24s: measurement failed\n"), Name);
+            return;
+        }
+        Out += FString::Printf(TEXT("%-24s: frame=%.2f + lookahead=%.2f + codec(p99)=%.3f + buffer=%.2f (target %.1f) = %.2f ms  underruns=%d concealed=%d  %.1f kbps  %.0f pkt/s\n"),
+            Name, FrameMs, R.LookaheadMs, R.CodecMs, R.BufferMs, R.TargetMs, FrameMs + R.LookaheadMs + R.CodecMs + R.BufferMs,
+            R.Underruns, R.Concealed, R.Kbps, 1000.0 / FrameMs);
+    };
+
+    auto MakeHeader = [&](float FrameMs, EOpusEncoderProfile Profile, EOpusCodecMode Mode)
+    {
+        FOpusStreamHeader Header;
+        Header.SampleRate = SampleRate;
+        Header.Channels = Channels;
+        Header.Bitrate = Bitrate;
+        Header.FrameMs = FrameMs;
+        Header.Profile = Profile;
+        Header.CodecMode = Mode;
+        return Header;
+    };
+
+    struct FStandardVariant
+    {
+        const TCHAR* Name;
+        EOpusEncoderProfile Profile;
+        float FrameMs;
+    };
+    const FStandardVariant Standard[] = {
+        { TEXT("Standard (Default)"), EOpusEncoderProfile::Default, StandardFrameMs },
+        { TEXT("Standard (LowDelay)"), EOpusEncoderProfile::VoiceLowLatency, CustomFrameMs },
+    };
+    for (const FStandardVariant& Variant : Standard)
+    {
+        FOpusEncoderState Encoder;
+        FOpusDecoderState Decoder;
+        if (!Encoder.Init(SampleRate, Channels, Bitrate, Variant.Profile) || !Decoder.Init(SampleRate, Channels))
+        {
+            Out += FString::Printf(TEXT("%-24s: codec init failed\n"), Variant.Name);
+            continue;
+        }
+
+        const int32 FrameSize = GetOpusFrameSamples(SampleRate, Variant.FrameMs);
+        AddRow(Variant.Name, Variant.FrameMs, MeasureLatency(MakeHeader(Variant.FrameMs, Variant.Profile, EOpusCodecMode::Standard), Source, Encoder.GetLookaheadSamples(),
+            [&Encoder](TConstArrayView<float> Frame, FOpusPacketList& Packets) { return Encoder.EncodeFrame(Frame, Packets); },
+            [&Decoder, FrameSize](FOpusPacketView Packet, TArrayView<float> Pcm) { return Decoder.DecodeFrameToBuffer(Packet, FrameSize, false, Pcm); },
+            NetworkJitterMs, MinBufferMs));
+    }
+
+    const TCHAR* CustomName = TEXT("Custom (CELT only)");
+    const int32 CustomFrameSize = GetOpusFrameSamples(SampleRate, CustomFrameMs);
+    FOpusCustomEncoder CustomEncoder;
+    FOpusCustomDecoder CustomDecoder;
+    if (!FOpusCustomEncoder::IsAvailable())
+    {
+        Out += FString::Printf(TEXT("%-24s: unavailable (libopus built without custom modes)\n"), CustomName);
+    }
+    else if (!CustomEncoder.Init(SampleRate, Channels, Bitrate, CustomFrameSize, EOpusEncoderProfile::VoiceLowLatency)
+        || !CustomDecoder.Init(SampleRate, Channels, CustomFrameSize))
+    {
+        Out += FString::Printf(TEXT("%-24s: codec init failed\n"), CustomName);
+    }
+    else
+    {
+        AddRow(CustomName, CustomFrameMs, MeasureLatency(MakeHeader(CustomFrameMs, EOpusEncoderProfile::VoiceLowLatency, EOpusCodecMode::CustomLowDelay),
+            Source, FOpusCustomEncoder::GetLookaheadSamples(SampleRate),
+            [&CustomEncoder](TConstArrayView<float> Frame, FOpusPacketList& Packets) { return CustomEncoder.EncodeFrame(Frame, Packets); },
+            [&CustomDecoder](FOpusPacketView Packet, TArrayView<float> Pcm) { return CustomDecoder.DecodeFrameToBuffer(Packet, Pcm); },
+            NetworkJitterMs, MinBufferMs));
+    }
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkParallelEncode(int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, float DurationSec, int32 MaxSegments, int32 Iterations)
+{
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs);
+
+    FOpusEncoderState Encoder;
+    if (FrameSize <= 0 || !Encoder.Init(SampleRate, Channels, Bitrate))
+    {
+        return FString::Printf(TEXT("BenchmarkParallelEncode: unsupported format SR=%d Ch=%d Frame=%g ms"), SampleRate, Channels, FrameMs);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(SampleRate, Channels, DurationSec, Source);
+    const double AudioSec = double(Source.Num()) / (double(SampleRate) * Channels);
+
+    FOpusPacketList Serial;
+    const double SerialSec = TimeBest(Iterations, [&]()
+    {
+        Encoder.Reset();
+        Encoder.EncodeFloatToPacketList(Source, FrameSize, Serial);
+    });
+
+    FOpusParallelEncodeSettings Settings;
+    Settings.MaxSegments = MaxSegments;
+
+    // First run warms the codec pool so the timed runs measure encoding, not encoder creation.
+    FOpusPacketList Parallel;
+    OpusParallel::EncodeFloatToPacketList(Source, SampleRate, Channels, Bitrate, FrameSize, Parallel, Settings);
+    const double ParallelSec = TimeBest(Iterations, [&]()
+    {
+        OpusParallel::EncodeFloatToPacketList(Source, SampleRate, Channels, Bitrate, FrameSize, Parallel, Settings);
+    });
+
+    const int32 Workers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Parallel encode ===\n");
+    Out += FString::Printf(TEXT("SR=%d Hz  Ch=%d  Frame=%g ms  Bitrate=%d bps  Audio=%.2f s  Threads=%d  MaxSegments=%d  Iterations=%d (best of)\n"),
+        SampleRate, Channels, FrameMs, Bitrate, AudioSec, Workers, MaxSegments, FMath::Max(1, Iterations));
+    Out += FString::Printf(TEXT("Serial:   %s  realtime=%s  packets=%d  bytes=%d\n"),
+        *FmtMs(SerialSec), *FmtX(AudioSec, SerialSec), Serial.Num(), Serial.GetTotalBytes());
+    Out += FString::Printf(TEXT("Parallel: %s  realtime=%s  packets=%d  bytes=%d\n"),
+        *FmtMs(ParallelSec), *FmtX(AudioSec, ParallelSec), Parallel.Num(), Parallel.GetTotalBytes());
+    Out += FString::Printf(TEXT("Speedup (Serial/Parallel): %.2fx\n"), ParallelSec > 0.0 ? SerialSec / ParallelSec : 0.0);
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkResampler(int32 InSampleRate, int32 OutSampleRate, int32 Channels, int32 TapsPerPhase, float DurationSec, int32 Iterations)
+{
+    FOpusResampler Resampler;
+    if (!Resampler.Init(InSampleRate, OutSampleRate, Channels, TapsPerPhase))
+    {
+        return FString::Printf(TEXT("BenchmarkResampler: unsupported conversion %d -> %d Hz, %d ch"), InSampleRate, OutSampleRate, Channels);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(InSampleRate, Channels, DurationSec, Source);
+    const double AudioSec = double(Source.Num()) / (double(InSampleRate) * Channels);
+
+    TArray<float> Out;
+    Resampler.SetUseVectorKernel(true);
+    const double VectorSec = TimeBest(Iterations, [&]() { Resampler.Process(Source, Out); });
+    const int32 OutSamples = Out.Num();
+
+    Resampler.SetUseVectorKernel(false);
+    const double ScalarSec = TimeBest(Iterations, [&]() { Resampler.Process(Source, Out); });
+
+    auto FmtRate = [OutSamples](double Seconds)
+    {
+        return FString::Printf(TEXT("%.1f Msamples/s"), Seconds > 0.0 ? OutSamples / Seconds / 1.0e6 : 0.0);
+    };
+
+    FString Report;
+    Report += TEXT("=== Audio Replicator · Resampler ===\n");
+    Report += FString::Printf(TEXT("%d -> %d Hz  Ch=%d  Taps/phase=%d  Audio=%.2f s  Iterations=%d (best of, single core)\n"),
+        InSampleRate, OutSampleRate, Channels, Resampler.GetTapsPerPhase(), AudioSec, FMath::Max(1, Iterations));
+    Report += FString::Printf(TEXT("Vector: %s  %s  realtime=%s\n"), *FmtMs(VectorSec), *FmtRate(VectorSec), *FmtX(AudioSec, VectorSec));
+    Report += FString::Printf(TEXT("Scalar: %s  %s  realtime=%s\n"), *FmtMs(ScalarSec), *FmtRate(ScalarSec), *FmtX(AudioSec, ScalarSec));
+    Report += FString::Printf(TEXT("Speedup (Scalar/Vector): %.2fx\n"), VectorSec > 0.0 ? ScalarSec / VectorSec : 0.0);
+    return Report;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkDecodeRates(int32 Channels, int32 Bitrate, float FrameMs, float DurationSec, int32 Iterations)
+{
+    constexpr int32 StreamRate = 48000;
+    const int32 FrameSize = GetOpusFrameSamples(StreamRate, FrameMs);
+
+    FOpusEncoderState Encoder;
+    if (FrameSize <= 0 || !Encoder.Init(StreamRate, Channels, Bitrate))
+    {
+        return FString::Printf(TEXT("BenchmarkDecodeRates: unsupported format Ch=%d Frame=%g ms"), Channels, FrameMs);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(StreamRate, Channels, DurationSec, Source);
+    const double AudioSec = double(Source.Num()) / (double(StreamRate) * Channels);
+
+    FOpusPacketList Packets;
+    Encoder.EncodeFloatToPacketList(Source, FrameSize, Packets);
+    TArray<FOpusPacketView> Views;
+    Packets.GetViews(Views);
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Decode rates ===\n");
+    Out += FString::Printf(TEXT("Stream: 48000 Hz  Ch=%d  Frame=%g ms  Bitrate=%d bps  Audio=%.2f s  Iterations=%d (best of)\n"),
+        Channels, FrameMs, Bitrate, AudioSec, FMath::Max(1, Iterations));
+
+    const EOpusDecodeRate Rates[] = { EOpusDecodeRate::Native, EOpusDecodeRate::Hz24000, EOpusDecodeRate::Hz16000, EOpusDecodeRate::Hz12000, EOpusDecodeRate::Hz8000 };
+    double FullRateSec = 0.0;
+    TArray<int16> Pcm;
+    for (const EOpusDecodeRate Rate : Rates)
+    {
+        const int32 DecodeSR = GetOpusDecodeSampleRate(Rate, StreamRate);
+        FOpusDecoderState Decoder;
+        if (!Decoder.Init(DecodeSR, Channels))
+        {
+            continue;
+        }
+
+        const double Sec = TimeBest(Iterations, [&]()
+        {
+            Decoder.Reset();
+            Decoder.DecodePacketsToPcm16(Views, Pcm);
+        });
+        if (Rate == EOpusDecodeRate::Native)
+        {
+            FullRateSec = Sec;
+        }
+
+        const double Saved = (FullRateSec > 0.0) ? 100.0 * (1.0 - Sec / FullRateSec) : 0.0;
+        Out += FString::Printf(TEXT("%5d Hz: %s  realtime=%s  pcm=%d KB  cpu saved=%.0f%%\n"),
+            DecodeSR, *FmtMs(Sec), *FmtX(AudioSec, Sec), int32(Pcm.Num() * sizeof(int16) / 1024), Saved);
+    }
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkPackedClip(int32 Bitrate, float FrameMs, float DurationSec, int32 Iterations)
+{
+    constexpr int32 SampleRate = 48000;
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs);
+
+    FOpusEncoderState Encoder;
+    if (FrameSize <= 0 || !Encoder.Init(SampleRate, 1, Bitrate))
+    {
+        return FString::Printf(TEXT("BenchmarkPackedClip: unsupported format Frame=%g ms"), FrameMs);
+    }
+
+    TArray<float> Source;
+    MakeTestSignal(SampleRate, 1, DurationSec, Source);
+
+    FOpusPacketList Packets;
+    Encoder.EncodeFloatToPacketList(Source, FrameSize, Packets);
+
+    FOpusStreamHeader Header;
+    Header.SampleRate = SampleRate;
+    Header.Bitrate = Bitrate;
+    Header.FrameMs = FrameMs;
+    Header.NumPackets = Packets.Num();
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Packed clip ===\n");
+    Out += FString::Printf(TEXT("Clip: 48000 Hz mono  Frame=%g ms  Bitrate=%d bps  Packets=%d  Payload=%d KB  CRC32C=%s  Iterations=%d (best of)\n"),
+        FrameMs, Bitrate, Packets.Num(), Packets.GetTotalBytes() / 1024,
+        Crc32c::IsHardwareAccelerated() ? TEXT("hardware") : TEXT("table"), FMath::Max(1, Iterations));
+
+    TArray<FOpusPacketView> Views;
+    auto AddRow = [&](const TCHAR* Name, const TArray<uint8>& Buffer, double Sec, bool bOk)
+    {
+        const int32 Overhead = Buffer.Num() - Packets.GetTotalBytes();
+        Out += FString::Printf(TEXT("%-22s size=%d B  overhead=%d B (%.2f B/packet)  validate=%s  %.0f MB/s%s\n"),
+            Name, Buffer.Num(), Overhead, double(Overhead) / FMath::Max(1, Packets.Num()), *FmtMs(Sec),
+            Buffer.Num() / FMath::Max(Sec, 1e-9) / (1024.0 * 1024.0), bOk ? TEXT("") : TEXT("  FAILED"));
+    };
+
+    TArray<uint8> Legacy;
+    Chunking::PackWithLengths(Packets, Legacy);
+    bool bOk = true;
+    double Sec = TimeBest(Iterations, [&]() { bOk = Chunking::UnpackViews(Legacy, Views); });
+    AddRow(TEXT("Legacy (u16 lengths)"), Legacy, Sec, bOk);
+
+    for (const bool bChecksums : { false, true })
+    {
+        PackedClip::FPackOptions Options;
+        Options.bChecksums = bChecksums;
+        TArray<uint8> Container;
+        PackedClip::Pack(Header, Packets, Container, Options);
+
+        FOpusStreamHeader Parsed;
+        Sec = TimeBest(Iterations, [&]() { bOk = PackedClip::UnpackViews(Container, Parsed, Views) && Views.Num() == Packets.Num(); });
+        AddRow(bChecksums ? TEXT("Container + CRC32C") : TEXT("Container"), Container, Sec, bOk);
+    }
+    return Out;
+}
+
+FString UAudioReplicatorBenchmarkLibrary::BenchmarkEncoderProfiles(int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, float DurationSec, int32 Iterations)
+{
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs);
+    if (FrameSize <= 0 || FOpusEncoderState::GetStateSize(Channels) <= 0)
+    {
+        return FString::Printf(TEXT("BenchmarkEncoderProfiles: unsupported format SR=%d Ch=%d Frame=%g ms"), SampleRate, Channels, FrameMs);
+    }
+
+    // Voice chat is mostly silence: mute every other 1.5 s so DTX has something to skip.
+    TArray<float> Source;
+    MakeTestSignal(SampleRate, Channels, DurationSec, Source);
+    const int32 GapFrames = FMath::RoundToInt(1.5f * SampleRate);
+    for (int32 i = 0; i < Source.Num() / Channels; ++i)
+    {
+        if ((i / GapFrames) % 2 == 1)
+        {
+            FMemory::Memzero(&Source[i * Channels], Channels * sizeof(float));
+        }
+    }
+    const double AudioSec = double(Source.Num()) / (double(SampleRate) * Channels);
+
+    FString Out;
+    Out += TEXT("=== Audio Replicator · Encoder profiles ===\n");
+    Out += FString::Printf(TEXT("SR=%d Hz  Ch=%d  Frame=%g ms  Bitrate=%d bps  Audio=%.2f s (50%% silence)  Iterations=%d (best of, single core)\n"),
+        SampleRate, Channels, FrameMs, Bitrate, AudioSec, FMath::Max(1, Iterations));
+
+    const EOpusEncoderProfile Profiles[] = { EOpusEncoderProfile::Default, EOpusEncoderProfile::VoiceLowLatency, EOpusEncoderProfile::VoiceVoip,
+        EOpusEncoderProfile::MusicHighQuality, EOpusEncoderProfile::BulkCheap };
+
+    const UEnum* ProfileEnum = StaticEnum<EOpusEncoderProfile>();
+    double DefaultSec = 0.0;
+    FOpusPacketList Packets;
+    for (const EOpusEncoderProfile Profile : Profiles)
+    {
+        const FString Name = ProfileEnum->GetNameStringByValue((int64)Profile);
+
+        FOpusEncoderState Encoder;
+        if (!Encoder.Init(SampleRate, Channels, Bitrate, Profile))
+        {
+            Out += FString::Printf(TEXT("%-17s: encoder init failed\n"), *Name);
+            continue;
+        }
+
+        const double Sec = TimeBest(Iterations, [&]()
+        {
+            Encoder.Reset();
+            Encoder.EncodeFloatToPacketList(Source, FrameSize, Packets);
+        });
+        if (Profile == EOpusEncoderProfile::Default)
+        {
+            DefaultSec = Sec;
+        }
+
+        const FOpusEncoderProfileSettings Settings = FOpusEncoderProfileSettings::Get(Profile);
+        Out += FString::Printf(TEXT("%-17s: %s  realtime=%s  cpu vs default=%.2fx  bytes/s=%.0f  (complexity=%d dtx=%d)\n"),
+            *Name, *FmtMs(Sec), *FmtX(AudioSec, Sec), DefaultSec > 0.0 ? Sec / DefaultSec : 0.0,
+            AudioSec > 0.0 ? Packets.GetTotalBytes() / AudioSec : 0.0, Settings.Complexity, Settings.bDtx ? 1 : 0);
+    }
+    return Out;
+}
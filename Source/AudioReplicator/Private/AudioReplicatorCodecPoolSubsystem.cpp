@@ -0,0 +1,362 @@
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "Engine/Engine.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    // Per-type construction used when the pool has no idle instance for a key.
+    TUniquePtr<FOpusCodec> CreatePooled(const FOpusCodecKey& Key, const FOpusCodec*)
+    {
+        return (Key.Profile == EOpusEncoderProfile::Default)
+            ? FOpusCodec::Create(Key.SampleRate, Key.Channels, Key.Bitrate, Key.Application)
+            : FOpusCodec::Create(Key.SampleRate, Key.Channels, Key.Bitrate, Key.Profile);
+    }
+
+    TUniquePtr<FOpusEncoderState> CreatePooled(const FOpusCodecKey& Key, const FOpusEncoderState*)
+    {
+        TUniquePtr<FOpusEncoderState> Encoder = MakeUnique<FOpusEncoderState>();
+        const bool bOk = (Key.Profile == EOpusEncoderProfile::Default)
+            ? Encoder->Init(Key.SampleRate, Key.Channels, Key.Bitrate, Key.Application)
+            : Encoder->Init(Key.SampleRate, Key.Channels, Key.Bitrate, Key.Profile);
+        if (!bOk)
+        {
+            return nullptr;
+        }
+        return Encoder;
+    }
+
+    TUniquePtr<FOpusDecoderState> CreatePooled(const FOpusCodecKey& Key, const FOpusDecoderState*)
+    {
+        TUniquePtr<FOpusDecoderState> Decoder = MakeUnique<FOpusDecoderState>();
+        if (!Decoder->Init(Key.SampleRate, Key.Channels))
+        {
+            return nullptr;
+        }
+        return Decoder;
+    }
+
+    FOpusCodecKey MakeKey(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application)
+    {
+        FOpusCodecKey Key;
+        Key.SampleRate = SampleRate;
+        Key.Channels = Channels;
+        Key.Bitrate = Bitrate;
+        Key.Application = Application;
+        return Key;
+    }
+
+    // Profiles pick their own application, so the key records the profile's.
+    FOpusCodecKey MakeKey(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile)
+    {
+        FOpusCodecKey Key = MakeKey(SampleRate, Channels, Bitrate, FOpusEncoderProfileSettings::Get(Profile).Application);
+        Key.Profile = Profile;
+        return Key;
+    }
+
+    // Reset before publishing so the next borrower never sees history from this stream. A borrower may
+    // have retargeted the bitrate (live rate control); put the key's value back as well.
+    bool ResetForPool(FOpusEncoderState& Encoder, const FOpusCodecKey& Key)
+    {
+        return Encoder.Reset() && (Encoder.GetBitrate() == Key.Bitrate || Encoder.SetBitrate(Key.Bitrate));
+    }
+
+    bool ResetForPool(FOpusCodec& Codec, const FOpusCodecKey& Key)
+    {
+        return Codec.Reset() && ResetForPool(Codec.GetEncoder(), Key);
+    }
+
+    bool ResetForPool(FOpusDecoderState& Decoder, const FOpusCodecKey&)
+    {
+        return Decoder.Reset();
+    }
+
+    // Decoders are interchangeable across bitrates/applications, so they share one key per format.
+    FOpusCodecKey MakeDecoderKey(int32 SampleRate, int32 Channels)
+    {
+        return MakeKey(SampleRate, Channels, 0, EOpusApplication::Audio);
+    }
+}
+
+FOpusCodecPool::FOpusCodecPool(int32 InMaxPooledPerKey)
+    : MaxPooledPerKey(FMath::Max(0, InMaxPooledPerKey))
+{
+}
+
+template <typename CodecType>
+TOpusLease<CodecType> FOpusCodecPool::AcquireImpl(TIdleMap<CodecType>& Idle, const FOpusCodecKey& Key)
+{
+    TOpusLease<CodecType> Lease;
+    Lease.Key = Key;
+
+    {
+        FScopeLock Lock(&Mutex);
+        if (TArray<TUniquePtr<CodecType>>* List = Idle.Find(Key))
+        {
+            if (List->Num() > 0)
+            {
+                Lease.Codec = List->Pop(EAllowShrinking::No);
+                --IdleCount;
+                ++Hits;
+            }
+        }
+        if (!Lease.Codec.IsValid())
+        {
+            ++Misses;
+        }
+    }
+
+    // Creation happens outside the lock: opus state init is the expensive part we want to keep parallel.
+    if (!Lease.Codec.IsValid())
+    {
+        Lease.Codec = CreatePooled(Key, static_cast<const CodecType*>(nullptr));
+        if (!Lease.Codec.IsValid())
+        {
+            return TOpusLease<CodecType>();
+        }
+    }
+
+    {
+        FScopeLock Lock(&Mutex);
+        ++LeasedCount;
+    }
+
+    Lease.Pool = AsShared();
+    return Lease;
+}
+
+template <typename CodecType>
+void FOpusCodecPool::ReturnImpl(TIdleMap<CodecType>& Idle, const FOpusCodecKey& Key, TUniquePtr<CodecType> Codec)
+{
+    const bool bResetOk = Codec.IsValid() && ResetForPool(*Codec, Key);
+
+    FScopeLock Lock(&Mutex);
+    LeasedCount = FMath::Max(0, LeasedCount - 1);
+
+    if (!bResetOk)
+    {
+        ++Discards;
+        return;
+    }
+
+    TArray<TUniquePtr<CodecType>>& List = Idle.FindOrAdd(Key);
+    if (List.Num() >= MaxPooledPerKey)
+    {
+        ++Discards;
+        return; // Codec is destroyed when it goes out of scope.
+    }
+
+    List.Add(MoveTemp(Codec));
+    ++IdleCount;
+}
+
+template <typename CodecType>
+void FOpusCodecPool::TrimToCap(TIdleMap<CodecType>& Idle)
+{
+    for (auto& KV : Idle)
+    {
+        while (KV.Value.Num() > MaxPooledPerKey)
+        {
+            KV.Value.Pop(EAllowShrinking::No);
+            --IdleCount;
+            ++Discards;
+        }
+    }
+}
+
+FOpusCodecLease FOpusCodecPool::Acquire(const FOpusCodecKey& Key)
+{
+    return AcquireImpl(IdleCodecs, Key);
+}
+
+FOpusEncoderLease FOpusCodecPool::AcquireEncoder(const FOpusCodecKey& Key)
+{
+    return AcquireImpl(IdleEncoders, Key);
+}
+
+FOpusDecoderLease FOpusCodecPool::AcquireDecoder(int32 SampleRate, int32 Channels)
+{
+    return AcquireImpl(IdleDecoders, MakeDecoderKey(SampleRate, Channels));
+}
+
+void FOpusCodecPool::Return(const FOpusCodecKey& Key, TUniquePtr<FOpusCodec> Codec)
+{
+    ReturnImpl(IdleCodecs, Key, MoveTemp(Codec));
+}
+
+void FOpusCodecPool::Return(const FOpusCodecKey& Key, TUniquePtr<FOpusEncoderState> Encoder)
+{
+    ReturnImpl(IdleEncoders, Key, MoveTemp(Encoder));
+}
+
+void FOpusCodecPool::Return(const FOpusCodecKey& Key, TUniquePtr<FOpusDecoderState> Decoder)
+{
+    ReturnImpl(IdleDecoders, Key, MoveTemp(Decoder));
+}
+
+void FOpusCodecPool::SetMaxPooledPerKey(int32 InMaxPooledPerKey)
+{
+    FScopeLock Lock(&Mutex);
+    MaxPooledPerKey = FMath::Max(0, InMaxPooledPerKey);
+
+    TrimToCap(IdleCodecs);
+    TrimToCap(IdleEncoders);
+    TrimToCap(IdleDecoders);
+}
+
+int32 FOpusCodecPool::GetMaxPooledPerKey() const
+{
+    FScopeLock Lock(&Mutex);
+    return MaxPooledPerKey;
+}
+
+void FOpusCodecPool::Trim()
+{
+    FScopeLock Lock(&Mutex);
+    IdleCodecs.Empty();
+    IdleEncoders.Empty();
+    IdleDecoders.Empty();
+    IdleCount = 0;
+}
+
+FAudioReplicatorCodecPoolStats FOpusCodecPool::GetStats() const
+{
+    FScopeLock Lock(&Mutex);
+
+    FAudioReplicatorCodecPoolStats Stats;
+    Stats.Hits = Hits;
+    Stats.Misses = Misses;
+    Stats.Discards = Discards;
+    Stats.IdleCodecs = IdleCount;
+    Stats.LeasedCodecs = LeasedCount;
+
+    auto CountKeys = [&Stats](const auto& Idle)
+    {
+        for (const auto& KV : Idle)
+        {
+            if (KV.Value.Num() > 0)
+            {
+                ++Stats.PooledKeys;
+            }
+        }
+    };
+    CountKeys(IdleCodecs);
+    CountKeys(IdleEncoders);
+    CountKeys(IdleDecoders);
+
+    const int64 Total = Hits + Misses;
+    Stats.HitRate = (Total > 0) ? float(double(Hits) / double(Total)) : 0.0f;
+    return Stats;
+}
+
+void FOpusCodecPool::ResetStats()
+{
+    FScopeLock Lock(&Mutex);
+    Hits = 0;
+    Misses = 0;
+    Discards = 0;
+}
+
+// ================= SUBSYSTEM =================
+
+void UAudioReplicatorCodecPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    Pool = MakeShared<FOpusCodecPool, ESPMode::ThreadSafe>();
+}
+
+void UAudioReplicatorCodecPoolSubsystem::Deinitialize()
+{
+    // Outstanding leases only hold weak references; they destroy their codec on release.
+    Pool.Reset();
+    Super::Deinitialize();
+}
+
+TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> UAudioReplicatorCodecPoolSubsystem::GetPool()
+{
+    if (GEngine)
+    {
+        if (UAudioReplicatorCodecPoolSubsystem* Subsystem = GEngine->GetEngineSubsystem<UAudioReplicatorCodecPoolSubsystem>())
+        {
+            return Subsystem->Pool;
+        }
+    }
+    return nullptr;
+}
+
+FOpusCodecLease UAudioReplicatorCodecPoolSubsystem::AcquireCodec(const FOpusCodecKey& Key)
+{
+    if (TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> SharedPool = GetPool())
+    {
+        return SharedPool->Acquire(Key);
+    }
+
+    // No engine pool yet: hand out a one-shot pool so the lease API stays uniform.
+    return MakeShared<FOpusCodecPool, ESPMode::ThreadSafe>(0)->Acquire(Key);
+}
+
+FOpusCodecLease UAudioReplicatorCodecPoolSubsystem::AcquireCodec(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application)
+{
+    return AcquireCodec(MakeKey(SampleRate, Channels, Bitrate, Application));
+}
+
+FOpusCodecLease UAudioReplicatorCodecPoolSubsystem::AcquireCodec(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile)
+{
+    return AcquireCodec(MakeKey(SampleRate, Channels, Bitrate, Profile));
+}
+
+FOpusEncoderLease UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(const FOpusCodecKey& Key)
+{
+    if (TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> SharedPool = GetPool())
+    {
+        return SharedPool->AcquireEncoder(Key);
+    }
+    return MakeShared<FOpusCodecPool, ESPMode::ThreadSafe>(0)->AcquireEncoder(Key);
+}
+
+FOpusEncoderLease UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application)
+{
+    return AcquireEncoder(MakeKey(SampleRate, Channels, Bitrate, Application));
+}
+
+FOpusEncoderLease UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile)
+{
+    return AcquireEncoder(MakeKey(SampleRate, Channels, Bitrate, Profile));
+}
+
+FOpusDecoderLease UAudioReplicatorCodecPoolSubsystem::AcquireDecoder(int32 SampleRate, int32 Channels)
+{
+    if (TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> SharedPool = GetPool())
+    {
+        return SharedPool->AcquireDecoder(SampleRate, Channels);
+    }
+    return MakeShared<FOpusCodecPool, ESPMode::ThreadSafe>(0)->AcquireDecoder(SampleRate, Channels);
+}
+
+void UAudioReplicatorCodecPoolSubsystem::SetMaxPooledPerKey(int32 InMaxPooledPerKey)
+{
+    if (Pool.IsValid())
+    {
+        Pool->SetMaxPooledPerKey(InMaxPooledPerKey);
+    }
+}
+
+void UAudioReplicatorCodecPoolSubsystem::TrimPool()
+{
+    if (Pool.IsValid())
+    {
+        Pool->Trim();
+    }
+}
+
+FAudioReplicatorCodecPoolStats UAudioReplicatorCodecPoolSubsystem::GetPoolStats() const
+{
+    return Pool.IsValid() ? Pool->GetStats() : FAudioReplicatorCodecPoolStats();
+}
+
+void UAudioReplicatorCodecPoolSubsystem::ResetPoolStats()
+{
+    if (Pool.IsValid())
+    {
+        Pool->ResetStats();
+    }
+}
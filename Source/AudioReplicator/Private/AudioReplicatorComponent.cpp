@@ -2,8 +2,167 @@
 #include "Net/UnrealNetwork.h"
 #include "GameFramework/PlayerController.h"
 #include "AudioReplicatorBPLibrary.h" // leverage local blueprint helpers for encoding/decoding
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "PcmWavUtils.h"
+#include "PackedClip.h"
+#include "OggOpusUtils.h"
+#include "OpusStreamEncoder.h"
+#include "OpusParallelEncode.h"
+#include "OpusRepacketizer.h"
+#include "OpusResampler.h"
+#include "OpusJitterBuffer.h"
+#include "OpusRateController.h"
+#include "OpusMultistream.h"
+#include "OpusProjection.h"
+#include "OpusCustom.h"
+#include "Engine/NetConnection.h"
+#include "HAL/PlatformTime.h"
 #include "AudioReplicatorRegistrySubsystem.h"
 
+namespace
+{
+    // opus_encode returns 2 bytes or less for frames that need not be transmitted (DTX silence).
+    constexpr int32 MaxDtxPacketBytes = 2;
+
+    // Relay bundles stay well under the RPC size budget even with full-rate stereo packets.
+    constexpr int32 MaxStreamsPerRelayBundle = 32;
+
+    // Live sessions have no length to check peer-supplied indices against: a chunk may land at most this far past
+    // the highest slot received so far, so one malformed chunk cannot make every receiver allocate gigabytes.
+    constexpr float MaxLiveLeadSec = 5.0f;
+
+    int32 GetMaxLiveLeadSlots(const FOpusStreamHeader& Header)
+    {
+        const float PacketMs = FMath::Max(Header.FrameMs * FMath::Max(1, Header.FramesPerPacket), 2.5f);
+        return FMath::CeilToInt(MaxLiveLeadSec * 1000.0f / PacketMs);
+    }
+
+    // How long an end marker waits for chunks still in flight before the missing ones are given up as lost.
+    constexpr double MaxEndMarkerWaitSec = 2.0;
+
+    // Custom-mode streams have no DTX; their tiniest CBR frames are real audio.
+    bool IsDtxPacket(const FOpusStreamHeader& Header, int32 NumBytes)
+    {
+        return NumBytes <= MaxDtxPacketBytes && !IsOpusCustom(Header);
+    }
+
+    // Clip encode shared by the WAV and float broadcast paths: one pooled encoder, or segments across workers.
+    // More than two channels go through a multistream encoder, whose layout is written to Header; a header that
+    // asks for mapping family 3 gets the ambisonics projection encoder instead of the surround one.
+    template <typename SampleType>
+    bool EncodeMultichannel(TConstArrayView<SampleType> Pcm, FOpusStreamHeader& Header, int32 FrameSize, FOpusPacketList& OutPackets)
+    {
+        if (Header.MappingFamily == 3)
+        {
+            FOpusProjectionEncoder Encoder;
+            if (!Encoder.Init(Header.SampleRate, Header.Channels, Header.Bitrate, Header.Profile))
+                return false;
+            Encoder.WriteLayout(Header);
+
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                return Encoder.EncodeFloatToPacketList(Pcm, FrameSize, OutPackets);
+            }
+            else
+            {
+                return Encoder.EncodePcm16ToPacketList(Pcm, FrameSize, OutPackets);
+            }
+        }
+
+        FOpusMultistreamEncoder Encoder;
+        if (!Encoder.Init(Header.SampleRate, Header.Channels, Header.Bitrate, Header.Profile))
+            return false;
+        Encoder.WriteLayout(Header);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            return Encoder.EncodeFloatToPacketList(Pcm, FrameSize, OutPackets);
+        }
+        else
+        {
+            return Encoder.EncodePcm16ToPacketList(Pcm, FrameSize, OutPackets);
+        }
+    }
+
+    template <typename SampleType>
+    bool EncodeClip(TConstArrayView<SampleType> Pcm, FOpusStreamHeader& Header, bool bParallel, FOpusPacketList& OutPackets)
+    {
+        if (!IsValidOpusFrameMs(Header.FrameMs))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("EncodeClip: %g ms is not an Opus frame duration"), Header.FrameMs);
+            return false;
+        }
+
+        const int32 FrameSize = GetOpusFrameSamples(Header.SampleRate, Header.FrameMs); // per channel
+        if (Header.Channels > 2)
+        {
+            return EncodeMultichannel(Pcm, Header, FrameSize, OutPackets);
+        }
+
+        if (bParallel)
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                return OpusParallel::EncodeFloatToPacketList(Pcm, Header.SampleRate, Header.Channels, Header.Bitrate, FrameSize, OutPackets, FOpusParallelEncodeSettings(), Header.Profile);
+            }
+            else
+            {
+                return OpusParallel::EncodePcm16ToPacketList(Pcm, Header.SampleRate, Header.Channels, Header.Bitrate, FrameSize, OutPackets, FOpusParallelEncodeSettings(), Header.Profile);
+            }
+        }
+
+        FOpusEncoderLease Encoder = UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(Header.SampleRate, Header.Channels, Header.Bitrate, Header.Profile);
+        if (!Encoder)
+            return false;
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            return Encoder->EncodeFloatToPacketList(Pcm, FrameSize, OutPackets);
+        }
+        else
+        {
+            return Encoder->EncodePcm16ToPacketList(Pcm, FrameSize, OutPackets);
+        }
+    }
+
+    // Copy the packets of [StartSec, StartSec + DurationSec) out of Reader, with the header adjusted to the range.
+    bool CopyPackedRange(const FPackedClipReader& Reader, float StartSec, float DurationSec, FOpusPacketList& OutPackets, FOpusStreamHeader& OutHeader)
+    {
+        const int32 StreamRate = Reader.GetHeader().SampleRate;
+        const int64 PlayEnd = Reader.GetPlayEndSample();
+        const int64 StartSample = FMath::Min(Reader.GetPlayStartSample() + FMath::RoundToInt64(double(FMath::Max(StartSec, 0.0f)) * StreamRate), PlayEnd);
+        const int64 EndSample = FMath::Min(StartSample + FMath::RoundToInt64(double(FMath::Max(DurationSec, 0.0f)) * StreamRate), PlayEnd);
+
+        TArray<FOpusPacketView> Views;
+        int32 FirstPacket = 0;
+        int64 FirstSample = 0;
+        if (!Reader.ReadRange(StartSample, EndSample, Views, FirstPacket, FirstSample))
+            return false;
+
+        int32 RangeBytes = 0;
+        int64 RangeEndSample = FirstSample;
+        for (int32 i = 0; i < Views.Num(); ++i)
+        {
+            RangeBytes += Views[i].Num();
+            RangeEndSample += Reader.GetPacketSampleCount(FirstPacket + i, Views[i]);
+        }
+
+        OutPackets.Reset();
+        OutPackets.Reserve(Views.Num(), RangeBytes);
+        for (const FOpusPacketView& View : Views)
+        {
+            OutPackets.Add(View);
+        }
+
+        OutHeader = Reader.GetHeader();
+        OutHeader.StartupFrames = FMath::Max(0, OutHeader.StartupFrames - FirstPacket);
+        // Receivers trim the lead-in before StartSample and the overshoot of the last packet past EndSample.
+        OutHeader.PreSkip = (int32)((StartSample - FirstSample) * 48000 / FMath::Max(1, StreamRate));
+        OutHeader.EndTrim = (int32)(FMath::Max<int64>(0, RangeEndSample - EndSample) * 48000 / FMath::Max(1, StreamRate));
+        return true;
+    }
+}
+
 UAudioReplicatorComponent::UAudioReplicatorComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
@@ -62,39 +221,94 @@ bool UAudioReplicatorComponent::IsOwnerClient() const
     return false;
 }
 
-void UAudioReplicatorComponent::BuildChunks(const TArray<FOpusPacket>& Packets, TArray<FOpusChunk>& OutChunks)
+void UAudioReplicatorComponent::BuildChunk(const FOpusPacketList& Packets, int32 Index, FOpusChunk& OutChunk)
+{
+    const FOpusPacketView Payload = Packets.GetPacket(Index);
+    OutChunk.Index = Index;
+    OutChunk.Packet.Data.Reset(Payload.Num());
+    OutChunk.Packet.Data.Append(Payload.GetData(), Payload.Num());
+}
+
+void UAudioReplicatorComponent::MarkElided(FIncomingTransfer& In, int32 First, int32 Count)
+{
+    if (Count <= 0 || First < 0)
+        return;
+
+    if (In.ElidedSlots.Num() < First + Count)
+        In.ElidedSlots.Add(false, First + Count - In.ElidedSlots.Num());
+    In.ElidedSlots.SetRange(First, Count, true);
+    In.ElidedFrames += Count;
+}
+
+bool UAudioReplicatorComponent::MakeOutgoingSessionId(const FGuid& SessionId, const TCHAR* Context, FGuid& OutSessionId) const
 {
-    OutChunks.Reset(Packets.Num());
-    int32 idx = 0;
-    for (const FOpusPacket& P : Packets)
+    if (!SessionId.IsValid())
     {
-        FOpusChunk C;
-        C.Index = idx++;
-        C.Packet = P;
-        OutChunks.Add(MoveTemp(C));
+        OutSessionId = FGuid::NewGuid();
+        while (Outgoing.Contains(OutSessionId))
+        {
+            OutSessionId = FGuid::NewGuid();
+        }
+        return true;
+    }
+
+    if (Outgoing.Contains(SessionId))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: session %s is already active"), Context, *SessionId.ToString());
+        return false;
     }
+
+    OutSessionId = SessionId;
+    return true;
 }
 
-bool UAudioReplicatorComponent::EncodeWavToOpusPackets(const FString& WavPath, int32 Bitrate, int32 FrameMs, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader) const
+bool UAudioReplicatorComponent::EncodeWavToOpusPackets(const FString& WavPath, int32 Bitrate, float FrameMs, FOpusPacketList& OutPackets, FOpusStreamHeader& OutHeader) const
 {
-    int32 SR = 0, Ch = 0;
-    TArray<int32> Pcm;
-    if (!UAudioReplicatorBPLibrary::LoadWavToPcm16(WavPath, Pcm, SR, Ch))
+    // Stay in int16 end to end: the blueprint helpers round-trip through int32 arrays. The samples are encoded
+    // straight out of the file mapping, so the WAV is never copied.
+    PcmWav::FWavFileView Wav;
+    if (!Wav.Open(WavPath, /*bAllowFloat=*/false, TEXT("EncodeWavToOpusPackets")))
         return false;
+    const TConstArrayView<int16> Pcm = Wav.GetPcm16();
+    const int32 SR = Wav.GetSampleRate();
+    const int32 Ch = Wav.GetChannels();
 
     OutHeader.SampleRate = SR;
     OutHeader.Channels = Ch;
     OutHeader.Bitrate = Bitrate;
     OutHeader.FrameMs = FrameMs;
+    OutHeader.Profile = EncoderProfile;
+    OutHeader.MappingFamily = bAmbisonicInput ? 3 : 0;
 
-    if (!UAudioReplicatorBPLibrary::EncodePcm16ToOpusPackets(Pcm, SR, Ch, Bitrate, FrameMs, OutPackets))
-        return false;
+    bool bEncoded = false;
+    if (FOpusResampler::IsOpusRate(SR))
+    {
+        bEncoded = EncodeClip<int16>(Pcm, OutHeader, bParallelEncode, OutPackets);
+    }
+    else
+    {
+        // 44.1/22.05 kHz assets: resample to the next Opus rate and encode the float result directly.
+        FOpusResampler Resampler;
+        TArray<float> Resampled;
+        const int32 OpusRate = FOpusResampler::GetOpusRateFor(SR);
+        if (!Resampler.Init(SR, OpusRate, Ch) || !Resampler.Process(Pcm, Resampled))
+            return false;
+
+        OutHeader.SampleRate = OpusRate;
+        OutHeader.SourceSampleRate = SR;
+        bEncoded = EncodeClip<float>(Resampled, OutHeader, bParallelEncode, OutPackets);
+    }
 
     OutHeader.NumPackets = OutPackets.Num();
-    return true;
+    return bEncoded;
 }
 
 bool UAudioReplicatorComponent::StartBroadcastOpus(const TArray<FOpusPacket>& Packets, FOpusStreamHeader Header, FGuid SessionId, FGuid& OutSessionId)
+{
+    return StartBroadcastPacketList(FOpusPacketList::FromPackets(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastPacketList(FOpusPacketList Packets, FOpusStreamHeader Header, FGuid SessionId, FGuid& OutSessionId)
 {
     if (!IsOwnerClient())
     {
@@ -107,45 +321,324 @@ bool UAudioReplicatorComponent::StartBroadcastOpus(const TArray<FOpusPacket>& Pa
         return false;
     }
 
-    FGuid EffectiveSessionId = SessionId;
-    if (!EffectiveSessionId.IsValid())
+    FGuid EffectiveSessionId;
+    if (!MakeOutgoingSessionId(SessionId, TEXT("StartBroadcastOpus"), EffectiveSessionId))
+        return false;
+
+    FOutgoingTransfer Tr;
+    Tr.SessionId = EffectiveSessionId;
+    Tr.Header = Header;
+    Tr.Header.FramesPerPacket = FMath::Max(1, Header.FramesPerPacket);
+
+    // Merge frames into multi-frame packets so the same audio travels in fewer chunks.
+    const int32 GroupSize = FMath::Min(FramesPerChunk, FOpusRepacketizer::GetMaxPacketsPerGroup(Header.FrameMs));
+    // The repacketizer only understands single-stream packets with a TOC byte (not custom mode).
+    if (GroupSize > 1 && Tr.Header.FramesPerPacket == 1 && !IsOpusMultistream(Tr.Header) && !IsOpusCustom(Tr.Header))
     {
-        EffectiveSessionId = FGuid::NewGuid();
-        while (Outgoing.Contains(EffectiveSessionId))
+        // Blank DTX frames first: the repacketizer keeps empty packets as their own slot, so they can still be
+        // elided one frame at a time instead of hiding inside a bundle.
+        if (bElideSilentFrames)
+        {
+            FOpusPacketList Blanked;
+            Blanked.Reserve(Packets.Num(), Packets.GetTotalBytes());
+            for (int32 i = 0; i < Packets.Num(); ++i)
+            {
+                const FOpusPacketView Packet = Packets.GetPacket(i);
+                Blanked.Add(IsDtxPacket(Tr.Header, Packet.Num()) ? FOpusPacketView() : Packet);
+            }
+            Packets = MoveTemp(Blanked);
+        }
+
+        FOpusRepacketizer Repacketizer;
+        if (!Repacketizer.Merge(Packets, GroupSize, Tr.Packets))
         {
-            EffectiveSessionId = FGuid::NewGuid();
+            UE_LOG(LogTemp, Warning, TEXT("StartBroadcastOpus: failed to bundle packets"));
+            return false;
         }
+        Tr.Header.FramesPerPacket = GroupSize;
     }
-    else if (Outgoing.Contains(EffectiveSessionId))
+    else
     {
-        UE_LOG(LogTemp, Warning, TEXT("StartBroadcastOpus: session %s is already active"), *EffectiveSessionId.ToString());
+        Tr.Packets = MoveTemp(Packets);
+    }
+    Tr.Header.NumPackets = Tr.Packets.Num();
+
+    OutSessionId = EffectiveSessionId;
+    FOutgoingTransfer& Added = Outgoing.Add(EffectiveSessionId, MoveTemp(Tr));
+
+    // Send the header right away
+    Server_StartTransfer(EffectiveSessionId, Added.Header);
+    Added.bHeaderSent = true;
+
+    return true;
+}
+
+bool UAudioReplicatorComponent::StartBroadcastPacked(const TArray<uint8>& Packed, FOpusStreamHeader Header, FGuid SessionId, FGuid& OutSessionId)
+{
+    FOpusPacketList Packets;
+    if (!PackedClip::Unpack(MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(Packed), Header, Packets))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("StartBroadcastPacked: malformed packed clip"));
+        return false;
+    }
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastPackedRange(const TArray<uint8>& Packed, float StartSec, float DurationSec, FGuid SessionId, FGuid& OutSessionId)
+{
+    FPackedClipReader Reader;
+    if (!Reader.Open(Packed))
+        return false;
+
+    FOpusPacketList Packets;
+    FOpusStreamHeader Header;
+    if (!CopyPackedRange(Reader, StartSec, DurationSec, Packets, Header))
+        return false;
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastPackedFile(const FString& Path, float StartSec, float DurationSec, FGuid SessionId, FGuid& OutSessionId)
+{
+    FMappedPackedClip Clip;
+    if (!Clip.Open(Path))
+        return false;
+
+    FOpusPacketList Packets;
+    FOpusStreamHeader Header;
+    if (!CopyPackedRange(Clip.GetReader(), StartSec, DurationSec, Packets, Header))
+        return false;
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastFromWav(const FString& WavPath, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId)
+{
+    FOpusPacketList Packets;
+    FOpusStreamHeader Header;
+    if (!EncodeWavToOpusPackets(WavPath, Bitrate, FrameMs, Packets, Header))
+        return false;
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastFromOggOpus(const FString& Path, FGuid SessionId, FGuid& OutSessionId)
+{
+    FOpusPacketList Packets;
+    FOpusStreamHeader Header;
+    if (!OggOpus::LoadOggOpusFile(Path, Header, Packets))
+        return false;
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastFromFloat(const TArray<float>& Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId)
+{
+    return StartBroadcastFromFloatView(Pcm, SampleRate, Channels, Bitrate, FrameMs, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastFromFloatView(TConstArrayView<float> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId)
+{
+    if (!FOpusResampler::IsOpusRate(SampleRate))
+    {
+        TArray<float> Resampled;
+        int32 OpusRate = 0;
+        if (!FOpusResampler::ResampleToOpusRate(Pcm, SampleRate, Channels, Resampled, OpusRate))
+            return false;
+        return StartBroadcastResampledFloat(Resampled, OpusRate, SampleRate, Channels, Bitrate, FrameMs, SessionId, OutSessionId);
+    }
+    return StartBroadcastResampledFloat(Pcm, SampleRate, 0, Channels, Bitrate, FrameMs, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::StartBroadcastResampledFloat(TConstArrayView<float> Pcm, int32 SampleRate, int32 SourceSampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId)
+{
+    FOpusStreamHeader Header;
+    Header.SampleRate = SampleRate;
+    Header.SourceSampleRate = SourceSampleRate;
+    Header.Channels = Channels;
+    Header.Bitrate = Bitrate;
+    Header.FrameMs = FrameMs;
+    Header.Profile = EncoderProfile;
+    Header.MappingFamily = bAmbisonicInput ? 3 : 0;
+
+    FOpusPacketList Packets;
+    if (!EncodeClip(Pcm, Header, bParallelEncode, Packets))
+        return false;
+
+    Header.NumPackets = Packets.Num();
+    return StartBroadcastPacketList(MoveTemp(Packets), Header, SessionId, OutSessionId);
+}
+
+bool UAudioReplicatorComponent::BeginLiveBroadcast(int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId)
+{
+    if (!IsOwnerClient())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BeginLiveBroadcast: must be called on owning client"));
+        return false;
+    }
+
+    FGuid EffectiveSessionId;
+    if (!MakeOutgoingSessionId(SessionId, TEXT("BeginLiveBroadcast"), EffectiveSessionId))
+        return false;
+
+    if (!FOpusResampler::IsOpusRate(SampleRate))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BeginLiveBroadcast: %d Hz is not an Opus rate; capture at 8/12/16/24/48 kHz"), SampleRate);
+        return false;
+    }
+
+    if (Channels < 1 || Channels > 2)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BeginLiveBroadcast: live capture is mono or stereo (got %d channels)"), Channels);
+        return false;
+    }
+
+    if (!IsValidOpusFrameMs(FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BeginLiveBroadcast: %g ms is not an Opus frame duration"), FrameMs);
+        return false;
+    }
+
+    const bool bCustom = LiveCodecMode == EOpusCodecMode::CustomLowDelay;
+    if (bCustom && !FOpusCustomEncoder::IsSupportedFormat(SampleRate, FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BeginLiveBroadcast: custom mode needs 48 kHz with 2.5 or 5 ms frames (got %d Hz, %g ms)"), SampleRate, FrameMs);
         return false;
     }
 
+    TSharedPtr<FOpusStreamEncoder> LiveEncoder = MakeShared<FOpusStreamEncoder>();
+    const int32 FrameSize = GetOpusFrameSamples(SampleRate, FrameMs); // per channel
+    const bool bInit = bCustom
+        ? LiveEncoder->InitCustom(SampleRate, Channels, Bitrate, FrameSize, EncoderProfile)
+        : LiveEncoder->Init(SampleRate, Channels, Bitrate, FrameSize, EncoderProfile);
+    if (!bInit)
+        return false;
+
+    // Short opening frames only pay off when they are actually shorter than the steady ones; custom mode is 2.5/5 ms anyway.
+    const float OpeningFrameMs = SnapOpusFrameMs(StartupFrameMs);
+    const bool bStartupFrames = !bCustom && bAdaptiveFrameSize && StartupFrames > 0 && OpeningFrameMs < FrameMs;
+    if (bStartupFrames && !LiveEncoder->SetStartupFrames(GetOpusFrameSamples(SampleRate, OpeningFrameMs), StartupFrames))
+        return false;
+
     OutSessionId = EffectiveSessionId;
 
     FOutgoingTransfer Tr;
     Tr.SessionId = EffectiveSessionId;
-    Tr.Header = Header;
-    Tr.Header.NumPackets = Packets.Num();
-    BuildChunks(Packets, Tr.Chunks);
+    Tr.Header.SampleRate = SampleRate;
+    Tr.Header.Channels = Channels;
+    Tr.Header.Bitrate = Bitrate;
+    Tr.Header.FrameMs = FrameMs;
+    Tr.Header.Profile = EncoderProfile;
+    Tr.Header.StartupFrameMs = bStartupFrames ? OpeningFrameMs : 0.0f;
+    Tr.Header.StartupFrames = bStartupFrames ? StartupFrames : 0;
+    Tr.Header.CodecMode = LiveCodecMode;
+    Tr.Header.NumPackets = 0; // unknown up front: receivers append chunks in arrival order
+    Tr.LiveEncoder = MoveTemp(LiveEncoder);
+    Tr.bLive = true;
+    if (bAdaptiveBitrate)
+    {
+        Tr.RateControl = MakeShared<FOpusRateController>();
+        Tr.RateControl->Init(Bitrate, RateControlSettings, FPlatformTime::Seconds());
+    }
 
-    Outgoing.Add(EffectiveSessionId, MoveTemp(Tr));
+    FOutgoingTransfer& Added = Outgoing.Add(EffectiveSessionId, MoveTemp(Tr));
+    Server_StartTransfer(EffectiveSessionId, Added.Header);
+    Added.bHeaderSent = true;
 
-    // Send the header right away
-    Server_StartTransfer(EffectiveSessionId, Header);
-    Outgoing[EffectiveSessionId].bHeaderSent = true;
+    return true;
+}
+
+FOpusRateSample UAudioReplicatorComponent::MeasureLink(const FOutgoingTransfer& Tr) const
+{
+    FOpusRateSample Sample;
+
+    // Frames encoded but still waiting for PumpTransfer (MaxPacketsPerTick holds them back).
+    const int32 Unsent = FMath::Max(0, Tr.Packets.Num() - Tr.NextIndex);
+    Sample.QueueDelaySec = Unsent * Tr.Header.FrameMs / 1000.0;
 
+    const AActor* Owner = GetOwner();
+    const UNetConnection* Connection = Owner ? Owner->GetNetConnection() : nullptr;
+    if (Connection)
+    {
+        // Bits the connection holds beyond its rate budget, as time at its current speed.
+        if (Connection->QueuedBits > 0 && Connection->CurrentNetSpeed > 0)
+        {
+            Sample.QueueDelaySec += Connection->QueuedBits / (8.0 * Connection->CurrentNetSpeed);
+        }
+        Sample.RttSec = Connection->AvgLag;
+        Sample.ThroughputBps = Connection->OutBytesPerSecond * 8.0;
+        Sample.LossPercent = Connection->GetOutLossPercentage().GetAvgLossPercentage() * 100.0f;
+    }
+    return Sample;
+}
+
+template <typename SampleType>
+bool UAudioReplicatorComponent::PushLiveImpl(const FGuid& SessionId, TConstArrayView<SampleType> Pcm)
+{
+    FOutgoingTransfer* Tr = Outgoing.Find(SessionId);
+    if (!Tr || !Tr->bLive || Tr->bLiveFinished || !Tr->LiveEncoder.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("PushLive: no open live session %s"), *SessionId.ToString());
+        return false;
+    }
+
+    // Retarget before encoding so the frames of this push already use the new rate.
+    if (Tr->RateControl.IsValid())
+    {
+        const int32 Target = Tr->RateControl->Update(MeasureLink(*Tr), FPlatformTime::Seconds());
+        if (Target != Tr->LiveEncoder->GetBitrate())
+        {
+            Tr->LiveEncoder->SetBitrate(Target);
+        }
+    }
+
+    int32 Emitted = 0;
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        Emitted = Tr->LiveEncoder->PushFloat(Pcm, Tr->Packets);
+    }
+    else
+    {
+        Emitted = Tr->LiveEncoder->PushPcm16(Pcm, Tr->Packets);
+    }
+    if (Emitted == INDEX_NONE)
+        return false;
+
+    // Don't wait for the next tick: a frame that just filled goes out now.
+    if (Emitted > 0)
+    {
+        FOpusChunk Scratch;
+        PumpTransfer(*Tr, Scratch);
+    }
     return true;
 }
 
-bool UAudioReplicatorComponent::StartBroadcastFromWav(const FString& WavPath, int32 Bitrate, int32 FrameMs, FGuid SessionId, FGuid& OutSessionId)
+bool UAudioReplicatorComponent::PushLiveFloat(const FGuid& SessionId, const TArray<float>& Pcm)
 {
-    TArray<FOpusPacket> Packets;
-    FOpusStreamHeader Header;
-    if (!EncodeWavToOpusPackets(WavPath, Bitrate, FrameMs, Packets, Header))
+    return PushLiveImpl<float>(SessionId, Pcm);
+}
+
+bool UAudioReplicatorComponent::PushLiveFloatView(const FGuid& SessionId, TConstArrayView<float> Pcm)
+{
+    return PushLiveImpl(SessionId, Pcm);
+}
+
+bool UAudioReplicatorComponent::PushLivePcm16(const FGuid& SessionId, TConstArrayView<int16> Pcm)
+{
+    return PushLiveImpl(SessionId, Pcm);
+}
+
+bool UAudioReplicatorComponent::EndLiveBroadcast(const FGuid& SessionId)
+{
+    FOutgoingTransfer* Tr = Outgoing.Find(SessionId);
+    if (!Tr || !Tr->bLive || Tr->bLiveFinished)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EndLiveBroadcast: no open live session %s"), *SessionId.ToString());
         return false;
-    return StartBroadcastOpus(Packets, Header, SessionId, OutSessionId);
+    }
+
+    const bool bFlushed = Tr->LiveEncoder.IsValid() && Tr->LiveEncoder->Flush(Tr->Packets) != INDEX_NONE;
+
+    // The encoder goes back to the pool now; the remaining chunks and end marker are sent from Tick.
+    Tr->LiveEncoder.Reset();
+    Tr->bLiveFinished = true;
+    return bFlushed;
 }
 
 void UAudioReplicatorComponent::CancelBroadcast(const FGuid& SessionId)
@@ -155,7 +648,7 @@ void UAudioReplicatorComponent::CancelBroadcast(const FGuid& SessionId)
         // Send the end marker if it has not been sent yet
         if (!Tr->bEndSent && Tr->bHeaderSent)
         {
-            Server_EndTransfer(SessionId);
+            Server_EndTransfer(SessionId, Tr->PendingElided, Tr->NextIndex);
             Tr->bEndSent = true;
         }
         Outgoing.Remove(SessionId);
@@ -166,8 +659,22 @@ bool UAudioReplicatorComponent::GetReceivedPackets(const FGuid& SessionId, TArra
 {
     if (const FIncomingTransfer* In = Incoming.Find(SessionId))
     {
-        OutPackets = In->Packets;
         OutHeader = In->Header;
+        if (In->Header.FramesPerPacket <= 1 || IsOpusMultistream(In->Header) || IsOpusCustom(In->Header))
+        {
+            OutPackets = In->Packets;
+            return true;
+        }
+
+        // Bundled transfer: hand out one packet per frame, exactly as the sender encoded it.
+        FOpusPacketList Split;
+        FOpusRepacketizer Repacketizer;
+        if (!Repacketizer.Split(FOpusPacketList::FromPackets(In->Packets), Split))
+            return false;
+
+        Split.ToPackets(OutPackets);
+        OutHeader.NumPackets = Split.Num();
+        OutHeader.FramesPerPacket = 1;
         return true;
 #if 0
         // Optional: clear the cache after reading
@@ -177,6 +684,78 @@ bool UAudioReplicatorComponent::GetReceivedPackets(const FGuid& SessionId, TArra
     return false;
 }
 
+bool UAudioReplicatorComponent::DecodeReceivedToFloat(const FGuid& SessionId, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels) const
+{
+    const FIncomingTransfer* In = Incoming.Find(SessionId);
+    if (!In)
+        return false;
+
+    // Custom-mode streams only decode at their own rate.
+    const int32 DecodeSR = IsOpusCustom(In->Header) ? In->Header.SampleRate : GetOpusDecodeSampleRate(DecodeRate, In->Header.SampleRate);
+    const int32 ConcealSamples = GetOpusFrameSamples(DecodeSR, GetOpusFrameMsAt(In->Header, 0));
+
+    TArray<FOpusPacketView> Views;
+    GetOpusPacketViews(In->Packets, Views);
+
+    if (IsOpusCustom(In->Header))
+    {
+        FOpusCustomDecoder Decoder;
+        if (!Decoder.InitFromHeader(In->Header) || !Decoder.DecodePacketsToFloat(Views, OutPcm))
+            return false;
+    }
+    else if (IsOpusProjection(In->Header))
+    {
+        FOpusProjectionDecoder Decoder;
+        if (!Decoder.InitFromHeader(In->Header, DecodeSR))
+            return false;
+        Decoder.SetConcealFrameSamples(ConcealSamples);
+        if (!Decoder.DecodePacketsToFloat(Views, OutPcm))
+            return false;
+    }
+    else if (IsOpusMultistream(In->Header))
+    {
+        FOpusMultistreamDecoder Decoder;
+        if (!Decoder.InitFromHeader(In->Header, DecodeSR))
+            return false;
+        Decoder.SetConcealFrameSamples(ConcealSamples);
+        if (!Decoder.DecodePacketsToFloat(Views, OutPcm))
+            return false;
+    }
+    else
+    {
+        FOpusDecoderLease Decoder = UAudioReplicatorCodecPoolSubsystem::AcquireDecoder(DecodeSR, In->Header.Channels);
+        if (!Decoder)
+            return false;
+        Decoder->SetConcealFrameSamples(ConcealSamples);
+        if (!Decoder->DecodePacketsToFloat(Views, OutPcm))
+            return false;
+    }
+
+    TrimOpusDecodedPcm(In->Header, DecodeSR, In->Header.Channels, OutPcm);
+    OutSampleRate = DecodeSR;
+    OutChannels = In->Header.Channels;
+    return true;
+}
+
+bool UAudioReplicatorComponent::PullLiveAudio(const FGuid& SessionId, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels)
+{
+    OutPcm.Reset();
+    FOpusJitterBuffer* Jitter = GetJitterBuffer(SessionId);
+    if (!Jitter || Jitter->IsDrained())
+        return false;
+
+    Jitter->PopDue(FPlatformTime::Seconds(), OutPcm);
+    OutSampleRate = Jitter->GetSampleRate();
+    OutChannels = Jitter->GetChannels();
+    return true;
+}
+
+FOpusJitterBuffer* UAudioReplicatorComponent::GetJitterBuffer(const FGuid& SessionId) const
+{
+    const FIncomingTransfer* In = Incoming.Find(SessionId);
+    return In ? In->Jitter.Get() : nullptr;
+}
+
 bool UAudioReplicatorComponent::GetOutgoingDebugInfo(const FGuid& SessionId, FAudioReplicatorOutgoingDebug& OutDebug) const
 {
     if (const FOutgoingTransfer* Tr = Outgoing.Find(SessionId))
@@ -184,29 +763,37 @@ bool UAudioReplicatorComponent::GetOutgoingDebugInfo(const FGuid& SessionId, FAu
         OutDebug = FAudioReplicatorOutgoingDebug();
         OutDebug.SessionId = SessionId;
         OutDebug.Header = Tr->Header;
-        OutDebug.TotalChunks = Tr->Chunks.Num();
+        OutDebug.TotalChunks = Tr->Packets.Num();
         OutDebug.SentChunks = FMath::Clamp(Tr->NextIndex, 0, OutDebug.TotalChunks);
         OutDebug.PendingChunks = FMath::Max(0, OutDebug.TotalChunks - OutDebug.SentChunks);
         OutDebug.NextChunkIndex = FMath::Clamp(Tr->NextIndex, 0, OutDebug.TotalChunks);
         OutDebug.bHeaderSent = Tr->bHeaderSent;
         OutDebug.bEndSent = Tr->bEndSent;
+        OutDebug.bLiveCapturing = Tr->bLive && !Tr->bLiveFinished;
+        OutDebug.ElidedFrames = Tr->ElidedFrames;
+        OutDebug.CurrentBitrate = Tr->LiveEncoder.IsValid() ? Tr->LiveEncoder->GetBitrate() : Tr->Header.Bitrate;
+        if (Tr->RateControl.IsValid())
+        {
+            OutDebug.bRateControlled = true;
+            OutDebug.CurrentBitrate = Tr->RateControl->GetTargetBitrate();
+            Tr->RateControl->GetHistory(OutDebug.BitrateHistory);
+        }
 
         OutDebug.Chunks.Reset(OutDebug.TotalChunks);
         OutDebug.PendingChunkIndices.Reset();
 
         int32 TotalBytes = 0;
-        for (int32 i = 0; i < Tr->Chunks.Num(); ++i)
+        for (int32 i = 0; i < Tr->Packets.Num(); ++i)
         {
-            const FOpusChunk& Chunk = Tr->Chunks[i];
-
             FAudioReplicatorChunkDebug ChunkDebug;
-            ChunkDebug.Index = Chunk.Index;
-            ChunkDebug.SizeBytes = Chunk.Packet.Data.Num();
-            ChunkDebug.bIsSent = (i < Tr->NextIndex);
+            ChunkDebug.Index = i;
+            ChunkDebug.SizeBytes = Tr->Packets.GetLength(i);
+            ChunkDebug.bIsElided = bElideSilentFrames && IsDtxPacket(Tr->Header, ChunkDebug.SizeBytes);
+            ChunkDebug.bIsSent = (i < Tr->NextIndex) && !ChunkDebug.bIsElided;
             ChunkDebug.bIsReceived = false;
 
             TotalBytes += ChunkDebug.SizeBytes;
-            if (!ChunkDebug.bIsSent)
+            if (i >= Tr->NextIndex)
             {
                 OutDebug.PendingChunkIndices.Add(ChunkDebug.Index);
             }
@@ -215,9 +802,8 @@ bool UAudioReplicatorComponent::GetOutgoingDebugInfo(const FGuid& SessionId, FAu
         }
 
         OutDebug.TotalBytes = TotalBytes;
-        OutDebug.EstimatedDurationSec = (Tr->Header.FrameMs > 0)
-            ? (OutDebug.TotalChunks * Tr->Header.FrameMs) / 1000.0f
-            : 0.0f;
+        // Bundled chunks carry up to FramesPerPacket frames; the last one may be shorter, so this is an upper estimate.
+        OutDebug.EstimatedDurationSec = float(GetOpusFrameStartSec(Tr->Header, OutDebug.TotalChunks * FMath::Max(1, Tr->Header.FramesPerPacket)));
 
         if (OutDebug.EstimatedDurationSec > 0.0f)
         {
@@ -247,6 +833,7 @@ bool UAudioReplicatorComponent::GetIncomingDebugInfo(const FGuid& SessionId, FAu
         OutDebug.bStarted = In->bStarted;
         OutDebug.bEnded = In->bEnded;
         OutDebug.ReceivedChunks = In->Received;
+        OutDebug.ElidedFrames = In->ElidedFrames;
 
         OutDebug.ExpectedChunks = (In->Header.NumPackets > 0) ? In->Header.NumPackets : 0;
         const int32 DisplayChunkCount = (OutDebug.ExpectedChunks > 0) ? OutDebug.ExpectedChunks : In->Packets.Num();
@@ -276,7 +863,9 @@ bool UAudioReplicatorComponent::GetIncomingDebugInfo(const FGuid& SessionId, FAu
                 }
             }
 
-            if (!ChunkDebug.bIsReceived && OutDebug.ExpectedChunks > 0)
+            ChunkDebug.bIsElided = In->ElidedSlots.IsValidIndex(Index) && In->ElidedSlots[Index];
+
+            if (!ChunkDebug.bIsReceived && !ChunkDebug.bIsElided && OutDebug.ExpectedChunks > 0)
             {
                 OutDebug.MissingChunkIndices.Add(Index);
             }
@@ -287,12 +876,11 @@ bool UAudioReplicatorComponent::GetIncomingDebugInfo(const FGuid& SessionId, FAu
         OutDebug.UniqueChunks = UniqueChunks;
         OutDebug.TotalBytes = TotalBytes;
         OutDebug.MissingChunks = (OutDebug.ExpectedChunks > 0)
-            ? FMath::Max(0, OutDebug.ExpectedChunks - UniqueChunks)
+            ? FMath::Max(0, OutDebug.ExpectedChunks - UniqueChunks - In->ElidedFrames)
             : 0;
 
-        OutDebug.EstimatedDurationSec = (In->Header.FrameMs > 0)
-            ? (UniqueChunks * In->Header.FrameMs) / 1000.0f
-            : 0.0f;
+        // Elided slots are always single frames, even in bundled transfers.
+        OutDebug.EstimatedDurationSec = float(GetOpusFrameStartSec(In->Header, UniqueChunks * FMath::Max(1, In->Header.FramesPerPacket) + In->ElidedFrames));
 
         if (OutDebug.EstimatedDurationSec > 0.0f)
         {
@@ -305,6 +893,56 @@ bool UAudioReplicatorComponent::GetIncomingDebugInfo(const FGuid& SessionId, FAu
 
         OutDebug.bReadyToAssemble = OutDebug.bEnded && (OutDebug.ExpectedChunks == 0 || OutDebug.MissingChunks == 0);
 
+        if (In->Jitter.IsValid())
+        {
+            OutDebug.bHasJitterBuffer = true;
+            OutDebug.Jitter = In->Jitter->GetStats();
+        }
+
+        return true;
+    }
+    return false;
+}
+
+bool UAudioReplicatorComponent::PumpTransfer(FOutgoingTransfer& Tr, FOpusChunk& Scratch)
+{
+    if (!Tr.bHeaderSent)
+        return false;
+
+    int32 SentThisTick = 0;
+    while (Tr.NextIndex < Tr.Packets.Num() && SentThisTick < MaxPacketsPerTick)
+    {
+        // Silent frames cost no RPC; the next chunk (or the end marker) tells receivers how many were skipped.
+        if (bElideSilentFrames && IsDtxPacket(Tr.Header, Tr.Packets.GetLength(Tr.NextIndex)))
+        {
+            Tr.NextIndex++;
+            Tr.PendingElided++;
+            Tr.ElidedFrames++;
+            continue;
+        }
+
+        BuildChunk(Tr.Packets, Tr.NextIndex, Scratch);
+        Scratch.ElidedBefore = Tr.PendingElided;
+        if (Tr.bLive && bUnreliableLiveChunks)
+        {
+            Server_SendChunkUnreliable(Tr.SessionId, Scratch);
+        }
+        else
+        {
+            Server_SendChunk(Tr.SessionId, Scratch);
+        }
+        Tr.PendingElided = 0;
+        Tr.NextIndex++;
+        SentThisTick++;
+    }
+
+    // A live session may run dry between pushes; only close it once the capture has ended.
+    const bool bNoMoreInput = !Tr.bLive || Tr.bLiveFinished;
+    if (bNoMoreInput && Tr.NextIndex >= Tr.Packets.Num() && !Tr.bEndSent)
+    {
+        Server_EndTransfer(Tr.SessionId, Tr.PendingElided, Tr.Packets.Num());
+        Tr.PendingElided = 0;
+        Tr.bEndSent = true;
         return true;
     }
     return false;
@@ -314,29 +952,42 @@ void UAudioReplicatorComponent::TickComponent(float DeltaTime, ELevelTick TickTy
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-    if (!IsOwnerClient()) return;
-
-    // Pump outgoing queues
-    TArray<FGuid> ToFinish;
-    for (auto& KV : Outgoing)
+    // Relayed chunks that arrived since the last tick leave as one bundle.
+    if (bRelayHub)
     {
-        FOutgoingTransfer& Tr = KV.Value;
-        if (!Tr.bHeaderSent)
-            continue;
+        FlushRelayBundles();
+    }
 
-        int32 SentThisTick = 0;
-        while (Tr.NextIndex < Tr.Chunks.Num() && SentThisTick < MaxPacketsPerTick)
+    // Sessions whose end marker is waiting on chunks that were lost (unreliable live chunks) end without them.
+    // OnTransferEnded handlers may drop sessions, so the map is not walked while they run.
+    const double Now = FPlatformTime::Seconds();
+    TArray<FGuid> Stalled;
+    for (const auto& KV : Incoming)
+    {
+        if (!KV.Value.bEnded && KV.Value.EndSlots != INDEX_NONE && Now - KV.Value.EndMarkerTime > MaxEndMarkerWaitSec)
         {
-            Server_SendChunk(Tr.SessionId, Tr.Chunks[Tr.NextIndex]);
-            Tr.NextIndex++;
-            SentThisTick++;
+            Stalled.Add(KV.Key);
+        }
+    }
+    for (const FGuid& S : Stalled)
+    {
+        if (FIncomingTransfer* In = Incoming.Find(S))
+        {
+            TryFinishIncoming(S, *In, /*bForce=*/true);
         }
+    }
+
+    if (!IsOwnerClient()) return;
 
-        if (Tr.NextIndex >= Tr.Chunks.Num() && !Tr.bEndSent)
+    // Pump outgoing queues. RPC parameters are serialized at call time, so one scratch chunk
+    // is reused for every send instead of materialising a chunk array per transfer.
+    TArray<FGuid> ToFinish;
+    FOpusChunk Scratch;
+    for (auto& KV : Outgoing)
+    {
+        if (PumpTransfer(KV.Value, Scratch))
         {
-            Server_EndTransfer(Tr.SessionId);
-            Tr.bEndSent = true;
-            ToFinish.Add(Tr.SessionId);
+            ToFinish.Add(KV.Key);
         }
     }
 
@@ -350,17 +1001,165 @@ void UAudioReplicatorComponent::TickComponent(float DeltaTime, ELevelTick TickTy
 
 void UAudioReplicatorComponent::Server_StartTransfer_Implementation(const FGuid& SessionId, const FOpusStreamHeader& Header)
 {
+    // Live single-stream sessions can share the hub's bundles: one packet per chunk, one stream per packet.
+    // Custom-mode packets have no TOC byte, so they cannot be self-delimited into a bundle.
+    RelayedSessions.Remove(SessionId);
+    if (GetRelayHub() && Header.NumPackets == 0 && Header.FramesPerPacket <= 1 && !IsOpusMultistream(Header) && !IsOpusCustom(Header))
+    {
+        RelayedSessions.Add(SessionId);
+    }
     Multicast_StartTransfer(SessionId, Header);
 }
 
 void UAudioReplicatorComponent::Server_SendChunk_Implementation(const FGuid& SessionId, const FOpusChunk& Chunk)
 {
-    Multicast_SendChunk(SessionId, Chunk);
+    if (!RelayChunk(SessionId, Chunk, /*bReliable=*/true))
+    {
+        Multicast_SendChunk(SessionId, Chunk);
+    }
+}
+
+void UAudioReplicatorComponent::Server_SendChunkUnreliable_Implementation(const FGuid& SessionId, const FOpusChunk& Chunk)
+{
+    if (!RelayChunk(SessionId, Chunk, /*bReliable=*/false))
+    {
+        Multicast_SendChunkUnreliable(SessionId, Chunk);
+    }
+}
+
+void UAudioReplicatorComponent::Server_EndTransfer_Implementation(const FGuid& SessionId, int32 TrailingElided, int32 NumSlots)
+{
+    // Get this session's queued chunks out before the end marker. They still travel on the hub's channel, which is not
+    // ordered against this one, so receivers hold the end back until NumSlots are accounted for.
+    if (RelayedSessions.Remove(SessionId) > 0)
+    {
+        if (UAudioReplicatorComponent* Hub = GetRelayHub())
+        {
+            Hub->FlushRelayBundles();
+        }
+    }
+    Multicast_EndTransfer(SessionId, TrailingElided, NumSlots);
+}
+
+// ================= RELAY HUB =================
+
+UAudioReplicatorComponent* UAudioReplicatorComponent::GetRelayHub() const
+{
+    if (const UWorld* World = GetWorld())
+    {
+        if (const UAudioReplicatorRegistrySubsystem* Registry = World->GetSubsystem<UAudioReplicatorRegistrySubsystem>())
+        {
+            return Registry->GetRelayHub();
+        }
+    }
+    return nullptr;
 }
 
-void UAudioReplicatorComponent::Server_EndTransfer_Implementation(const FGuid& SessionId)
+bool UAudioReplicatorComponent::RelayChunk(const FGuid& SessionId, const FOpusChunk& Chunk, bool bReliable)
 {
-    Multicast_EndTransfer(SessionId);
+    // Empty payloads cannot be framed; they are rare enough to go out on their own.
+    if (Chunk.Packet.Data.Num() == 0 || !RelayedSessions.Contains(SessionId))
+        return false;
+
+    UAudioReplicatorComponent* Hub = GetRelayHub();
+    if (!Hub)
+        return false;
+
+    FOpusRelayedChunk& Queued = Hub->PendingRelay.AddDefaulted_GetRef();
+    Queued.Speaker = this;
+    Queued.SessionId = SessionId;
+    Queued.Chunk = Chunk;
+    Queued.bReliable = bReliable;
+    return true;
+}
+
+void UAudioReplicatorComponent::FlushRelayBundles()
+{
+    if (PendingRelay.Num() == 0)
+        return;
+
+    FOpusRelayBundle Bundle;
+    TArray<const FOpusRelayedChunk*, TInlineAllocator<MaxStreamsPerRelayBundle>> Included;
+    TArray<TArrayView<const uint8>, TInlineAllocator<MaxStreamsPerRelayBundle>> Streams;
+
+    for (int32 First = 0; First < PendingRelay.Num(); First += MaxStreamsPerRelayBundle)
+    {
+        const int32 Count = FMath::Min(MaxStreamsPerRelayBundle, PendingRelay.Num() - First);
+        Included.Reset();
+        Streams.Reset();
+        bool bReliable = false;
+        for (int32 i = First; i < First + Count; ++i)
+        {
+            const FOpusRelayedChunk& Queued = PendingRelay[i];
+            if (Queued.Speaker.IsValid())
+            {
+                Included.Add(&Queued);
+                Streams.Add(Queued.Chunk.Packet.Data);
+                bReliable |= Queued.bReliable;
+            }
+        }
+        if (Included.Num() == 0)
+            continue;
+
+        if (!OpusMultistreamPacket::Pack(Streams, Bundle.Packet.Data))
+        {
+            // A payload that is not a well-formed Opus packet: relay these the usual way.
+            for (const FOpusRelayedChunk* Queued : Included)
+            {
+                if (Queued->bReliable)
+                    Queued->Speaker->Multicast_SendChunk(Queued->SessionId, Queued->Chunk);
+                else
+                    Queued->Speaker->Multicast_SendChunkUnreliable(Queued->SessionId, Queued->Chunk);
+            }
+            continue;
+        }
+
+        Bundle.Speakers.Reset(Included.Num());
+        Bundle.SessionIds.Reset(Included.Num());
+        Bundle.Indices.Reset(Included.Num());
+        Bundle.ElidedBefore.Reset(Included.Num());
+        for (const FOpusRelayedChunk* Queued : Included)
+        {
+            Bundle.Speakers.Add(Queued->Speaker.Get());
+            Bundle.SessionIds.Add(Queued->SessionId);
+            Bundle.Indices.Add(Queued->Chunk.Index);
+            Bundle.ElidedBefore.Add(Queued->Chunk.ElidedBefore);
+        }
+
+        if (bReliable)
+            Multicast_RelayBundle(Bundle);
+        else
+            Multicast_RelayBundleUnreliable(Bundle);
+    }
+    PendingRelay.Reset();
+}
+
+void UAudioReplicatorComponent::ReceiveRelayBundle(const FOpusRelayBundle& Bundle)
+{
+    const int32 NumStreams = Bundle.Speakers.Num();
+    if (NumStreams == 0 || Bundle.SessionIds.Num() != NumStreams || Bundle.Indices.Num() != NumStreams || Bundle.ElidedBefore.Num() != NumStreams)
+        return;
+
+    TArray<TArray<uint8>> Payloads;
+    if (!OpusMultistreamPacket::Unpack(Bundle.Packet.Data, NumStreams, Payloads))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ReceiveRelayBundle: malformed bundle of %d streams"), NumStreams);
+        return;
+    }
+
+    FOpusChunk Chunk;
+    for (int32 s = 0; s < NumStreams; ++s)
+    {
+        // Speakers not relevant to this client resolve to null; their chunks are dropped like their direct multicasts would be.
+        UAudioReplicatorComponent* Speaker = Bundle.Speakers[s];
+        if (!Speaker)
+            continue;
+
+        Chunk.Index = Bundle.Indices[s];
+        Chunk.ElidedBefore = Bundle.ElidedBefore[s];
+        Chunk.Packet.Data = MoveTemp(Payloads[s]);
+        Speaker->ReceiveChunk(Bundle.SessionIds[s], Chunk);
+    }
 }
 
 // ================= MULTICAST RPC =================
@@ -368,16 +1167,78 @@ void UAudioReplicatorComponent::Server_EndTransfer_Implementation(const FGuid& S
 void UAudioReplicatorComponent::Multicast_StartTransfer_Implementation(const FGuid& SessionId, const FOpusStreamHeader& Header)
 {
     FIncomingTransfer& In = Incoming.FindOrAdd(SessionId);
+
+    // Keep relayed chunks that overtook the header.
+    const bool bKeepEarlyChunks = !In.bHaveHeader && In.Received > 0;
+
     In.Header = Header;
-    In.Packets.Reset(Header.NumPackets > 0 ? Header.NumPackets : 0);
-    In.Received = 0;
+    In.bHaveHeader = true;
     In.bStarted = true;
     In.bEnded = false;
+    In.EndSlots = INDEX_NONE;
+    In.EndTrailingElided = 0;
+    In.Jitter.Reset();
+    if (!bKeepEarlyChunks)
+    {
+        In.Packets.Reset(Header.NumPackets > 0 ? Header.NumPackets : 0);
+        In.Received = 0;
+        In.ElidedSlots.Reset();
+        In.ElidedFrames = 0;
+        In.ReceivedSlots.Reset();
+        In.CoveredSlots = 0;
+    }
+
+    // Live sessions (unknown length, one frame per packet) can be played while they stream.
+    // Surround sessions are clip-only and decoded in one go.
+    if (bEnableJitterBuffer && Header.NumPackets == 0 && Header.FramesPerPacket <= 1 && !IsOpusMultistream(Header))
+    {
+        const int32 DecodeSR = GetOpusDecodeSampleRate(DecodeRate, Header.SampleRate);
+        TSharedPtr<FOpusJitterBuffer> Jitter = MakeShared<FOpusJitterBuffer>();
+        if (Jitter->Init(DecodeSR, Header, JitterBufferSettings))
+        {
+            // Chunks that overtook the header go in first, each with the elided run right before it.
+            const double Now = FPlatformTime::Seconds();
+            int32 ElidedRun = 0;
+            for (int32 i = 0; i < In.Packets.Num(); ++i)
+            {
+                if (In.ReceivedSlots.IsValidIndex(i) && In.ReceivedSlots[i])
+                {
+                    Jitter->Push(i, In.Packets[i].Data, ElidedRun, Now);
+                    ElidedRun = 0;
+                }
+                else
+                {
+                    ElidedRun = (In.ElidedSlots.IsValidIndex(i) && In.ElidedSlots[i]) ? ElidedRun + 1 : 0;
+                }
+            }
+            In.Jitter = MoveTemp(Jitter);
+        }
+    }
 
     OnTransferStarted.Broadcast(SessionId, Header);
 }
 
 void UAudioReplicatorComponent::Multicast_SendChunk_Implementation(const FGuid& SessionId, const FOpusChunk& Chunk)
+{
+    ReceiveChunk(SessionId, Chunk);
+}
+
+void UAudioReplicatorComponent::Multicast_SendChunkUnreliable_Implementation(const FGuid& SessionId, const FOpusChunk& Chunk)
+{
+    ReceiveChunk(SessionId, Chunk);
+}
+
+void UAudioReplicatorComponent::Multicast_RelayBundle_Implementation(const FOpusRelayBundle& Bundle)
+{
+    ReceiveRelayBundle(Bundle);
+}
+
+void UAudioReplicatorComponent::Multicast_RelayBundleUnreliable_Implementation(const FOpusRelayBundle& Bundle)
+{
+    ReceiveRelayBundle(Bundle);
+}
+
+void UAudioReplicatorComponent::ReceiveChunk(const FGuid& SessionId, const FOpusChunk& Chunk)
 {
     FIncomingTransfer& In = Incoming.FindOrAdd(SessionId);
     if (!In.bStarted)
@@ -386,29 +1247,126 @@ void UAudioReplicatorComponent::Multicast_SendChunk_Implementation(const FGuid&
         In.bStarted = true;
     }
 
+    if (In.bEnded)
+    {
+        // Only chunks given up as lost can still turn up; the session was played and reported without them.
+        UE_LOG(LogTemp, Warning, TEXT("ReceiveChunk: dropping chunk %d of ended session %s"), Chunk.Index, *SessionId.ToString());
+        return;
+    }
+
     // Ensure the array has enough room
     if (In.Header.NumPackets > 0 && In.Packets.Num() < In.Header.NumPackets)
         In.Packets.SetNum(In.Header.NumPackets);
 
-    if (In.Header.NumPackets > 0 && Chunk.Index >= 0 && Chunk.Index < In.Packets.Num())
+    if (Chunk.Index >= 0)
     {
+        // Indices come from a peer: keep them inside the clip, or within reach of what a live session has received.
+        // Once the end marker is in, nothing may land in or past the trailing silence it announced.
+        int64 IndexLimit = (In.Header.NumPackets > 0)
+            ? (int64)In.Header.NumPackets
+            : (int64)In.Packets.Num() + GetMaxLiveLeadSlots(In.Header);
+        if (In.EndSlots != INDEX_NONE)
+            IndexLimit = FMath::Min<int64>(IndexLimit, In.EndSlots - In.EndTrailingElided);
+        if (Chunk.Index >= IndexLimit || Chunk.ElidedBefore < 0 || Chunk.Index - Chunk.ElidedBefore < 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ReceiveChunk: dropping chunk %d (elided %d) of session %s, limit %lld"),
+                Chunk.Index, Chunk.ElidedBefore, *SessionId.ToString(), IndexLimit);
+            return;
+        }
+
+        // Place by index even when NumPackets is unknown (live sessions), so elided silence leaves a gap to conceal.
+        if (Chunk.Index >= In.Packets.Num())
+            In.Packets.SetNum(Chunk.Index + 1);
         In.Packets[Chunk.Index] = Chunk.Packet;
+        MarkElided(In, Chunk.Index - Chunk.ElidedBefore, Chunk.ElidedBefore);
+        if (In.ReceivedSlots.Num() <= Chunk.Index)
+            In.ReceivedSlots.Add(false, Chunk.Index + 1 - In.ReceivedSlots.Num());
+        In.ReceivedSlots[Chunk.Index] = true;
+
+        if (In.Jitter.IsValid())
+        {
+            In.Jitter->Push(Chunk.Index, Chunk.Packet.Data, Chunk.ElidedBefore, FPlatformTime::Seconds());
+        }
     }
     else
     {
-        // When NumPackets is unknown, append sequentially
         In.Packets.Add(Chunk.Packet);
     }
 
     In.Received++;
     OnChunkReceived.Broadcast(SessionId, Chunk);
+
+    if (In.EndSlots != INDEX_NONE)
+    {
+        TryFinishIncoming(SessionId, In, /*bForce=*/false);
+    }
+}
+
+void UAudioReplicatorComponent::Multicast_EndTransfer_Implementation(const FGuid& SessionId, int32 TrailingElided, int32 NumSlots)
+{
+    FIncomingTransfer* In = Incoming.Find(SessionId);
+    if (!In)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            if (UAudioReplicatorRegistrySubsystem* Registry = World->GetSubsystem<UAudioReplicatorRegistrySubsystem>())
+            {
+                Registry->NotifySessionActivity(SessionId, this);
+            }
+        }
+        OnTransferEnded.Broadcast(this, SessionId);
+        return;
+    }
+    if (In->bEnded)
+        return;
+
+    // Both counts come from the sender: the trailing silence may only span the live lead, and the session may not
+    // claim more slots than the clip has or than a live chunk could still reach.
+    const int32 MaxTrailing = (In->Header.NumPackets > 0) ? In->Header.NumPackets : GetMaxLiveLeadSlots(In->Header);
+    const int64 MaxSlots = (In->Header.NumPackets > 0)
+        ? (int64)In->Header.NumPackets
+        : (int64)In->Packets.Num() + GetMaxLiveLeadSlots(In->Header) + TrailingElided;
+    if (TrailingElided < 0 || TrailingElided > MaxTrailing || NumSlots < TrailingElided || NumSlots > MaxSlots)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EndTransfer: ignoring %d slots (%d trailing elided) for session %s (at most %lld, %d trailing)"),
+            NumSlots, TrailingElided, *SessionId.ToString(), MaxSlots, MaxTrailing);
+        In->EndSlots = In->Packets.Num();
+        In->EndTrailingElided = 0;
+        TryFinishIncoming(SessionId, *In, /*bForce=*/true);
+        return;
+    }
+
+    In->EndSlots = NumSlots;
+    In->EndTrailingElided = TrailingElided;
+    In->EndMarkerTime = FPlatformTime::Seconds();
+    TryFinishIncoming(SessionId, *In, /*bForce=*/false);
 }
 
-void UAudioReplicatorComponent::Multicast_EndTransfer_Implementation(const FGuid& SessionId)
+void UAudioReplicatorComponent::TryFinishIncoming(const FGuid& SessionId, FIncomingTransfer& In, bool bForce)
 {
-    if (FIncomingTransfer* In = Incoming.Find(SessionId))
+    if (In.bEnded || In.EndSlots == INDEX_NONE)
+        return;
+
+    const int32 AudioSlots = In.EndSlots - In.EndTrailingElided;
+    while (In.CoveredSlots < AudioSlots
+        && ((In.ReceivedSlots.IsValidIndex(In.CoveredSlots) && In.ReceivedSlots[In.CoveredSlots])
+            || (In.ElidedSlots.IsValidIndex(In.CoveredSlots) && In.ElidedSlots[In.CoveredSlots])))
+    {
+        ++In.CoveredSlots;
+    }
+    if (In.CoveredSlots < AudioSlots && !bForce)
+        return;
+
+    // Silence at the very end: add empty slots so decoding still covers the full duration.
+    // Slots still missing stay empty and are concealed on decode.
+    if (In.Packets.Num() < In.EndSlots)
+        In.Packets.SetNum(In.EndSlots);
+    MarkElided(In, AudioSlots, In.EndTrailingElided);
+
+    In.bEnded = true;
+    if (In.Jitter.IsValid())
     {
-        In->bEnded = true;
+        In.Jitter->MarkEnded();
     }
 
     if (UWorld* World = GetWorld())
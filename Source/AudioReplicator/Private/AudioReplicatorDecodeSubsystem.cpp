@@ -0,0 +1,319 @@
+#include "AudioReplicatorDecodeSubsystem.h"
+#include "AudioReplicatorComponent.h"
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "PackedClip.h"
+#include "OpusMultistream.h"
+#include "OpusProjection.h"
+#include "OpusCustom.h"
+#include "HAL/PlatformTime.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+namespace
+{
+    // Cancellation is polled between batches; ~1 s of 20 ms frames keeps the check cheap but responsive.
+    constexpr int32 PacketsPerBatch = 50;
+
+    template <typename SampleType>
+    bool DecodeInBatches(FOpusDecoderState& Decoder, TConstArrayView<FOpusPacketView> Views,
+        const std::atomic<bool>& bCancelled, TArray<SampleType>& OutPcm)
+    {
+        OutPcm.Reset();
+
+        const int32 Total = Decoder.GetDecodedSampleCount(Views);
+        if (Total < 0) return false;
+
+        OutPcm.SetNumUninitialized(Total);
+        int32 Written = 0;
+        for (int32 First = 0; First < Views.Num(); First += PacketsPerBatch)
+        {
+            if (bCancelled.load(std::memory_order_relaxed))
+            {
+                OutPcm.Reset();
+                return false;
+            }
+
+            const int32 Count = FMath::Min(PacketsPerBatch, Views.Num() - First);
+            const int32 Batch = Decoder.DecodePacketsToBuffer(Views.Slice(First, Count),
+                TArrayView<SampleType>(OutPcm.GetData() + Written, Total - Written));
+            if (Batch < 0)
+            {
+                OutPcm.Reset();
+                return false;
+            }
+            Written += Batch;
+        }
+
+        OutPcm.SetNum(Written, EAllowShrinking::No);
+        return true;
+    }
+
+    // Surround, ambisonics and custom-mode sessions: their decoders have no up-front size query, so batches are appended as they come.
+    template <typename DecoderType, typename SampleType>
+    bool DecodeMultistreamInBatches(DecoderType& Decoder, TConstArrayView<FOpusPacketView> Views,
+        const std::atomic<bool>& bCancelled, TArray<SampleType>& OutPcm)
+    {
+        OutPcm.Reset();
+
+        TArray<SampleType> Batch;
+        for (int32 First = 0; First < Views.Num(); First += PacketsPerBatch)
+        {
+            if (bCancelled.load(std::memory_order_relaxed))
+            {
+                OutPcm.Reset();
+                return false;
+            }
+
+            const TConstArrayView<FOpusPacketView> Slice = Views.Slice(First, FMath::Min(PacketsPerBatch, Views.Num() - First));
+            bool bDecoded = false;
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                bDecoded = Decoder.DecodePacketsToFloat(Slice, Batch);
+            }
+            else
+            {
+                bDecoded = Decoder.DecodePacketsToPcm16(Slice, Batch);
+            }
+            if (!bDecoded)
+            {
+                OutPcm.Reset();
+                return false;
+            }
+            OutPcm.Append(Batch);
+        }
+        return true;
+    }
+}
+
+struct UAudioReplicatorDecodeSubsystem::FJob
+{
+    FOpusStreamHeader Header;
+    FOpusPacketList Packets;
+    bool bDecodeToFloat = false;
+    std::atomic<bool> bCancelled{ false };
+
+    // Written by the worker before it posts the job; read on the game thread after dequeue.
+    FOpusDecodeResult Result;
+
+    // Only touched on the game thread.
+    FOnOpusDecodeDone OnDone;
+    bool bNotifyBlueprint = false;
+};
+
+void UAudioReplicatorDecodeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    Completions = MakeShared<FCompletionQueue, ESPMode::ThreadSafe>();
+}
+
+void UAudioReplicatorDecodeSubsystem::Deinitialize()
+{
+    // Running tasks finish their current batch and post into the orphaned queue, which dies with the last task.
+    CancelAllDecodes();
+    Completions.Reset();
+    Super::Deinitialize();
+}
+
+TStatId UAudioReplicatorDecodeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UAudioReplicatorDecodeSubsystem, STATGROUP_Tickables);
+}
+
+void UAudioReplicatorDecodeSubsystem::RunJob(const FJobRef& Job, const TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe>& Pool)
+{
+    FOpusDecodeResult& Result = Job->Result;
+    Result.SampleRate = Job->Header.SampleRate;
+    Result.Channels = Job->Header.Channels;
+
+    if (Job->bCancelled.load(std::memory_order_relaxed))
+        return;
+
+    // Sessions may open with elided silence; conceal it at the stream's frame length.
+    const int32 ConcealSamples = GetOpusFrameSamples(Job->Header.SampleRate, GetOpusFrameMsAt(Job->Header, 0));
+
+    TArray<FOpusPacketView> Views;
+    Job->Packets.GetViews(Views);
+
+    if (IsOpusCustom(Job->Header))
+    {
+        FOpusCustomDecoder Decoder;
+        if (!Decoder.InitFromHeader(Job->Header))
+            return;
+
+        Result.bSuccess = Job->bDecodeToFloat
+            ? DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.PcmFloat)
+            : DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.Pcm16);
+    }
+    else if (IsOpusProjection(Job->Header))
+    {
+        FOpusProjectionDecoder Decoder;
+        if (!Decoder.InitFromHeader(Job->Header, Job->Header.SampleRate))
+            return;
+        Decoder.SetConcealFrameSamples(ConcealSamples);
+
+        Result.bSuccess = Job->bDecodeToFloat
+            ? DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.PcmFloat)
+            : DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.Pcm16);
+    }
+    else if (IsOpusMultistream(Job->Header))
+    {
+        // Surround decoders are not pooled; one per job.
+        FOpusMultistreamDecoder Decoder;
+        if (!Decoder.InitFromHeader(Job->Header, Job->Header.SampleRate))
+            return;
+        Decoder.SetConcealFrameSamples(ConcealSamples);
+
+        Result.bSuccess = Job->bDecodeToFloat
+            ? DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.PcmFloat)
+            : DecodeMultistreamInBatches(Decoder, Views, Job->bCancelled, Result.Pcm16);
+    }
+    else
+    {
+        FOpusDecoderLease Decoder = Pool->AcquireDecoder(Job->Header.SampleRate, Job->Header.Channels);
+        if (!Decoder)
+            return;
+        Decoder->SetConcealFrameSamples(ConcealSamples);
+
+        Result.bSuccess = Job->bDecodeToFloat
+            ? DecodeInBatches(*Decoder, Views, Job->bCancelled, Result.PcmFloat)
+            : DecodeInBatches(*Decoder, Views, Job->bCancelled, Result.Pcm16);
+    }
+
+    if (Result.bSuccess)
+    {
+        TrimOpusDecodedPcm(Job->Header, Result.SampleRate, Result.Channels, Result.PcmFloat);
+        TrimOpusDecodedPcm(Job->Header, Result.SampleRate, Result.Channels, Result.Pcm16);
+    }
+
+    // The payload is no longer needed; free it on the worker rather than the game thread.
+    Job->Packets = FOpusPacketList();
+}
+
+int64 UAudioReplicatorDecodeSubsystem::SubmitDecode(const FOpusStreamHeader& Header, FOpusPacketList Packets, bool bDecodeToFloat, FOnOpusDecodeDone OnDone, const FGuid& SessionId)
+{
+    check(IsInGameThread());
+    if (!Completions.IsValid())
+        return 0;
+
+    // The pool is resolved here: subsystem lookups are game-thread only, the pool itself is thread-safe.
+    TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> Pool = UAudioReplicatorCodecPoolSubsystem::GetPool();
+    if (!Pool.IsValid())
+    {
+        Pool = MakeShared<FOpusCodecPool, ESPMode::ThreadSafe>(0);
+    }
+
+    const int64 JobId = NextJobId++;
+
+    FJobRef Job = MakeShared<FJob, ESPMode::ThreadSafe>();
+    Job->Header = Header;
+    Job->Packets = MoveTemp(Packets);
+    Job->bDecodeToFloat = bDecodeToFloat;
+    Job->OnDone = MoveTemp(OnDone);
+    Job->Result.JobId = JobId;
+    Job->Result.SessionId = SessionId;
+    Jobs.Add(JobId, Job);
+
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job, Pool, Queue = Completions]()
+    {
+        RunJob(Job, Pool);
+        Queue->Done.Enqueue(Job);
+    });
+
+    return JobId;
+}
+
+int64 UAudioReplicatorDecodeSubsystem::DecodeReceivedSessionAsync(UAudioReplicatorComponent* Source, const FGuid& SessionId)
+{
+    if (!Source)
+        return 0;
+
+    TArray<FOpusPacket> Packets;
+    FOpusStreamHeader Header;
+    if (!Source->GetReceivedPackets(SessionId, Packets, Header))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DecodeReceivedSessionAsync: unknown session %s"), *SessionId.ToString());
+        return 0;
+    }
+    if (!IsOpusCustom(Header))
+    {
+        Header.SampleRate = GetOpusDecodeSampleRate(Source->DecodeRate, Header.SampleRate);
+    }
+
+    const int64 JobId = SubmitDecode(Header, FOpusPacketList::FromPackets(Packets), true, FOnOpusDecodeDone(), SessionId);
+    if (FJobPtr* Job = Jobs.Find(JobId))
+    {
+        (*Job)->bNotifyBlueprint = true;
+    }
+    return JobId;
+}
+
+int64 UAudioReplicatorDecodeSubsystem::DecodePackedClipAsync(const TArray<uint8>& Packed, const FOpusStreamHeader& Header)
+{
+    FOpusStreamHeader ClipHeader = Header;
+    FOpusPacketList Packets;
+    if (!PackedClip::Unpack(MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(Packed), ClipHeader, Packets))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("DecodePackedClipAsync: malformed packed clip"));
+        return 0;
+    }
+
+    const int64 JobId = SubmitDecode(ClipHeader, MoveTemp(Packets), true, FOnOpusDecodeDone());
+    if (FJobPtr* Job = Jobs.Find(JobId))
+    {
+        (*Job)->bNotifyBlueprint = true;
+    }
+    return JobId;
+}
+
+bool UAudioReplicatorDecodeSubsystem::CancelDecode(int64 JobId)
+{
+    FJobPtr Job;
+    if (!Jobs.RemoveAndCopyValue(JobId, Job))
+        return false;
+
+    Job->bCancelled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void UAudioReplicatorDecodeSubsystem::CancelAllDecodes()
+{
+    for (const TPair<int64, FJobPtr>& KV : Jobs)
+    {
+        KV.Value->bCancelled.store(true, std::memory_order_relaxed);
+    }
+    Jobs.Empty();
+}
+
+void UAudioReplicatorDecodeSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!Completions.IsValid())
+        return;
+
+    const double Start = FPlatformTime::Seconds();
+    int32 Delivered = 0;
+
+    FJobPtr Job;
+    while (Completions->Done.Peek(Job))
+    {
+        if (MaxCompletionsPerFrame > 0 && Delivered >= MaxCompletionsPerFrame)
+            break;
+        if (CompletionBudgetMs > 0.0f && Delivered > 0 && (FPlatformTime::Seconds() - Start) * 1000.0 >= CompletionBudgetMs)
+            break;
+
+        Completions->Done.Pop();
+
+        // Cancelled jobs were already removed from Jobs; drop their results silently.
+        if (Job->bCancelled.load(std::memory_order_relaxed) || Jobs.Remove(Job->Result.JobId) == 0)
+            continue;
+
+        FOpusDecodeResult& Result = Job->Result;
+        Job->OnDone.ExecuteIfBound(Result);
+        if (Job->bNotifyBlueprint)
+        {
+            OnDecodeCompleted.Broadcast(Result.JobId, Result.SessionId, Result.bSuccess, Result.PcmFloat, Result.SampleRate);
+        }
+        ++Delivered;
+    }
+}
@@ -271,6 +271,17 @@ void UAudioReplicatorRegistrySubsystem::RegisterReplicator(UAudioReplicatorCompo
     CleanupExpiredSessionSenders();
     CleanupExpiredSubscriptions();
 
+    // Only the authority relays; on clients the flag is inert.
+    const AActor* HubOwner = Component->GetOwner();
+    if (Component->bRelayHub && HubOwner && HubOwner->HasAuthority())
+    {
+        if (RelayHub.IsValid() && RelayHub.Get() != Component)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("AudioReplicatorRegistry: more than one relay hub; using %s"), *Component->GetPathName());
+        }
+        RelayHub = Component;
+    }
+
     const TWeakObjectPtr<UAudioReplicatorComponent> Key(Component);
     if (ReplicatorOwners.Contains(Key))
     {
@@ -310,6 +321,11 @@ void UAudioReplicatorRegistrySubsystem::UnregisterReplicator(UAudioReplicatorCom
         return;
     }
 
+    if (RelayHub.Get() == Component)
+    {
+        RelayHub.Reset();
+    }
+
     const TWeakObjectPtr<UAudioReplicatorComponent> Key(Component);
     if (ReplicatorOwners.Remove(Key) > 0)
     {
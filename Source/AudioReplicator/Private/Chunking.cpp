@@ -1,5 +1,41 @@
 #include "Chunking.h"
 
+namespace
+{
+    // Single validation pass over a length-prefixed buffer: calls Visit(Offset, Length, Data) for every packet,
+    // in order, and fails on a truncated length or payload. Packets visited before a failure are not rolled back.
+    template <typename VisitorType>
+    bool ForEachPacket(TConstArrayView<uint8> Buffer, VisitorType&& Visit)
+    {
+        const uint8* Data = Buffer.GetData();
+        const int32 N = Buffer.Num();
+        int32 i = 0;
+
+        while (i + 2 <= N)
+        {
+            const int32 len = (int32)(Data[i] | (Data[i + 1] << 8));
+            i += 2;
+
+            if (i + len > N)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("UnpackWithLengths: truncated buffer (need %d, have %d)"), len, N - i);
+                return false;
+            }
+
+            Visit(i, len, Data);
+            i += len;
+        }
+
+        if (i != N)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("UnpackWithLengths: trailing bytes (%d)"), N - i);
+            return false;
+        }
+
+        return true;
+    }
+}
+
 namespace Chunking
 {
     void PackWithLengths(const TArray<FOpusPacket>& Packets, TArray<uint8>& OutBuffer)
@@ -36,35 +72,72 @@ namespace Chunking
     bool UnpackWithLengths(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets)
     {
         OutPackets.Reset();
-        const int32 N = Buffer.Num();
-        int32 i = 0;
-
-        while (i + 2 <= N)
+        return ForEachPacket(Buffer, [&OutPackets](int32 Offset, int32 Length, const uint8* Data)
         {
-            const uint16 len = (uint16)(Buffer[i] | (Buffer[i + 1] << 8));
-            i += 2;
+            FOpusPacket& Pkt = OutPackets.AddDefaulted_GetRef();
+            Pkt.Data.Append(Data + Offset, Length);
+        });
+    }
+
+    void PackWithLengths(const FOpusPacketList& Packets, TArray<uint8>& OutBuffer)
+    {
+        OutBuffer.Reset();
+        OutBuffer.Reserve(Packets.Num() * 2 + Packets.GetTotalBytes());
 
-            if (i + (int32)len > N)
+        for (int32 Index = 0; Index < Packets.Num(); ++Index)
+        {
+            const FOpusPacketView P = Packets.GetPacket(Index);
+            const int32 n = P.Num();
+            if (n > 65535)
             {
-                UE_LOG(LogTemp, Warning, TEXT("UnpackWithLengths: truncated buffer (need %d, have %d)"), (int32)len, N - i);
-                return false;
+                UE_LOG(LogTemp, Warning, TEXT("PackWithLengths: packet too large (%d bytes)"), n);
+                continue;
             }
 
-            FOpusPacket pkt;
-            if (len > 0)
+            OutBuffer.Add((uint8)(n & 0xFF));
+            OutBuffer.Add((uint8)((n >> 8) & 0xFF));
+
+            if (n > 0)
             {
-                pkt.Data.Append(Buffer.GetData() + i, (int32)len);
-                i += (int32)len;
+                OutBuffer.Append(P.GetData(), n);
             }
-            OutPackets.Add(MoveTemp(pkt));
         }
+    }
 
-        if (i != N)
+    bool UnpackWithLengths(const TArray<uint8>& Buffer, FOpusPacketList& OutPackets)
+    {
+        OutPackets.Reset();
+
+        // Payload bytes never exceed the buffer size, so the byte store is allocated once.
+        OutPackets.Reserve(0, Buffer.Num());
+
+        return ForEachPacket(Buffer, [&OutPackets](int32 Offset, int32 Length, const uint8* Data)
         {
-            UE_LOG(LogTemp, Warning, TEXT("UnpackWithLengths: trailing bytes (%d)"), N - i);
-            return false;
+            OutPackets.Add(FOpusPacketView(Data + Offset, Length));
+        });
+    }
+
+    bool UnpackWithLengths(const FOpusPacketList::FSharedBuffer& Buffer, FOpusPacketList& OutPackets)
+    {
+        OutPackets.ResetShared(Buffer);
+        const bool bOk = ForEachPacket(*Buffer, [&OutPackets](int32 Offset, int32 Length, const uint8*)
+        {
+            OutPackets.AddShared(Offset, Length);
+        });
+
+        if (!bOk)
+        {
+            OutPackets.Reset();
         }
+        return bOk;
+    }
 
-        return true;
+    bool UnpackViews(TConstArrayView<uint8> Buffer, TArray<FOpusPacketView>& OutViews)
+    {
+        OutViews.Reset();
+        return ForEachPacket(Buffer, [&OutViews](int32 Offset, int32 Length, const uint8* Data)
+        {
+            OutViews.Add(FOpusPacketView(Data + Offset, Length));
+        });
     }
 }
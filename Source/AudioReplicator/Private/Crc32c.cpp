@@ -0,0 +1,153 @@
+#include "Crc32c.h"
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS
+    #define CRC32C_X86 1
+    #include <nmmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_64BITS && (defined(__ARM_FEATURE_CRC32) || PLATFORM_LINUX)
+    #define CRC32C_ARM 1
+    #include <arm_acle.h>
+    #if PLATFORM_LINUX
+        #include <sys/auxv.h>
+        #include <asm/hwcap.h>
+    #endif
+#endif
+
+// Lets clang/gcc emit the instructions in a single function without raising the whole module's target.
+#if defined(__clang__) || defined(__GNUC__)
+    #define CRC32C_TARGET(Feature) __attribute__((target(Feature)))
+#else
+    #define CRC32C_TARGET(Feature)
+#endif
+
+// The spelling of the AArch64 CRC extension differs: clang takes "crc", GCC "+crc". Not needed at all when the
+// whole module already targets it.
+#if defined(__ARM_FEATURE_CRC32)
+    #define CRC32C_TARGET_ARM
+#elif defined(__clang__)
+    #define CRC32C_TARGET_ARM CRC32C_TARGET("crc")
+#else
+    #define CRC32C_TARGET_ARM CRC32C_TARGET("+crc")
+#endif
+
+namespace
+{
+    constexpr uint32 Polynomial = 0x82F63B78u; // reflected 0x1EDC6F41
+
+    struct FCrcTable
+    {
+        uint32 Entries[256];
+
+        FCrcTable()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                uint32 Crc = i;
+                for (int32 Bit = 0; Bit < 8; ++Bit)
+                {
+                    Crc = (Crc >> 1) ^ ((Crc & 1) ? Polynomial : 0);
+                }
+                Entries[i] = Crc;
+            }
+        }
+    };
+
+    uint32 ComputeTable(const uint8* Data, int64 NumBytes, uint32 Crc)
+    {
+        static const FCrcTable Table;
+        for (int64 i = 0; i < NumBytes; ++i)
+        {
+            Crc = Table.Entries[(Crc ^ Data[i]) & 0xFF] ^ (Crc >> 8);
+        }
+        return Crc;
+    }
+
+#if CRC32C_X86
+    CRC32C_TARGET("sse4.2")
+    uint32 ComputeHardware(const uint8* Data, int64 NumBytes, uint32 Crc)
+    {
+        uint64 Crc64 = Crc;
+        for (; NumBytes >= 8; NumBytes -= 8, Data += 8)
+        {
+            uint64 Word;
+            FMemory::Memcpy(&Word, Data, sizeof(Word));
+            Crc64 = _mm_crc32_u64(Crc64, Word);
+        }
+        Crc = (uint32)Crc64;
+        for (; NumBytes > 0; --NumBytes, ++Data)
+        {
+            Crc = _mm_crc32_u8(Crc, *Data);
+        }
+        return Crc;
+    }
+
+    bool DetectHardware()
+    {
+        // CPUID leaf 1, ECX bit 20: SSE4.2.
+#if defined(_MSC_VER)
+        int Info[4] = {};
+        __cpuid(Info, 1);
+        return (Info[2] & (1 << 20)) != 0;
+#else
+        unsigned int Eax = 0, Ebx = 0, Ecx = 0, Edx = 0;
+        return __get_cpuid(1, &Eax, &Ebx, &Ecx, &Edx) && (Ecx & (1u << 20)) != 0;
+#endif
+    }
+#elif CRC32C_ARM
+    CRC32C_TARGET_ARM
+    uint32 ComputeHardware(const uint8* Data, int64 NumBytes, uint32 Crc)
+    {
+        for (; NumBytes >= 8; NumBytes -= 8, Data += 8)
+        {
+            uint64 Word;
+            FMemory::Memcpy(&Word, Data, sizeof(Word));
+            Crc = __crc32cd(Crc, Word);
+        }
+        for (; NumBytes > 0; --NumBytes, ++Data)
+        {
+            Crc = __crc32cb(Crc, *Data);
+        }
+        return Crc;
+    }
+
+    bool DetectHardware()
+    {
+#if defined(__ARM_FEATURE_CRC32)
+        return true;
+#else
+        return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+    }
+#else
+    uint32 ComputeHardware(const uint8* Data, int64 NumBytes, uint32 Crc)
+    {
+        return ComputeTable(Data, NumBytes, Crc);
+    }
+
+    bool DetectHardware()
+    {
+        return false;
+    }
+#endif
+}
+
+namespace Crc32c
+{
+    bool IsHardwareAccelerated()
+    {
+        static const bool bHardware = DetectHardware();
+        return bHardware;
+    }
+
+    uint32 Compute(const void* Data, int64 NumBytes, uint32 Crc)
+    {
+        const uint8* Bytes = static_cast<const uint8*>(Data);
+        Crc = ~Crc;
+        Crc = IsHardwareAccelerated() ? ComputeHardware(Bytes, NumBytes, Crc) : ComputeTable(Bytes, NumBytes, Crc);
+        return ~Crc;
+    }
+}
@@ -0,0 +1,41 @@
+#include "MappedFile.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+
+FMappedFileView::FMappedFileView() = default;
+
+FMappedFileView::~FMappedFileView()
+{
+    Close();
+}
+
+bool FMappedFileView::Open(const FString& FullPath)
+{
+    Close();
+
+    Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FullPath));
+    if (!Handle.IsValid() || Handle->GetFileSize() <= 0)
+    {
+        Handle.Reset();
+        return false;
+    }
+
+    Region.Reset(Handle->MapRegion(0, Handle->GetFileSize()));
+    if (!Region.IsValid() || Region->GetMappedPtr() == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    Data = Region->GetMappedPtr();
+    Size = Region->GetMappedSize();
+    return true;
+}
+
+void FMappedFileView::Close()
+{
+    Region.Reset();
+    Handle.Reset();
+    Data = nullptr;
+    Size = 0;
+}
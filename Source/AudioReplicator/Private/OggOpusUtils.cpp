@@ -0,0 +1,608 @@
+#include "OggOpusUtils.h"
+#include "OpusCodec.h"
+#include "OpusPacketList.h"
+#include "PcmWavUtils.h"
+#include "MappedFile.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include <opus.h> // ThirdParty/Opus/Include
+
+// Ogg Opus (RFC 3533 pages carrying an RFC 7845 Opus stream).
+//
+// Writer: one logical stream, OpusHead and OpusTags on their own pages, audio pages flushed when the 255-entry
+// segment table fills up or a page holds a second of audio. Granule positions count decoded 48 kHz samples from 0,
+// whatever rate the packets were encoded at; the pre-skip is part of those samples, not added on top.
+//
+// Reader: walks pages, verifies each page CRC, follows the first logical stream whose BOS page starts with
+// OpusHead and reassembles packets that span pages. Other logical streams (e.g. a multiplexed video track) are
+// skipped; chained streams after the first EOS are ignored.
+
+namespace
+{
+    constexpr int32 OggRate = 48000; // granule positions and pre-skip are always 48 kHz
+    constexpr int32 PageHeaderBytes = 27;
+    constexpr int32 MaxSegments = 255;
+    constexpr int64 MaxPageSamples = OggRate; // flush audio pages after about a second
+
+    enum EPageFlags : uint8
+    {
+        PageContinued = 0x01,
+        PageBos = 0x02,
+        PageEos = 0x04,
+    };
+
+    const TCHAR* const VendorString = TEXT("AudioReplicator");
+
+    // Ogg's CRC32: polynomial 0x04C11DB7, not reflected, zero initial value and no final xor.
+    struct FOggCrcTable
+    {
+        uint32 Entries[256];
+
+        FOggCrcTable()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                uint32 Crc = i << 24;
+                for (int32 Bit = 0; Bit < 8; ++Bit)
+                {
+                    Crc = (Crc & 0x80000000u) ? (Crc << 1) ^ 0x04C11DB7u : (Crc << 1);
+                }
+                Entries[i] = Crc;
+            }
+        }
+    };
+
+    uint32 OggCrc(const uint8* Data, int64 NumBytes, uint32 Crc = 0)
+    {
+        static const FOggCrcTable Table;
+        for (int64 i = 0; i < NumBytes; ++i)
+        {
+            Crc = (Crc << 8) ^ Table.Entries[((Crc >> 24) ^ Data[i]) & 0xFF];
+        }
+        return Crc;
+    }
+
+    inline uint16 ReadU16LE(const uint8* p) { return (uint16)(p[0] | (p[1] << 8)); }
+    inline uint32 ReadU32LE(const uint8* p) { return (uint32)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32)p[3] << 24)); }
+    inline int64 ReadI64LE(const uint8* p) { return (int64)((uint64)ReadU32LE(p) | ((uint64)ReadU32LE(p + 4) << 32)); }
+
+    inline void WriteU16LE(TArray<uint8>& Out, uint16 v)
+    {
+        Out.Add((uint8)(v & 0xFF));
+        Out.Add((uint8)((v >> 8) & 0xFF));
+    }
+    inline void WriteU32LE(TArray<uint8>& Out, uint32 v)
+    {
+        WriteU16LE(Out, (uint16)(v & 0xFFFF));
+        WriteU16LE(Out, (uint16)(v >> 16));
+    }
+    inline void WriteI64LE(TArray<uint8>& Out, int64 v)
+    {
+        WriteU32LE(Out, (uint32)((uint64)v & 0xFFFFFFFFu));
+        WriteU32LE(Out, (uint32)((uint64)v >> 32));
+    }
+
+    inline bool MatchTag(FOpusPacketView Packet, const char (&Tag)[9])
+    {
+        return Packet.Num() >= 8 && FMemory::Memcmp(Packet.GetData(), Tag, 8) == 0;
+    }
+
+    // Builds pages for one logical stream. Packets longer than a page continue on the next one.
+    class FPageWriter
+    {
+    public:
+        FPageWriter(TArray<uint8>& InOut, uint32 InSerial) : Out(InOut), Serial(InSerial) {}
+
+        // EndGranule: granule position once this packet has been decoded.
+        void AddPacket(FOpusPacketView Packet, int64 EndGranule)
+        {
+            if (Lacing.Num() > 0 && Lacing.Num() + Packet.Num() / 255 + 1 > MaxSegments)
+            {
+                Flush(false);
+            }
+
+            const uint8* Data = Packet.GetData();
+            int32 Remaining = Packet.Num();
+            for (;;)
+            {
+                while (Lacing.Num() < MaxSegments)
+                {
+                    const int32 Segment = FMath::Min(Remaining, 255);
+                    Lacing.Add((uint8)Segment);
+                    Body.Append(Data, Segment);
+                    Data += Segment;
+                    Remaining -= Segment;
+                    if (Segment < 255)
+                    {
+                        Granule = EndGranule;
+                        return;
+                    }
+                }
+                Flush(false);
+            }
+        }
+
+        int32 GetPendingSegments() const { return Lacing.Num(); }
+
+        void Flush(bool bEndOfStream)
+        {
+            const int32 Start = Out.Num();
+            Out.Append((const uint8*)"OggS", 4);
+            Out.Add(0); // stream structure version
+            Out.Add((uint8)((bContinued ? PageContinued : 0) | (bFirstPage ? PageBos : 0) | (bEndOfStream ? PageEos : 0)));
+            WriteI64LE(Out, Granule);
+            WriteU32LE(Out, Serial);
+            WriteU32LE(Out, Sequence++);
+            WriteU32LE(Out, 0); // CRC, patched below
+            Out.Add((uint8)Lacing.Num());
+            Out.Append(Lacing);
+            Out.Append(Body);
+
+            const uint32 Crc = OggCrc(Out.GetData() + Start, Out.Num() - Start);
+            for (int32 i = 0; i < 4; ++i)
+            {
+                Out[Start + 22 + i] = (uint8)(Crc >> (8 * i));
+            }
+
+            // A page ending in a 255 lace leaves its last packet open.
+            bContinued = Lacing.Num() > 0 && Lacing.Last() == 255;
+            bFirstPage = false;
+            Granule = -1; // no packet completed yet on the next page
+            Lacing.Reset();
+            Body.Reset();
+        }
+
+    private:
+        TArray<uint8>& Out;
+        uint32 Serial = 0;
+        uint32 Sequence = 0;
+        int64 Granule = -1;
+        bool bFirstPage = true;
+        bool bContinued = false;
+        TArray<uint8> Lacing;
+        TArray<uint8> Body;
+    };
+
+    // Stand-in for an empty packet: a CBR code 3 packet of Frames zero-length frames per stream, which decoders
+    // conceal, so a gap in a multi-frame stream keeps its full duration. Every stream but the last uses
+    // self-delimited framing, i.e. carries an explicit zero frame length byte.
+    void MakeLostPacket(uint8 Toc, int32 Frames, int32 Streams, TArray<uint8>& Out)
+    {
+        const uint8 Code3Toc = (Toc & 0xFC) | 3;
+        const uint8 FrameCount = (uint8)FMath::Clamp(Frames, 1, 48);
+        Out.Reset();
+        for (int32 s = 0; s < Streams - 1; ++s)
+        {
+            Out.Add(Code3Toc);
+            Out.Add(FrameCount);
+            Out.Add(0);
+        }
+        Out.Add(Code3Toc);
+        Out.Add(FrameCount);
+    }
+
+    bool ParseOpusHead(FOpusPacketView Packet, FOpusStreamHeader& OutHeader)
+    {
+        const uint8* p = Packet.GetData();
+        if (Packet.Num() < 19 || (p[8] >> 4) != 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: bad OpusHead (%d bytes, version %d)"), Packet.Num(), Packet.Num() > 8 ? p[8] : -1);
+            return false;
+        }
+
+        FOpusStreamHeader Header;
+        Header.SampleRate = OggRate;
+        Header.Channels = p[9];
+        Header.PreSkip = ReadU16LE(p + 10);
+        const uint32 InputRate = ReadU32LE(p + 12);
+        Header.SourceSampleRate = (InputRate != 0 && InputRate != (uint32)OggRate) ? (int32)FMath::Min<uint32>(InputRate, MAX_int32) : 0;
+        Header.MappingFamily = p[18];
+
+        if (Header.MappingFamily == 0)
+        {
+            if (Header.Channels < 1 || Header.Channels > 2)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: mapping family 0 with %d channels"), Header.Channels);
+                return false;
+            }
+            OutHeader = MoveTemp(Header);
+            return true;
+        }
+
+        if (Packet.Num() < 21 || Header.Channels < 1)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: truncated channel mapping table"));
+            return false;
+        }
+        Header.Streams = p[19];
+        Header.CoupledStreams = p[20];
+        if (Header.Streams < 1 || Header.CoupledStreams > Header.Streams)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: bad stream counts %d/%d"), Header.Streams, Header.CoupledStreams);
+            return false;
+        }
+
+        // Family 3 replaces the mapping with a demixing matrix (RFC 8486): 16-bit gains, output channels x coded channels.
+        const int32 TableBytes = (Header.MappingFamily == 3)
+            ? 2 * Header.Channels * (Header.Streams + Header.CoupledStreams)
+            : Header.Channels;
+        if (Packet.Num() < 21 + TableBytes)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: truncated channel mapping table"));
+            return false;
+        }
+        TArray<uint8>& Table = (Header.MappingFamily == 3) ? Header.DemixingMatrix : Header.ChannelMapping;
+        Table.Append(p + 21, TableBytes);
+
+        OutHeader = MoveTemp(Header);
+        return true;
+    }
+
+    void WriteOpusHead(const FOpusStreamHeader& Header, int32 PreSkip, TArray<uint8>& Out)
+    {
+        Out.Append((const uint8*)"OpusHead", 8);
+        Out.Add(1); // version
+        Out.Add((uint8)Header.Channels);
+        WriteU16LE(Out, (uint16)PreSkip);
+        WriteU32LE(Out, (uint32)(Header.SourceSampleRate > 0 ? Header.SourceSampleRate : Header.SampleRate));
+        WriteU16LE(Out, 0); // output gain
+        if (!IsOpusMultistream(Header))
+        {
+            Out.Add(0);
+            return;
+        }
+
+        const bool bProjection = IsOpusProjection(Header);
+        Out.Add((uint8)(bProjection ? 3 : (Header.MappingFamily > 0 ? Header.MappingFamily : 1)));
+        Out.Add((uint8)Header.Streams);
+        Out.Add((uint8)Header.CoupledStreams);
+        Out.Append(bProjection ? Header.DemixingMatrix : Header.ChannelMapping);
+    }
+
+    void WriteOpusTags(TArray<uint8>& Out)
+    {
+        const FTCHARToUTF8 Vendor(VendorString);
+        Out.Append((const uint8*)"OpusTags", 8);
+        WriteU32LE(Out, (uint32)Vendor.Length());
+        Out.Append((const uint8*)Vendor.Get(), Vendor.Length());
+        WriteU32LE(Out, 0); // no user comments
+    }
+}
+
+namespace OggOpus
+{
+    int32 GetDefaultPreSkip(const FOpusStreamHeader& Header)
+    {
+        const bool bLowDelay = FOpusEncoderProfileSettings::Get(Header.Profile).Application == EOpusApplication::RestrictedLowDelay;
+        return bLowDelay ? OggRate / 400 : OggRate / 400 + OggRate / 250;
+    }
+
+    bool WriteToMemory(const FOpusStreamHeader& Header, const FOpusPacketList& Packets, TArray<uint8>& OutBytes, int32 PreSkip)
+    {
+        OutBytes.Reset();
+        if (IsOpusCustom(Header))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: Opus Custom streams cannot be stored as Ogg Opus"));
+            return false;
+        }
+        const bool bLayoutOk = IsOpusMultistream(Header)
+            ? (Header.Channels >= 1 && Header.Channels <= 255 && Header.Streams <= 255
+                && (IsOpusProjection(Header) ? Header.DemixingMatrix.Num() > 0 : Header.ChannelMapping.Num() == Header.Channels))
+            : (Header.Channels == 1 || Header.Channels == 2);
+        if (!bLayoutOk)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: unsupported layout (%d ch, %d streams)"), Header.Channels, Header.Streams);
+            return false;
+        }
+
+        // Empty packets borrow the TOC of the first real one for their configuration and frame size.
+        int32 FirstReal = 0;
+        while (FirstReal < Packets.Num() && Packets.GetLength(FirstReal) == 0)
+        {
+            ++FirstReal;
+        }
+        if (FirstReal == Packets.Num())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: no audio packets"));
+            return false;
+        }
+
+        if (PreSkip == INDEX_NONE)
+        {
+            PreSkip = (Header.PreSkip > 0) ? Header.PreSkip : GetDefaultPreSkip(Header);
+        }
+        PreSkip = FMath::Clamp(PreSkip, 0, 65535);
+        const int32 Streams = FMath::Max(1, Header.Streams);
+
+        OutBytes.Reserve(Packets.GetTotalBytes() + Packets.Num() + (Packets.Num() / 50 + 4) * (PageHeaderBytes + MaxSegments));
+        FPageWriter Writer(OutBytes, FGuid::NewGuid().A);
+
+        TArray<uint8> Scratch;
+        WriteOpusHead(Header, PreSkip, Scratch);
+        Writer.AddPacket(Scratch, 0);
+        Writer.Flush(false);
+
+        Scratch.Reset();
+        WriteOpusTags(Scratch);
+        Writer.AddPacket(Scratch, 0);
+        Writer.Flush(false);
+
+        uint8 LastToc = Packets.GetPacket(FirstReal)[0];
+        int32 LastFrames = opus_packet_get_nb_frames(Packets.GetPacket(FirstReal).GetData(), Packets.GetLength(FirstReal));
+        int64 Granule = 0;
+        int64 PageStartGranule = Granule;
+        for (int32 i = 0; i < Packets.Num(); ++i)
+        {
+            FOpusPacketView Packet = Packets.GetPacket(i);
+            if (Packet.Num() == 0)
+            {
+                MakeLostPacket(LastToc, LastFrames, Streams, Scratch);
+                Packet = Scratch;
+            }
+            else
+            {
+                LastToc = Packet[0];
+                LastFrames = opus_packet_get_nb_frames(Packet.GetData(), Packet.Num());
+            }
+
+            const int32 Samples = opus_packet_get_nb_samples(Packet.GetData(), Packet.Num(), OggRate);
+            if (Samples <= 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: packet %d is not a valid Opus packet"), i);
+                OutBytes.Reset();
+                return false;
+            }
+
+            if (Granule - PageStartGranule >= MaxPageSamples && Writer.GetPendingSegments() > 0)
+            {
+                Writer.Flush(false);
+                PageStartGranule = Granule;
+            }
+            Granule += Samples;
+            // The final granule position marks where playback ends; Header.EndTrim cuts into the last packet.
+            const int64 EndGranule = (i == Packets.Num() - 1) ? Granule - FMath::Clamp(Header.EndTrim, 0, Samples) : Granule;
+            Writer.AddPacket(Packet, EndGranule);
+        }
+        Writer.Flush(true);
+        return true;
+    }
+
+    bool ReadFromMemory(TConstArrayView<uint8> Bytes, FOpusStreamHeader& OutHeader, FOpusPacketList& OutPackets)
+    {
+        OutPackets.Reset();
+
+        const uint8* Data = Bytes.GetData();
+        const int64 Size = Bytes.Num();
+
+        FOpusStreamHeader Header;
+        bool bHaveStream = false;
+        bool bEnded = false;
+        uint32 Serial = 0;
+        int32 NumStreamPackets = 0; // OpusHead and OpusTags included
+        TArray<uint8> Pending;      // packet continued from an earlier page
+        bool bPendingOpen = false;
+        int64 LastGranule = -1;     // of the last page that completed a packet
+        int64 StreamStart = -1;     // granule position of the first decoded sample, from the first audio page
+
+        auto HandlePacket = [&](FOpusPacketView Packet) -> bool
+        {
+            const int32 Index = NumStreamPackets++;
+            if (Index == 0)
+                return true; // OpusHead, parsed with the BOS page
+            if (Index == 1)
+            {
+                if (!MatchTag(Packet, "OpusTags"))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("OggOpus: missing OpusTags"));
+                    return false;
+                }
+                return true;
+            }
+            OutPackets.Add(Packet);
+            return true;
+        };
+
+        int64 Pos = 0;
+        while (Pos < Size && !bEnded)
+        {
+            const uint8* Page = Data + Pos;
+            if (Size - Pos < PageHeaderBytes || FMemory::Memcmp(Page, "OggS", 4) != 0 || Page[4] != 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: bad page at byte %lld"), Pos);
+                return false;
+            }
+
+            const int32 NumSegments = Page[26];
+            if (Size - Pos < PageHeaderBytes + NumSegments)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: truncated page at byte %lld"), Pos);
+                return false;
+            }
+            const uint8* Lacing = Page + PageHeaderBytes;
+            int64 BodyBytes = 0;
+            for (int32 s = 0; s < NumSegments; ++s)
+            {
+                BodyBytes += Lacing[s];
+            }
+            const int64 PageBytes = PageHeaderBytes + NumSegments + BodyBytes;
+            if (Size - Pos < PageBytes)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: truncated page at byte %lld"), Pos);
+                return false;
+            }
+
+            // The CRC covers the whole page with its own field zeroed.
+            const uint8 ZeroCrc[4] = { 0, 0, 0, 0 };
+            uint32 Crc = OggCrc(Page, 22);
+            Crc = OggCrc(ZeroCrc, 4, Crc);
+            Crc = OggCrc(Page + 26, PageBytes - 26, Crc);
+            if (Crc != ReadU32LE(Page + 22))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: page CRC mismatch at byte %lld"), Pos);
+                return false;
+            }
+
+            const uint8 Flags = Page[5];
+            const uint32 PageSerial = ReadU32LE(Page + 14);
+            const uint8* Body = Lacing + NumSegments;
+            Pos += PageBytes;
+
+            if (!bHaveStream)
+            {
+                // Lock onto the first logical stream that starts with OpusHead.
+                const int32 FirstPacketBytes = (NumSegments > 0) ? FMath::Min<int32>(Lacing[0], (int32)BodyBytes) : 0;
+                if (!(Flags & PageBos) || !MatchTag(FOpusPacketView(Body, FirstPacketBytes), "OpusHead"))
+                    continue;
+                if (NumSegments < 1 || Lacing[0] == 255 || !ParseOpusHead(FOpusPacketView(Body, Lacing[0]), Header))
+                    return false;
+                bHaveStream = true;
+                Serial = PageSerial;
+            }
+            else if (PageSerial != Serial)
+            {
+                continue;
+            }
+
+            const int32 PagePacketsStart = OutPackets.Num();
+            if (bPendingOpen != ((Flags & PageContinued) != 0))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: broken packet continuation at byte %lld"), Pos - PageBytes);
+                return false;
+            }
+
+            int64 SegmentStart = 0;
+            int64 Offset = 0;
+            for (int32 s = 0; s < NumSegments; ++s)
+            {
+                Offset += Lacing[s];
+                if (Lacing[s] == 255)
+                    continue;
+
+                // Packet complete: either entirely on this page or the tail of a continued one.
+                const FOpusPacketView Tail(Body + SegmentStart, (int32)(Offset - SegmentStart));
+                bool bOk;
+                if (bPendingOpen)
+                {
+                    Pending.Append(Tail.GetData(), Tail.Num());
+                    bOk = HandlePacket(Pending);
+                    Pending.Reset();
+                    bPendingOpen = false;
+                }
+                else
+                {
+                    bOk = HandlePacket(Tail);
+                }
+                if (!bOk)
+                    return false;
+                SegmentStart = Offset;
+            }
+            if (SegmentStart < BodyBytes)
+            {
+                Pending.Append(Body + SegmentStart, (int32)(BodyBytes - SegmentStart));
+                bPendingOpen = true;
+            }
+
+            bEnded = (Flags & PageEos) != 0;
+            const int64 PageGranule = ReadI64LE(Page + 6);
+            if (PageGranule != -1)
+            {
+                LastGranule = PageGranule;
+            }
+            if (StreamStart < 0 && PageGranule != -1 && OutPackets.Num() > PagePacketsStart)
+            {
+                // RFC 7845 4: the first audio page's granule less the samples completed on it gives the start
+                // offset (normally 0). A first page that also ends the stream may be end-trimmed instead.
+                int64 PageSamples = 0;
+                for (int32 i = PagePacketsStart; i < OutPackets.Num(); ++i)
+                {
+                    const FOpusPacketView Packet = OutPackets.GetPacket(i);
+                    PageSamples += FMath::Max(0, opus_packet_get_nb_samples(Packet.GetData(), Packet.Num(), OggRate));
+                }
+                StreamStart = bEnded ? 0 : FMath::Max<int64>(0, PageGranule - PageSamples);
+            }
+        }
+
+        if (!bHaveStream || NumStreamPackets < 2)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("OggOpus: no Opus stream found"));
+            return false;
+        }
+
+        // Frame size and bitrate are not part of OpusHead; take them from the packets themselves.
+        int64 TotalSamples = 0;
+        for (int32 i = 0; i < OutPackets.Num(); ++i)
+        {
+            const FOpusPacketView Packet = OutPackets.GetPacket(i);
+            const int32 Samples = opus_packet_get_nb_samples(Packet.GetData(), Packet.Num(), OggRate);
+            const int32 Frames = opus_packet_get_nb_frames(Packet.GetData(), Packet.Num());
+            if (Samples <= 0 || Frames <= 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OggOpus: packet %d is not a valid Opus packet"), i);
+                OutPackets.Reset();
+                return false;
+            }
+            if (i == 0)
+            {
+                Header.FrameMs = opus_packet_get_samples_per_frame(Packet.GetData(), OggRate) * 1000.0f / OggRate;
+            }
+            Header.FramesPerPacket = FMath::Max(Header.FramesPerPacket, Frames);
+            TotalSamples += Samples;
+        }
+        Header.NumPackets = OutPackets.Num();
+        if (TotalSamples > 0)
+        {
+            Header.Bitrate = (int32)FMath::Min<int64>((int64)OutPackets.GetTotalBytes() * 8 * OggRate / TotalSamples, MAX_int32);
+        }
+
+        // The final granule position counts decoded samples (pre-skip included) from the stream start, and may end
+        // before the last packet does.
+        if (StreamStart >= 0 && LastGranule >= StreamStart)
+        {
+            const int64 PlayedSamples = LastGranule - StreamStart;
+            if (PlayedSamples >= Header.PreSkip && PlayedSamples < TotalSamples)
+            {
+                Header.EndTrim = (int32)(TotalSamples - PlayedSamples);
+            }
+        }
+
+        OutHeader = MoveTemp(Header);
+        return true;
+    }
+
+    bool SaveOggOpusFile(const FString& InPath, const FOpusStreamHeader& Header, const FOpusPacketList& Packets, int32 PreSkip)
+    {
+        TArray<uint8> Bytes;
+        if (!WriteToMemory(Header, Packets, Bytes, PreSkip))
+            return false;
+
+        const FString FullPath = PcmWav::ResolveProjectPath_V3(InPath);
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), /*Tree=*/true);
+        if (!FFileHelper::SaveArrayToFile(Bytes, *FullPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("SaveOggOpusFile: failed to save %s"), *FullPath);
+            return false;
+        }
+        return true;
+    }
+
+    bool LoadOggOpusFile(const FString& InPath, FOpusStreamHeader& OutHeader, FOpusPacketList& OutPackets)
+    {
+        const FString Path = PcmWav::ResolveProjectPath_V3(InPath);
+
+        // Pages are parsed over a mapping of the file; only the packets are copied out.
+        FMappedFileView Mapping;
+        if (Mapping.Open(Path) && Mapping.GetSize() <= MAX_int32)
+        {
+            return ReadFromMemory(TConstArrayView<uint8>(Mapping.GetData(), (int32)Mapping.GetSize()), OutHeader, OutPackets);
+        }
+
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadOggOpusFile: read failed: %s"), *Path);
+            return false;
+        }
+        return ReadFromMemory(Bytes, OutHeader, OutPackets);
+    }
+}
@@ -1,52 +1,532 @@
 #include "OpusCodec.h"
+#include "OpusStateArena.h"
+#include "OpusPacketList.h"
 #include <opus.h> // ThirdParty/Opus/Include
 
 namespace
 {
     constexpr int32 MaxPacketSize = 4000; //     
+
+    static_assert((int32)EOpusApplication::Voip == OPUS_APPLICATION_VOIP, "EOpusApplication must mirror opus_defines.h");
+    static_assert((int32)EOpusApplication::Audio == OPUS_APPLICATION_AUDIO, "EOpusApplication must mirror opus_defines.h");
+    static_assert((int32)EOpusApplication::RestrictedLowDelay == OPUS_APPLICATION_RESTRICTED_LOWDELAY, "EOpusApplication must mirror opus_defines.h");
+    static_assert(OPUS_AUTO == -1000, "FOpusEncoderProfileSettings::Signal defaults to OPUS_AUTO");
+
+    // Legacy Application-only initialisation: default profile settings with the caller's application.
+    FOpusEncoderProfileSettings MakeDefaultSettings(EOpusApplication Application)
+    {
+        FOpusEncoderProfileSettings Settings = FOpusEncoderProfileSettings::Get(EOpusEncoderProfile::Default);
+        Settings.Application = Application;
+        return Settings;
+    }
+
+    // Sample-format dispatch so the int16 and float paths share one implementation.
+    inline int EncodeFrame(OpusEncoder* Enc, const int16* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_encode(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int EncodeFrame(OpusEncoder* Enc, const float* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_encode_float(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int DecodeFrame(OpusDecoder* Dec, const uint8* Data, int32 Len, int16* Out, int FrameSize)
+    {
+        return opus_decode(Dec, Data, Len, Out, FrameSize, 0);
+    }
+    inline int DecodeFrame(OpusDecoder* Dec, const uint8* Data, int32 Len, float* Out, int FrameSize)
+    {
+        return opus_decode_float(Dec, Data, Len, Out, FrameSize, 0);
+    }
+
+    template <typename SampleType>
+    bool AppendEncodedFrame(OpusEncoder* Encoder, int32 Ch, TConstArrayView<SampleType> FramePcm, FOpusPacketList& OutPackets)
+    {
+        const int32 FrameSizeSamplesPerCh = FramePcm.Num() / Ch;
+        if (!Encoder || FrameSizeSamplesPerCh <= 0 || FramePcm.Num() % Ch != 0) return false;
+
+        uint8* Dest = OutPackets.BeginPacket(MaxPacketSize);
+        const int EncBytes = EncodeFrame(Encoder, FramePcm.GetData(), FrameSizeSamplesPerCh, Dest, MaxPacketSize);
+        OutPackets.CommitPacket(FMath::Max(EncBytes, 0));
+        if (EncBytes < 0)
+        {
+            // Drop the empty placeholder so a failed frame never reaches the wire.
+            OutPackets.RemoveLast();
+            return false;
+        }
+        return true;
+    }
+
+    template <typename SampleType>
+    bool EncodeToPacketList(OpusEncoder* Encoder, int32 SR, int32 Ch, int32 Bitrate,
+        TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+    {
+        OutPackets.Reset();
+        if (!Encoder || FrameSizeSamplesPerCh <= 0) return false;
+
+        const int32 SamplesPerFrameTotal = FrameSizeSamplesPerCh * Ch;
+        const int32 NumFrames = Pcm.Num() / SamplesPerFrameTotal;
+
+        // Size the byte buffer from the target bitrate (+25% VBR headroom) so a typical clip encodes
+        // without regrowth; the trailing MaxPacketSize covers the in-place write window of the last frame.
+        const int64 BytesPerFrame = (int64)Bitrate * FrameSizeSamplesPerCh / FMath::Max(1, SR) / 8;
+        const int64 Estimate = (int64)NumFrames * (BytesPerFrame + BytesPerFrame / 4 + 8) + MaxPacketSize;
+        OutPackets.Reserve(NumFrames, (int32)FMath::Min<int64>(Estimate, MAX_int32));
+
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const SampleType* FramePtr = Pcm.GetData() + (int64)Frame * SamplesPerFrameTotal;
+
+            uint8* Dest = OutPackets.BeginPacket(MaxPacketSize);
+            const int EncBytes = EncodeFrame(Encoder, FramePtr, FrameSizeSamplesPerCh, Dest, MaxPacketSize);
+            OutPackets.CommitPacket(FMath::Max(EncBytes, 0));
+            if (EncBytes < 0)
+            {
+                OutPackets.RemoveLast();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Samples per channel of one frame of Packet at SampleRate (a multi-frame packet counts one frame), or 0 if invalid.
+    int32 GetFrameSamplesPerCh(TArrayView<const uint8> Packet, int32 SampleRate)
+    {
+        const int Samples = Packet.Num() > 0 ? opus_packet_get_samples_per_frame(Packet.GetData(), SampleRate) : 0;
+        return FMath::Max(Samples, 0);
+    }
+
+    // Frame length an empty packet is concealed as when no frame has been decoded before it: the caller's hint,
+    // else the first non-empty packet of the list.
+    int32 GetLeadingConcealSamples(TConstArrayView<TArrayView<const uint8>> Packets, int32 SampleRate, int32 Hint)
+    {
+        if (Hint > 0)
+        {
+            return Hint;
+        }
+        for (const TArrayView<const uint8>& Packet : Packets)
+        {
+            if (Packet.Num() > 0)
+            {
+                return GetFrameSamplesPerCh(Packet, SampleRate);
+            }
+        }
+        return 0;
+    }
+
+    template <typename SampleType>
+    int32 DecodeToBuffer(OpusDecoder* Decoder, int32 SR, int32 Ch, TConstArrayView<TArrayView<const uint8>> Packets,
+        TArrayView<SampleType> OutPcm, int32& InOutConcealSamples)
+    {
+        if (!Decoder) return INDEX_NONE;
+
+        int32 Written = 0;
+        for (const TArrayView<const uint8>& Packet : Packets)
+        {
+            const int32 RoomPerCh = (OutPcm.Num() - Written) / Ch;
+            if (Packet.Num() == 0)
+            {
+                // Missing or DTX-elided frame: let the decoder synthesise it (PLC / comfort noise) so timing is kept.
+                if (InOutConcealSamples <= 0)
+                {
+                    continue;
+                }
+                if (InOutConcealSamples > RoomPerCh) return INDEX_NONE;
+
+                const int ConcealedPerCh = DecodeFrame(Decoder, nullptr, 0, OutPcm.GetData() + Written, InOutConcealSamples);
+                if (ConcealedPerCh < 0) return INDEX_NONE;
+
+                Written += ConcealedPerCh * Ch;
+                continue;
+            }
+
+            const int DecSamplesPerCh = DecodeFrame(Decoder, Packet.GetData(), Packet.Num(), OutPcm.GetData() + Written, RoomPerCh);
+            if (DecSamplesPerCh < 0) return INDEX_NONE;
+
+            Written += DecSamplesPerCh * Ch;
+            InOutConcealSamples = GetFrameSamplesPerCh(Packet, SR);
+        }
+        return Written;
+    }
+}
+
+// ================= ENCODER =================
+
+FOpusEncoderProfileSettings FOpusEncoderProfileSettings::Get(EOpusEncoderProfile Profile)
+{
+    FOpusEncoderProfileSettings S;
+    switch (Profile)
+    {
+    case EOpusEncoderProfile::VoiceLowLatency:
+        // CELT only: 2.5 ms lookahead instead of 6.5 ms, no SILK/hybrid switching.
+        S.Application = EOpusApplication::RestrictedLowDelay;
+        S.Complexity = 5;
+        break;
+    case EOpusEncoderProfile::VoiceVoip:
+        S.Application = EOpusApplication::Voip;
+        S.Complexity = 5;
+        S.bDtx = true;
+        S.bInbandFec = true;
+        S.PacketLossPerc = 10;
+        S.Signal = OPUS_SIGNAL_VOICE;
+        break;
+    case EOpusEncoderProfile::MusicHighQuality:
+        S.Complexity = 10;
+        S.bConstrainedVbr = false;
+        S.Signal = OPUS_SIGNAL_MUSIC;
+        break;
+    case EOpusEncoderProfile::BulkCheap:
+        S.Complexity = 2;
+        break;
+    default:
+        break;
+    }
+    return S;
+}
+
+int32 FOpusEncoderState::GetStateSize(int32 Channels)
+{
+    return (Channels == 1 || Channels == 2) ? opus_encoder_get_size(Channels) : 0;
+}
+
+FOpusEncoderState::~FOpusEncoderState()
+{
+    Release();
+}
+
+FOpusEncoderState::FOpusEncoderState(FOpusEncoderState&& Other)
+{
+    *this = MoveTemp(Other);
+}
+
+FOpusEncoderState& FOpusEncoderState::operator=(FOpusEncoderState&& Other)
+{
+    if (this != &Other)
+    {
+        Release();
+        Encoder = Other.Encoder;
+        OwnedMemory = Other.OwnedMemory;
+        Arena = Other.Arena;
+        SR = Other.SR;
+        Ch = Other.Ch;
+        Bitrate = Other.Bitrate;
+        Application = Other.Application;
+        Profile = Other.Profile;
+
+        Other.Encoder = nullptr;
+        Other.OwnedMemory = nullptr;
+        Other.Arena = nullptr;
+    }
+    return *this;
+}
+
+bool FOpusEncoderState::Setup(void* Memory, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings)
+{
+    OpusEncoder* St = static_cast<OpusEncoder*>(Memory);
+    if (opus_encoder_init(St, SampleRate, Channels, (int)Settings.Application) != OPUS_OK)
+    {
+        return false;
+    }
+
+    opus_encoder_ctl(St, OPUS_SET_BITRATE(InBitrate));
+    opus_encoder_ctl(St, OPUS_SET_VBR(Settings.bVbr ? 1 : 0));
+    opus_encoder_ctl(St, OPUS_SET_VBR_CONSTRAINT(Settings.bConstrainedVbr ? 1 : 0));
+    opus_encoder_ctl(St, OPUS_SET_COMPLEXITY(Settings.Complexity));
+    opus_encoder_ctl(St, OPUS_SET_DTX(Settings.bDtx ? 1 : 0));
+    opus_encoder_ctl(St, OPUS_SET_INBAND_FEC(Settings.bInbandFec ? 1 : 0));
+    opus_encoder_ctl(St, OPUS_SET_PACKET_LOSS_PERC(Settings.PacketLossPerc));
+    opus_encoder_ctl(St, OPUS_SET_SIGNAL(Settings.Signal));
+
+    Encoder = St;
+    SR = SampleRate;
+    Ch = Channels;
+    Bitrate = InBitrate;
+    Application = Settings.Application;
+    Profile = InProfile;
+    return true;
+}
+
+bool FOpusEncoderState::InitImpl(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (Size <= 0) return false;
+
+    void* Memory = FMemory::Malloc(Size, 16);
+    if (!Setup(Memory, SampleRate, Channels, InBitrate, InProfile, Settings))
+    {
+        FMemory::Free(Memory);
+        return false;
+    }
+    OwnedMemory = Memory;
+    return true;
+}
+
+bool FOpusEncoderState::InitInPlaceImpl(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (!Memory || Size <= 0 || MemorySize < Size) return false;
+
+    return Setup(Memory, SampleRate, Channels, InBitrate, InProfile, Settings);
+}
+
+bool FOpusEncoderState::InitFromArenaImpl(FOpusStateArena& InArena, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (Size <= 0 || InArena.GetSlotSize() < Size) return false;
+
+    void* Memory = InArena.Allocate();
+    if (!Setup(Memory, SampleRate, Channels, InBitrate, InProfile, Settings))
+    {
+        InArena.Free(Memory);
+        return false;
+    }
+    Arena = &InArena;
+    return true;
+}
+
+bool FOpusEncoderState::Init(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusApplication InApplication)
+{
+    return InitImpl(SampleRate, Channels, InBitrate, EOpusEncoderProfile::Default, MakeDefaultSettings(InApplication));
+}
+
+bool FOpusEncoderState::InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusApplication InApplication)
+{
+    return InitInPlaceImpl(Memory, MemorySize, SampleRate, Channels, InBitrate, EOpusEncoderProfile::Default, MakeDefaultSettings(InApplication));
+}
+
+bool FOpusEncoderState::InitFromArena(FOpusStateArena& InArena, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusApplication InApplication)
+{
+    return InitFromArenaImpl(InArena, SampleRate, Channels, InBitrate, EOpusEncoderProfile::Default, MakeDefaultSettings(InApplication));
+}
+
+bool FOpusEncoderState::Init(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile)
+{
+    return InitImpl(SampleRate, Channels, InBitrate, InProfile, FOpusEncoderProfileSettings::Get(InProfile));
+}
+
+bool FOpusEncoderState::InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile)
+{
+    return InitInPlaceImpl(Memory, MemorySize, SampleRate, Channels, InBitrate, InProfile, FOpusEncoderProfileSettings::Get(InProfile));
+}
+
+bool FOpusEncoderState::InitFromArena(FOpusStateArena& InArena, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile)
+{
+    return InitFromArenaImpl(InArena, SampleRate, Channels, InBitrate, InProfile, FOpusEncoderProfileSettings::Get(InProfile));
+}
+
+void FOpusEncoderState::Release()
+{
+    // In-place state needs no opus_encoder_destroy; only the backing memory is released.
+    if (OwnedMemory)
+    {
+        FMemory::Free(OwnedMemory);
+    }
+    else if (Arena && Encoder)
+    {
+        Arena->Free(Encoder);
+    }
+
+    Encoder = nullptr;
+    OwnedMemory = nullptr;
+    Arena = nullptr;
+}
+
+bool FOpusEncoderState::Reset()
+{
+    return Encoder && opus_encoder_ctl(Encoder, OPUS_RESET_STATE) == OPUS_OK;
+}
+
+bool FOpusEncoderState::SetBitrate(int32 InBitrate)
+{
+    if (!Encoder || opus_encoder_ctl(Encoder, OPUS_SET_BITRATE(InBitrate)) != OPUS_OK)
+    {
+        return false;
+    }
+    Bitrate = InBitrate;
+    return true;
 }
 
-FOpusCodec::FOpusCodec(int32 InSR, int32 InCh, int32 InBitrate)
-    : SR(InSR), Ch(InCh), Bitrate(InBitrate)
+int32 FOpusEncoderState::GetLookaheadSamples() const
 {
-    int Err = 0;
+    opus_int32 Lookahead = 0;
+    if (!Encoder || opus_encoder_ctl(Encoder, OPUS_GET_LOOKAHEAD(&Lookahead)) != OPUS_OK)
+    {
+        return 0;
+    }
+    return Lookahead;
+}
+
+// ================= DECODER =================
+
+int32 FOpusDecoderState::GetStateSize(int32 Channels)
+{
+    return (Channels == 1 || Channels == 2) ? opus_decoder_get_size(Channels) : 0;
+}
+
+FOpusDecoderState::~FOpusDecoderState()
+{
+    Release();
+}
+
+FOpusDecoderState::FOpusDecoderState(FOpusDecoderState&& Other)
+{
+    *this = MoveTemp(Other);
+}
+
+FOpusDecoderState& FOpusDecoderState::operator=(FOpusDecoderState&& Other)
+{
+    if (this != &Other)
+    {
+        Release();
+        Decoder = Other.Decoder;
+        OwnedMemory = Other.OwnedMemory;
+        Arena = Other.Arena;
+        SR = Other.SR;
+        Ch = Other.Ch;
+        LastFrameSamples = Other.LastFrameSamples;
+        ConcealHint = Other.ConcealHint;
+
+        Other.Decoder = nullptr;
+        Other.OwnedMemory = nullptr;
+        Other.Arena = nullptr;
+    }
+    return *this;
+}
+
+bool FOpusDecoderState::Setup(void* Memory, int32 SampleRate, int32 Channels)
+{
+    OpusDecoder* St = static_cast<OpusDecoder*>(Memory);
+    if (opus_decoder_init(St, SampleRate, Channels) != OPUS_OK)
+    {
+        return false;
+    }
+
+    Decoder = St;
+    SR = SampleRate;
+    Ch = Channels;
+    return true;
+}
+
+bool FOpusDecoderState::Init(int32 SampleRate, int32 Channels)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (Size <= 0) return false;
 
-    Encoder = opus_encoder_create(SR, Ch, OPUS_APPLICATION_AUDIO, &Err);
-    if (!Encoder || Err != OPUS_OK)
+    void* Memory = FMemory::Malloc(Size, 16);
+    if (!Setup(Memory, SampleRate, Channels))
     {
-        Encoder = nullptr;
+        FMemory::Free(Memory);
+        return false;
     }
-    else
+    OwnedMemory = Memory;
+    return true;
+}
+
+bool FOpusDecoderState::InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (!Memory || Size <= 0 || MemorySize < Size) return false;
+
+    return Setup(Memory, SampleRate, Channels);
+}
+
+bool FOpusDecoderState::InitFromArena(FOpusStateArena& InArena, int32 SampleRate, int32 Channels)
+{
+    Release();
+
+    const int32 Size = GetStateSize(Channels);
+    if (Size <= 0 || InArena.GetSlotSize() < Size) return false;
+
+    void* Memory = InArena.Allocate();
+    if (!Setup(Memory, SampleRate, Channels))
     {
-        opus_encoder_ctl(Encoder, OPUS_SET_BITRATE(Bitrate));
-        opus_encoder_ctl(Encoder, OPUS_SET_VBR(1));
-        opus_encoder_ctl(Encoder, OPUS_SET_COMPLEXITY(8));
+        InArena.Free(Memory);
+        return false;
     }
+    Arena = &InArena;
+    return true;
+}
 
-    Decoder = opus_decoder_create(SR, Ch, &Err);
-    if (!Decoder || Err != OPUS_OK)
+void FOpusDecoderState::Release()
+{
+    if (OwnedMemory)
+    {
+        FMemory::Free(OwnedMemory);
+    }
+    else if (Arena && Decoder)
     {
-        Decoder = nullptr;
+        Arena->Free(Decoder);
     }
+
+    Decoder = nullptr;
+    OwnedMemory = nullptr;
+    Arena = nullptr;
+    LastFrameSamples = 0;
+    ConcealHint = 0;
 }
 
-FOpusCodec::~FOpusCodec()
+bool FOpusDecoderState::Reset()
 {
-    if (Encoder) { opus_encoder_destroy(Encoder); Encoder = nullptr; }
-    if (Decoder) { opus_decoder_destroy(Decoder); Decoder = nullptr; }
+    LastFrameSamples = 0;
+    ConcealHint = 0;
+    return Decoder && opus_decoder_ctl(Decoder, OPUS_RESET_STATE) == OPUS_OK;
 }
 
-TUniquePtr<FOpusCodec> FOpusCodec::Create(int32 SampleRate, int32 Channels, int32 Bitrate)
+// ================= CODEC =================
+
+TUniquePtr<FOpusCodec> FOpusCodec::Create(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application)
+{
+    TUniquePtr<FOpusCodec> Ptr(new FOpusCodec());
+    if (!Ptr->Encoder.Init(SampleRate, Channels, Bitrate, Application)
+        || !Ptr->Decoder.Init(SampleRate, Channels))
+    {
+        return nullptr;
+    }
+    return Ptr;
+}
+
+TUniquePtr<FOpusCodec> FOpusCodec::Create(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile)
 {
-    TUniquePtr<FOpusCodec> Ptr(new FOpusCodec(SampleRate, Channels, Bitrate));
-    if (!Ptr->Encoder || !Ptr->Decoder)
+    TUniquePtr<FOpusCodec> Ptr(new FOpusCodec());
+    if (!Ptr->Encoder.Init(SampleRate, Channels, Bitrate, Profile)
+        || !Ptr->Decoder.Init(SampleRate, Channels))
     {
         return nullptr;
     }
     return Ptr;
 }
 
+bool FOpusCodec::Reset()
+{
+    return Encoder.Reset() && Decoder.Reset();
+}
+
 bool FOpusCodec::EncodePcm16ToPackets(const TArray<int16>& Pcm, int32 FrameSizeSamplesPerCh, TArray<TArray<uint8>>& OutPackets)
+{
+    return Encoder.EncodePcm16ToPackets(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusCodec::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return Encoder.EncodePcm16ToPacketList(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusCodec::DecodePacketsToPcm16(const TArray<TArray<uint8>>& Packets, TArray<int16>& OutPcm)
+{
+    return Decoder.DecodePacketsToPcm16(Packets, OutPcm);
+}
+
+bool FOpusEncoderState::EncodePcm16ToPackets(const TArray<int16>& Pcm, int32 FrameSizeSamplesPerCh, TArray<TArray<uint8>>& OutPackets)
 {
     if (!Encoder || FrameSizeSamplesPerCh <= 0) return false;
 
@@ -82,29 +562,141 @@ bool FOpusCodec::EncodePcm16ToPackets(const TArray<int16>& Pcm, int32 FrameSizeS
     return true;
 }
 
-bool FOpusCodec::DecodePacketsToPcm16(const TArray<TArray<uint8>>& Packets, TArray<int16>& OutPcm)
+bool FOpusEncoderState::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
 {
-    if (!Decoder) return false;
+    return EncodeToPacketList(Encoder, SR, Ch, Bitrate, Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
 
-    OutPcm.Reset();
+bool FOpusEncoderState::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeToPacketList(Encoder, SR, Ch, Bitrate, Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusEncoderState::EncodeFrame(TConstArrayView<int16> FramePcm, FOpusPacketList& OutPackets)
+{
+    return AppendEncodedFrame(Encoder, Ch, FramePcm, OutPackets);
+}
+
+bool FOpusEncoderState::EncodeFrame(TConstArrayView<float> FramePcm, FOpusPacketList& OutPackets)
+{
+    return AppendEncodedFrame(Encoder, Ch, FramePcm, OutPackets);
+}
 
+bool FOpusDecoderState::DecodePacketsToPcm16(const TArray<TArray<uint8>>& Packets, TArray<int16>& OutPcm)
+{
+    TArray<TArrayView<const uint8>> Views;
+    Views.Reserve(Packets.Num());
     for (const TArray<uint8>& Packet : Packets)
     {
-        TArray<int16> FramePcm;
-        FramePcm.SetNumZeroed(5760 * Ch); //   
+        Views.Add(Packet);
+    }
+    return DecodePacketsToPcm16(Views, OutPcm);
+}
 
-        const int DecSamplesPerCh = opus_decode(
-            Decoder,
-            Packet.GetData(),
-            Packet.Num(),
-            FramePcm.GetData(),
-            FramePcm.Num() / Ch,
-            0
-        );
-        if (DecSamplesPerCh < 0) return false;
+bool FOpusDecoderState::DecodePacketListToPcm16(const FOpusPacketList& Packets, TArray<int16>& OutPcm)
+{
+    TArray<FOpusPacketView> Views;
+    Packets.GetViews(Views);
+    return DecodePacketsToPcm16(Views, OutPcm);
+}
+
+bool FOpusDecoderState::DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm)
+{
+    OutPcm.Reset();
+    if (!Decoder) return false;
+
+    const int32 Total = GetDecodedSampleCount(Packets);
+    if (Total < 0) return false;
+
+    OutPcm.SetNumUninitialized(Total);
+    const int32 Written = DecodePacketsToBuffer(Packets, OutPcm);
+    if (Written < 0)
+    {
+        OutPcm.Reset();
+        return false;
+    }
+
+    OutPcm.SetNum(Written, EAllowShrinking::No);
+    return true;
+}
 
-        FramePcm.SetNum(DecSamplesPerCh * Ch);
-        OutPcm.Append(FramePcm);
+bool FOpusDecoderState::DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm)
+{
+    OutPcm.Reset();
+    if (!Decoder) return false;
+
+    const int32 Total = GetDecodedSampleCount(Packets);
+    if (Total < 0) return false;
+
+    OutPcm.SetNumUninitialized(Total);
+    const int32 Written = DecodePacketsToBuffer(Packets, OutPcm);
+    if (Written < 0)
+    {
+        OutPcm.Reset();
+        return false;
     }
+
+    OutPcm.SetNum(Written, EAllowShrinking::No);
     return true;
 }
+
+int32 FOpusDecoderState::DecodePacketsToBuffer(TConstArrayView<TArrayView<const uint8>> Packets, TArrayView<int16> OutPcm)
+{
+    int32 ConcealSamples = (LastFrameSamples > 0) ? LastFrameSamples : GetLeadingConcealSamples(Packets, SR, ConcealHint);
+    const int32 Written = DecodeToBuffer(Decoder, SR, Ch, Packets, OutPcm, ConcealSamples);
+    LastFrameSamples = ConcealSamples;
+    return Written;
+}
+
+int32 FOpusDecoderState::DecodePacketsToBuffer(TConstArrayView<TArrayView<const uint8>> Packets, TArrayView<float> OutPcm)
+{
+    int32 ConcealSamples = (LastFrameSamples > 0) ? LastFrameSamples : GetLeadingConcealSamples(Packets, SR, ConcealHint);
+    const int32 Written = DecodeToBuffer(Decoder, SR, Ch, Packets, OutPcm, ConcealSamples);
+    LastFrameSamples = ConcealSamples;
+    return Written;
+}
+
+int32 FOpusDecoderState::DecodeFrameToBuffer(TArrayView<const uint8> Packet, int32 FrameSamplesPerCh, bool bFec, TArrayView<float> Out)
+{
+    if (!Decoder || FrameSamplesPerCh <= 0 || Out.Num() < FrameSamplesPerCh * Ch) return INDEX_NONE;
+
+    // PLC and FEC must be asked for exactly the missing duration; a real packet may fill the whole buffer.
+    const bool bHasData = Packet.Num() > 0;
+    const int32 MaxSamplesPerCh = (bHasData && !bFec) ? Out.Num() / Ch : FrameSamplesPerCh;
+    const int Decoded = opus_decode_float(Decoder, bHasData ? Packet.GetData() : nullptr, Packet.Num(), Out.GetData(), MaxSamplesPerCh, bFec ? 1 : 0);
+    if (Decoded < 0) return INDEX_NONE;
+
+    LastFrameSamples = FrameSamplesPerCh;
+    return Decoded;
+}
+
+int32 FOpusDecoderState::GetPacketSamplesPerChannel(TArrayView<const uint8> Packet) const
+{
+    if (!Decoder || Packet.Num() == 0) return INDEX_NONE;
+
+    const int Samples = opus_decoder_get_nb_samples(Decoder, Packet.GetData(), Packet.Num());
+    return Samples < 0 ? INDEX_NONE : Samples;
+}
+
+int32 FOpusDecoderState::GetDecodedSampleCount(TConstArrayView<TArrayView<const uint8>> Packets) const
+{
+    if (!Decoder) return INDEX_NONE;
+
+    // Mirrors DecodeToBuffer: an empty packet counts as one frame of the last decoded length.
+    int32 ConcealSamples = (LastFrameSamples > 0) ? LastFrameSamples : GetLeadingConcealSamples(Packets, SR, ConcealHint);
+    int64 Total = 0;
+    for (const TArrayView<const uint8>& Packet : Packets)
+    {
+        if (Packet.Num() == 0)
+        {
+            Total += (int64)ConcealSamples * Ch;
+            continue;
+        }
+
+        const int32 PerCh = GetPacketSamplesPerChannel(Packet);
+        if (PerCh < 0) return INDEX_NONE;
+        Total += (int64)PerCh * Ch;
+        ConcealSamples = GetFrameSamplesPerCh(Packet, SR);
+    }
+    return Total <= MAX_int32 ? (int32)Total : INDEX_NONE;
+}
@@ -0,0 +1,329 @@
+#include "OpusCustom.h"
+#include "OpusCodec.h"
+#include "OpusPacketList.h"
+
+#if WITH_OPUS_CUSTOM
+#include <opus_custom.h> // ThirdParty/Opus/Include
+
+namespace
+{
+    // CELT's own packet limit.
+    constexpr int32 MaxPacketSize = 1275;
+
+    inline int EncodeFrameImpl(OpusCustomEncoder* Enc, const int16* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_custom_encode(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int EncodeFrameImpl(OpusCustomEncoder* Enc, const float* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_custom_encode_float(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int DecodeFrameImpl(OpusCustomDecoder* Dec, const uint8* Data, int32 Len, int16* Out, int FrameSize)
+    {
+        return opus_custom_decode(Dec, Data, Len, Out, FrameSize);
+    }
+    inline int DecodeFrameImpl(OpusCustomDecoder* Dec, const uint8* Data, int32 Len, float* Out, int FrameSize)
+    {
+        return opus_custom_decode_float(Dec, Data, Len, Out, FrameSize);
+    }
+
+    OpusCustomMode* CreateMode(int32 SampleRate, int32 FrameSizeSamplesPerCh, int& OutErr)
+    {
+        // 48 kHz with 120/240 samples resolves to libopus' static mode, so this does not allocate.
+        return opus_custom_mode_create(SampleRate, FrameSizeSamplesPerCh, &OutErr);
+    }
+
+    bool IsSupportedFrameSize(int32 SampleRate, int32 FrameSizeSamplesPerCh)
+    {
+        return FOpusCustomEncoder::IsSupportedFormat(SampleRate, 2.5f) &&
+            (FrameSizeSamplesPerCh == GetOpusFrameSamples(SampleRate, 2.5f) || FrameSizeSamplesPerCh == GetOpusFrameSamples(SampleRate, 5.0f));
+    }
+}
+#endif
+
+bool FOpusCustomEncoder::IsSupportedFormat(int32 SampleRate, float FrameMs)
+{
+    return SampleRate == 48000 && (FrameMs == 2.5f || FrameMs == 5.0f);
+}
+
+// ================= ENCODER =================
+
+FOpusCustomEncoder::~FOpusCustomEncoder()
+{
+    Release();
+}
+
+#if WITH_OPUS_CUSTOM
+
+bool FOpusCustomEncoder::Init(int32 SampleRate, int32 Channels, int32 InBitrate, int32 FrameSizeSamplesPerCh, EOpusEncoderProfile Profile)
+{
+    Release();
+
+    if (Channels < 1 || Channels > 2 || !IsSupportedFrameSize(SampleRate, FrameSizeSamplesPerCh))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusCustomEncoder: unsupported format (%d Hz, %d ch, %d samples); use 48 kHz mono/stereo with 2.5 or 5 ms frames"),
+            SampleRate, Channels, FrameSizeSamplesPerCh);
+        return false;
+    }
+
+    int Err = OPUS_OK;
+    Mode = CreateMode(SampleRate, FrameSizeSamplesPerCh, Err);
+    if (Mode)
+    {
+        Encoder = opus_custom_encoder_create(Mode, Channels, &Err);
+    }
+
+    const FOpusEncoderProfileSettings Settings = FOpusEncoderProfileSettings::Get(Profile);
+    if (!Encoder || Err != OPUS_OK
+        || opus_custom_encoder_ctl(Encoder, OPUS_SET_BITRATE(InBitrate)) != OPUS_OK
+        || opus_custom_encoder_ctl(Encoder, OPUS_SET_COMPLEXITY(Settings.Complexity)) != OPUS_OK
+        || opus_custom_encoder_ctl(Encoder, OPUS_SET_VBR(Settings.bVbr ? 1 : 0)) != OPUS_OK
+        || opus_custom_encoder_ctl(Encoder, OPUS_SET_VBR_CONSTRAINT(Settings.bConstrainedVbr ? 1 : 0)) != OPUS_OK)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusCustomEncoder: cannot create encoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    Bitrate = InBitrate;
+    FrameSize = FrameSizeSamplesPerCh;
+    return true;
+}
+
+void FOpusCustomEncoder::Release()
+{
+    if (Encoder)
+    {
+        opus_custom_encoder_destroy(Encoder);
+        Encoder = nullptr;
+    }
+    if (Mode)
+    {
+        opus_custom_mode_destroy(Mode);
+        Mode = nullptr;
+    }
+    Ch = 0;
+    FrameSize = 0;
+}
+
+bool FOpusCustomEncoder::Reset()
+{
+    return Encoder && opus_custom_encoder_ctl(Encoder, OPUS_RESET_STATE) == OPUS_OK;
+}
+
+bool FOpusCustomEncoder::SetBitrate(int32 InBitrate)
+{
+    if (!Encoder || opus_custom_encoder_ctl(Encoder, OPUS_SET_BITRATE(InBitrate)) != OPUS_OK)
+        return false;
+
+    Bitrate = InBitrate;
+    return true;
+}
+
+template <typename SampleType>
+bool FOpusCustomEncoder::AppendFrame(const SampleType* FramePcm, FOpusPacketList& OutPackets)
+{
+    uint8* Dest = OutPackets.BeginPacket(MaxPacketSize);
+    const int EncBytes = EncodeFrameImpl(Encoder, FramePcm, FrameSize, Dest, MaxPacketSize);
+    OutPackets.CommitPacket(FMath::Max(EncBytes, 0));
+    if (EncBytes < 0)
+    {
+        OutPackets.RemoveLast();
+        return false;
+    }
+    return true;
+}
+
+template <typename SampleType>
+bool FOpusCustomEncoder::EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    OutPackets.Reset();
+    if (!Encoder || FrameSizeSamplesPerCh != FrameSize) return false;
+
+    const int32 SamplesPerFrame = FrameSize * Ch;
+    const int32 NumFrames = Pcm.Num() / SamplesPerFrame;
+
+    // Constant bitrate unless the profile asks for VBR, so the byte count per frame is known up front.
+    const int64 BytesPerFrame = (int64)Bitrate * FrameSize / FMath::Max(1, SR) / 8;
+    OutPackets.Reserve(NumFrames, (int32)FMath::Min<int64>((int64)NumFrames * (BytesPerFrame + BytesPerFrame / 4 + 4) + MaxPacketSize, MAX_int32));
+
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        if (!AppendFrame(Pcm.GetData() + (int64)Frame * SamplesPerFrame, OutPackets))
+            return false;
+    }
+    return true;
+}
+
+bool FOpusCustomEncoder::EncodeFrame(TConstArrayView<int16> FramePcm, FOpusPacketList& OutPackets)
+{
+    return Encoder && FramePcm.Num() == FrameSize * Ch && AppendFrame(FramePcm.GetData(), OutPackets);
+}
+
+bool FOpusCustomEncoder::EncodeFrame(TConstArrayView<float> FramePcm, FOpusPacketList& OutPackets)
+{
+    return Encoder && FramePcm.Num() == FrameSize * Ch && AppendFrame(FramePcm.GetData(), OutPackets);
+}
+
+bool FOpusCustomEncoder::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusCustomEncoder::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+#else // !WITH_OPUS_CUSTOM
+
+bool FOpusCustomEncoder::Init(int32 SampleRate, int32 Channels, int32 InBitrate, int32 FrameSizeSamplesPerCh, EOpusEncoderProfile Profile)
+{
+    UE_LOG(LogTemp, Warning, TEXT("FOpusCustomEncoder: libopus on this platform is built without custom modes"));
+    return false;
+}
+
+void FOpusCustomEncoder::Release() {}
+bool FOpusCustomEncoder::Reset() { return false; }
+bool FOpusCustomEncoder::SetBitrate(int32 InBitrate) { return false; }
+bool FOpusCustomEncoder::EncodeFrame(TConstArrayView<int16> FramePcm, FOpusPacketList& OutPackets) { return false; }
+bool FOpusCustomEncoder::EncodeFrame(TConstArrayView<float> FramePcm, FOpusPacketList& OutPackets) { return false; }
+bool FOpusCustomEncoder::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets) { return false; }
+bool FOpusCustomEncoder::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets) { return false; }
+
+#endif // WITH_OPUS_CUSTOM
+
+void FOpusCustomEncoder::WriteLayout(FOpusStreamHeader& Header) const
+{
+    Header.CodecMode = EOpusCodecMode::CustomLowDelay;
+    Header.FramesPerPacket = 1;
+    Header.StartupFrameMs = 0.0f;
+    Header.StartupFrames = 0;
+}
+
+// ================= DECODER =================
+
+FOpusCustomDecoder::~FOpusCustomDecoder()
+{
+    Release();
+}
+
+bool FOpusCustomDecoder::InitFromHeader(const FOpusStreamHeader& Header)
+{
+    if (!FOpusCustomEncoder::IsSupportedFormat(Header.SampleRate, Header.FrameMs))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusCustomDecoder: %d Hz / %g ms is not a custom-mode format"), Header.SampleRate, Header.FrameMs);
+        return false;
+    }
+    return Init(Header.SampleRate, Header.Channels, GetOpusFrameSamples(Header.SampleRate, Header.FrameMs));
+}
+
+#if WITH_OPUS_CUSTOM
+
+bool FOpusCustomDecoder::Init(int32 SampleRate, int32 Channels, int32 FrameSizeSamplesPerCh)
+{
+    Release();
+
+    if (Channels < 1 || Channels > 2 || !IsSupportedFrameSize(SampleRate, FrameSizeSamplesPerCh))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusCustomDecoder: unsupported format (%d Hz, %d ch, %d samples)"), SampleRate, Channels, FrameSizeSamplesPerCh);
+        return false;
+    }
+
+    int Err = OPUS_OK;
+    Mode = CreateMode(SampleRate, FrameSizeSamplesPerCh, Err);
+    if (Mode)
+    {
+        Decoder = opus_custom_decoder_create(Mode, Channels, &Err);
+    }
+    if (!Decoder || Err != OPUS_OK)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusCustomDecoder: cannot create decoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    FrameSize = FrameSizeSamplesPerCh;
+    return true;
+}
+
+void FOpusCustomDecoder::Release()
+{
+    if (Decoder)
+    {
+        opus_custom_decoder_destroy(Decoder);
+        Decoder = nullptr;
+    }
+    if (Mode)
+    {
+        opus_custom_mode_destroy(Mode);
+        Mode = nullptr;
+    }
+    Ch = 0;
+    FrameSize = 0;
+}
+
+bool FOpusCustomDecoder::Reset()
+{
+    return Decoder && opus_custom_decoder_ctl(Decoder, OPUS_RESET_STATE) == OPUS_OK;
+}
+
+template <typename SampleType>
+bool FOpusCustomDecoder::DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm)
+{
+    OutPcm.Reset();
+    if (!Decoder) return false;
+
+    // One frame per packet, concealed or not, so the output size is exact.
+    OutPcm.SetNumUninitialized(Packets.Num() * FrameSize * Ch);
+    for (int32 i = 0; i < Packets.Num(); ++i)
+    {
+        const TArrayView<const uint8>& Packet = Packets[i];
+        const int Decoded = DecodeFrameImpl(Decoder, Packet.Num() > 0 ? Packet.GetData() : nullptr, Packet.Num(),
+            OutPcm.GetData() + (int64)i * FrameSize * Ch, FrameSize);
+        if (Decoded != FrameSize)
+        {
+            OutPcm.Reset();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FOpusCustomDecoder::DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
+
+bool FOpusCustomDecoder::DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
+
+int32 FOpusCustomDecoder::DecodeFrameToBuffer(TArrayView<const uint8> Packet, TArrayView<float> Out)
+{
+    if (!Decoder || Out.Num() < FrameSize * Ch) return INDEX_NONE;
+
+    const int Decoded = DecodeFrameImpl(Decoder, Packet.Num() > 0 ? Packet.GetData() : nullptr, Packet.Num(), Out.GetData(), FrameSize);
+    return Decoded < 0 ? INDEX_NONE : Decoded;
+}
+
+#else // !WITH_OPUS_CUSTOM
+
+bool FOpusCustomDecoder::Init(int32 SampleRate, int32 Channels, int32 FrameSizeSamplesPerCh)
+{
+    UE_LOG(LogTemp, Warning, TEXT("FOpusCustomDecoder: libopus on this platform is built without custom modes"));
+    return false;
+}
+
+void FOpusCustomDecoder::Release() {}
+bool FOpusCustomDecoder::Reset() { return false; }
+bool FOpusCustomDecoder::DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm) { return false; }
+bool FOpusCustomDecoder::DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm) { return false; }
+int32 FOpusCustomDecoder::DecodeFrameToBuffer(TArrayView<const uint8> Packet, TArrayView<float> Out) { return INDEX_NONE; }
+
+#endif // WITH_OPUS_CUSTOM
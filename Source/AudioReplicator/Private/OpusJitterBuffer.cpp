@@ -0,0 +1,280 @@
+#include "OpusJitterBuffer.h"
+
+namespace
+{
+    // Arrival history used for the jitter percentile; ~1.3 s of 20 ms frames.
+    constexpr int32 JitterWindow = 64;
+    constexpr double JitterPercentile = 0.95;
+
+    // Catch-up cap for PopDue after a hitch, so one call never decodes an unbounded burst.
+    constexpr int32 MaxFramesPerPop = 16;
+}
+
+bool FOpusJitterBuffer::Init(int32 InSampleRate, const FOpusStreamHeader& InHeader, const FOpusJitterBufferSettings& InSettings)
+{
+    *this = FOpusJitterBuffer();
+
+    if (InSampleRate <= 0 || InHeader.FrameMs <= 0.0f)
+        return false;
+
+    if (IsOpusCustom(InHeader))
+    {
+        CustomDecoder = MakeUnique<FOpusCustomDecoder>();
+        if (!CustomDecoder->InitFromHeader(InHeader))
+        {
+            CustomDecoder.Reset();
+            return false;
+        }
+        InSampleRate = InHeader.SampleRate;
+    }
+    else
+    {
+        Decoder = UAudioReplicatorCodecPoolSubsystem::AcquireDecoder(InSampleRate, InHeader.Channels);
+        if (!Decoder)
+            return false;
+        Decoder->SetConcealFrameSamples(GetOpusFrameSamples(InSampleRate, GetOpusFrameMsAt(InHeader, 0)));
+    }
+
+    Settings = InSettings;
+    Settings.MinDelayMs = FMath::Max(0, Settings.MinDelayMs);
+    Settings.MaxDelayMs = FMath::Max(Settings.MinDelayMs, Settings.MaxDelayMs);
+    Settings.bUseFec = Settings.bUseFec && !CustomDecoder;
+
+    Header = InHeader;
+    SampleRate = InSampleRate;
+    Channels = InHeader.Channels;
+
+    // Room for twice the maximum delay at the shortest frame, so a burst after a stall does not overwrite unplayed slots.
+    const double ShortestFrameSec = FMath::Min(GetFrameSec(0), GetFrameSec(MAX_int32));
+    const int32 MaxDelayFrames = FMath::CeilToInt32(Settings.MaxDelayMs / 1000.0 / ShortestFrameSec);
+    Slots.SetNum(FMath::Max(16, 2 * MaxDelayFrames + 4));
+
+    Offsets.Reserve(JitterWindow);
+    TargetDelaySec = Settings.MinDelayMs / 1000.0;
+    return true;
+}
+
+FOpusJitterBuffer::FSlot* FOpusJitterBuffer::FindSlot(int32 Index)
+{
+    FSlot& Slot = Slots[Index % Slots.Num()];
+    return (Slot.Index == Index) ? &Slot : nullptr;
+}
+
+FOpusJitterBuffer::FSlot& FOpusJitterBuffer::ClaimSlot(int32 Index)
+{
+    FSlot& Slot = Slots[Index % Slots.Num()];
+    if (Slot.Index != Index)
+    {
+        Slot.Index = Index;
+        Slot.bElided = false;
+        Slot.Data.Reset();
+    }
+    return Slot;
+}
+
+void FOpusJitterBuffer::UpdateJitter(int32 Index, double NowSec)
+{
+    const double Offset = NowSec - GetOpusFrameStartSec(Header, Index);
+    if (Offsets.Num() < JitterWindow)
+    {
+        Offsets.Add(Offset);
+    }
+    else
+    {
+        Offsets[OffsetCursor] = Offset;
+        OffsetCursor = (OffsetCursor + 1) % JitterWindow;
+    }
+
+    // Delay of each packet relative to the fastest one in the window; the high percentile is what the buffer must absorb.
+    TArray<double, TInlineAllocator<JitterWindow>> Relative(Offsets);
+    Relative.Sort();
+    const double Fastest = Relative[0];
+    JitterSec = Relative[FMath::FloorToInt32(JitterPercentile * (Relative.Num() - 1))] - Fastest;
+
+    TargetDelaySec = FMath::Clamp(JitterSec + GetFrameSec(Index), Settings.MinDelayMs / 1000.0, Settings.MaxDelayMs / 1000.0);
+}
+
+void FOpusJitterBuffer::Push(int32 Index, TConstArrayView<uint8> Packet, int32 ElidedBefore, double NowSec)
+{
+    if (!IsValid() || Index < 0)
+        return;
+
+    ++Stats.PacketsReceived;
+    UpdateJitter(Index, NowSec);
+
+    if (!bHaveFirst)
+    {
+        // Start at the first packet we actually got; leading silence or loss before it is not waited for.
+        bHaveFirst = true;
+        NextIndex = Index;
+    }
+    else if (Index < NextIndex)
+    {
+        // Its slot was already concealed.
+        ++Stats.LatePackets;
+        return;
+    }
+
+    // Too far ahead for the ring: skip playout forward so the newest audio fits.
+    if (Index - NextIndex >= Slots.Num())
+    {
+        const int32 NewNext = Index - Slots.Num() + 1;
+        Stats.DroppedFrames += NewNext - NextIndex;
+        NextIndex = NewNext;
+    }
+
+    for (int32 k = FMath::Max(Index - ElidedBefore, NextIndex); k < Index; ++k)
+    {
+        FSlot& Slot = ClaimSlot(k);
+        if (Slot.Data.Num() == 0)
+        {
+            Slot.bElided = true;
+        }
+    }
+
+    FSlot& Slot = ClaimSlot(Index);
+    Slot.bElided = false;
+    Slot.Data = Packet;
+    HighestIndex = FMath::Max(HighestIndex, Index);
+}
+
+double FOpusJitterBuffer::GetBufferedSec() const
+{
+    return (GetBufferedFrames() > 0) ? GetOpusFrameStartSec(Header, HighestIndex + 1) - GetOpusFrameStartSec(Header, NextIndex) : 0.0;
+}
+
+bool FOpusJitterBuffer::TryStart()
+{
+    if (bStarted)
+        return true;
+    if (!bHaveFirst)
+        return false;
+
+    if (bEnded || GetBufferedSec() >= TargetDelaySec)
+    {
+        bStarted = true;
+    }
+    return bStarted;
+}
+
+void FOpusJitterBuffer::DecodeInto(TArray<float>& OutPcm, TArrayView<const uint8> Packet, int32 FrameSamples, bool bFec)
+{
+    const int32 Base = OutPcm.Num();
+    const int32 Room = FMath::Max(FrameSamples, 120 * SampleRate / 1000) * Channels; // a real packet may carry up to 120 ms
+    OutPcm.AddUninitialized(Room);
+
+    const TArrayView<float> Out(OutPcm.GetData() + Base, Room);
+    const int32 Decoded = CustomDecoder ? CustomDecoder->DecodeFrameToBuffer(Packet, Out) : Decoder->DecodeFrameToBuffer(Packet, FrameSamples, bFec, Out);
+    if (Decoded < 0)
+    {
+        // Corrupt packet: keep the timeline with one frame of silence.
+        FMemory::Memzero(OutPcm.GetData() + Base, FrameSamples * Channels * sizeof(float));
+        OutPcm.SetNum(Base + FrameSamples * Channels, EAllowShrinking::No);
+        return;
+    }
+    OutPcm.SetNum(Base + Decoded * Channels, EAllowShrinking::No);
+}
+
+bool FOpusJitterBuffer::PopFrame(TArray<float>& OutPcm)
+{
+    if (!IsValid() || !TryStart() || IsDrained())
+        return false;
+
+    // Shrink towards the target: elided silence goes first, real audio only once past the hard maximum.
+    const double MaxDelaySec = Settings.MaxDelayMs / 1000.0;
+    while (GetBufferedFrames() > 1 && GetBufferedSec() > TargetDelaySec + 2 * GetFrameSec(NextIndex))
+    {
+        const FSlot* Slot = FindSlot(NextIndex);
+        const bool bSilent = !Slot || Slot->bElided;
+        if (!bSilent && GetBufferedSec() <= MaxDelaySec)
+        {
+            break;
+        }
+        ++NextIndex;
+        ++Stats.DroppedFrames;
+    }
+
+    const int32 FrameSamples = GetFrameSamples(NextIndex);
+    const FSlot* Slot = FindSlot(NextIndex);
+    if (Slot && Slot->Data.Num() > 0)
+    {
+        DecodeInto(OutPcm, Slot->Data, FrameSamples, false);
+        ++Stats.FramesDecoded;
+        ++NextIndex;
+    }
+    else if (Slot && Slot->bElided)
+    {
+        DecodeInto(OutPcm, TArrayView<const uint8>(), FrameSamples, false);
+        ++Stats.ElidedFrames;
+        ++NextIndex;
+    }
+    else if (NextIndex < HighestIndex || bEnded)
+    {
+        // Something newer already arrived, so this frame is lost rather than late.
+        const FSlot* NextSlot = FindSlot(NextIndex + 1);
+        if (Settings.bUseFec && NextSlot && NextSlot->Data.Num() > 0)
+        {
+            DecodeInto(OutPcm, NextSlot->Data, FrameSamples, true);
+            ++Stats.FecRecoveredFrames;
+        }
+        else
+        {
+            DecodeInto(OutPcm, TArrayView<const uint8>(), FrameSamples, false);
+            ++Stats.ConcealedFrames;
+        }
+        ++NextIndex;
+    }
+    else
+    {
+        // Ran dry: stretch with PLC and keep waiting for this frame.
+        DecodeInto(OutPcm, TArrayView<const uint8>(), FrameSamples, false);
+        ++Stats.Underruns;
+    }
+
+    ++Stats.FramesPlayed;
+    return true;
+}
+
+int32 FOpusJitterBuffer::PopDue(double NowSec, TArray<float>& OutPcm)
+{
+    if (!IsValid())
+        return 0;
+
+    if (!bStarted)
+    {
+        if (!TryStart())
+            return 0;
+        PlayStartSec = NowSec;
+        PlayedSec = 0.0;
+    }
+
+    const double ElapsedSec = NowSec - PlayStartSec;
+    const double MaxBehindSec = MaxFramesPerPop * GetFrameSec(NextIndex);
+    if (ElapsedSec - PlayedSec > MaxBehindSec)
+    {
+        // The caller stalled; resync the clock instead of bursting out everything missed.
+        PlayedSec = ElapsedSec - MaxBehindSec;
+    }
+
+    // A frame is due once the clock reaches its start, so the first one plays the moment playout starts.
+    // Frames are timed by what was actually decoded, which follows the stream's frame sizes.
+    int32 Produced = 0;
+    while (Produced < MaxFramesPerPop && PlayedSec <= ElapsedSec)
+    {
+        const int32 Before = OutPcm.Num();
+        if (!PopFrame(OutPcm))
+            break;
+        PlayedSec += double(OutPcm.Num() - Before) / (Channels * SampleRate);
+        ++Produced;
+    }
+    return Produced;
+}
+
+FAudioReplicatorJitterStats FOpusJitterBuffer::GetStats() const
+{
+    FAudioReplicatorJitterStats Out = Stats;
+    Out.CurrentDelayMs = float(GetBufferedSec() * 1000.0);
+    Out.TargetDelayMs = float(TargetDelaySec * 1000.0);
+    Out.JitterMs = float(JitterSec * 1000.0);
+    return Out;
+}
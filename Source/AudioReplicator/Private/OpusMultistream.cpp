@@ -0,0 +1,494 @@
+#include "OpusMultistream.h"
+#include "OpusCodec.h"
+#include "OpusPacketList.h"
+#include <opus_multistream.h> // ThirdParty/Opus/Include
+
+namespace
+{
+    // Multistream packets carry up to 255 streams; leave room for a few full-size ones.
+    constexpr int32 MaxPacketSizePerStream = 4000;
+
+    // Mapping family 1 needs Vorbis channel order; entry i is the WAV / Unreal channel feeding Vorbis channel i.
+    constexpr uint8 VorbisFromWav[8][8] = {
+        { 0 },                          // mono
+        { 0, 1 },                       // stereo
+        { 0, 2, 1 },                    // FL FR FC            -> FL FC FR
+        { 0, 1, 2, 3 },                 // quad
+        { 0, 2, 1, 3, 4 },              // 5.0
+        { 0, 2, 1, 4, 5, 3 },           // 5.1: FL FR FC LFE BL BR -> FL FC FR BL BR LFE
+        { 0, 2, 1, 5, 6, 4, 3 },        // 6.1: FL FR FC LFE BC SL SR -> FL FC FR SL SR BC LFE
+        { 0, 2, 1, 6, 7, 4, 5, 3 },     // 7.1: FL FR FC LFE BL BR SL SR -> FL FC FR SL SR BL BR LFE
+    };
+
+    template <typename SampleType>
+    void WavToVorbis(const SampleType* In, SampleType* Out, int32 Frames, int32 Ch)
+    {
+        const uint8* Map = VorbisFromWav[Ch - 1];
+        for (int32 i = 0; i < Frames; ++i)
+        {
+            for (int32 c = 0; c < Ch; ++c)
+            {
+                Out[i * Ch + c] = In[i * Ch + Map[c]];
+            }
+        }
+    }
+
+    // In place: one frame of scratch per call is cheaper than a second full-size output buffer.
+    template <typename SampleType>
+    void VorbisToWav(SampleType* Pcm, int32 Frames, int32 Ch)
+    {
+        const uint8* Map = VorbisFromWav[Ch - 1];
+        SampleType Frame[8];
+        for (int32 i = 0; i < Frames; ++i)
+        {
+            SampleType* P = Pcm + i * Ch;
+            FMemory::Memcpy(Frame, P, Ch * sizeof(SampleType));
+            for (int32 c = 0; c < Ch; ++c)
+            {
+                P[Map[c]] = Frame[c];
+            }
+        }
+    }
+
+    inline int EncodeFrame(OpusMSEncoder* Enc, const int16* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_multistream_encode(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int EncodeFrame(OpusMSEncoder* Enc, const float* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_multistream_encode_float(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int DecodeFrame(OpusMSDecoder* Dec, const uint8* Data, int32 Len, int16* Out, int FrameSize)
+    {
+        return opus_multistream_decode(Dec, Data, Len, Out, FrameSize, 0);
+    }
+    inline int DecodeFrame(OpusMSDecoder* Dec, const uint8* Data, int32 Len, float* Out, int FrameSize)
+    {
+        return opus_multistream_decode_float(Dec, Data, Len, Out, FrameSize, 0);
+    }
+
+    // Frame length field of RFC 6716 section 3.2.1: one byte below 252, else two.
+    void WriteFrameLength(TArray<uint8>& Out, int32 Len)
+    {
+        if (Len < 252)
+        {
+            Out.Add((uint8)Len);
+        }
+        else
+        {
+            const uint8 B0 = (uint8)(252 + (Len & 3));
+            Out.Add(B0);
+            Out.Add((uint8)((Len - B0) >> 2));
+        }
+    }
+
+    int32 ReadFrameLength(const uint8*& P, const uint8* End)
+    {
+        if (P >= End) return INDEX_NONE;
+        if (P[0] < 252) return *P++;
+        if (End - P < 2) return INDEX_NONE;
+        const int32 Len = P[0] + 4 * P[1];
+        P += 2;
+        return Len;
+    }
+
+    // Standard framing: code 0 for one frame, code 3 VBR otherwise. With bSelfDelimited every frame length is
+    // written, including the last one.
+    void WritePacket(TArray<uint8>& Out, uint8 Toc, const uint8* const* Frames, const int32* Sizes, int32 Count, bool bSelfDelimited)
+    {
+        if (Count == 1)
+        {
+            Out.Add(Toc & 0xFC);
+            if (bSelfDelimited)
+            {
+                WriteFrameLength(Out, Sizes[0]);
+            }
+        }
+        else
+        {
+            Out.Add((Toc & 0xFC) | 3);
+            Out.Add((uint8)(0x80 | Count));
+            for (int32 i = 0; i < Count - (bSelfDelimited ? 0 : 1); ++i)
+            {
+                WriteFrameLength(Out, Sizes[i]);
+            }
+        }
+        for (int32 i = 0; i < Count; ++i)
+        {
+            Out.Append(Frames[i], Sizes[i]);
+        }
+    }
+
+    // Read one self-delimited packet at P and append it to Out in standard framing.
+    bool ReadSelfDelimited(const uint8*& P, const uint8* End, TArray<uint8>& Out)
+    {
+        if (P >= End) return false;
+        const uint8 Toc = *P++;
+
+        int32 Sizes[48];
+        int32 Count = 0;
+        int32 Padding = 0;
+        switch (Toc & 3)
+        {
+        case 0:
+            Count = 1;
+            Sizes[0] = ReadFrameLength(P, End);
+            break;
+        case 1:
+            Count = 2;
+            Sizes[0] = Sizes[1] = ReadFrameLength(P, End);
+            break;
+        case 2:
+            Count = 2;
+            Sizes[0] = ReadFrameLength(P, End);
+            Sizes[1] = ReadFrameLength(P, End);
+            break;
+        default:
+        {
+            if (P >= End) return false;
+            const uint8 CountByte = *P++;
+            Count = CountByte & 0x3F;
+            if (Count == 0 || Count > UE_ARRAY_COUNT(Sizes)) return false; // RFC 6716: at most 48 frames (120 ms)
+            if (CountByte & 0x40)
+            {
+                uint8 B = 255;
+                while (B == 255)
+                {
+                    if (P >= End) return false;
+                    B = *P++;
+                    Padding += (B == 255) ? 254 : B;
+                }
+            }
+            if (CountByte & 0x80)
+            {
+                for (int32 i = 0; i < Count; ++i)
+                {
+                    Sizes[i] = ReadFrameLength(P, End);
+                }
+            }
+            else
+            {
+                const int32 Len = ReadFrameLength(P, End);
+                for (int32 i = 0; i < Count; ++i)
+                {
+                    Sizes[i] = Len;
+                }
+            }
+            break;
+        }
+        }
+
+        const uint8* Frames[48];
+        int32 Total = 0;
+        for (int32 i = 0; i < Count; ++i)
+        {
+            if (Sizes[i] < 0) return false;
+            Frames[i] = P + Total;
+            Total += Sizes[i];
+        }
+        if (End - P < Total + Padding) return false;
+
+        WritePacket(Out, Toc, Frames, Sizes, Count, /*bSelfDelimited=*/false);
+        P += Total + Padding;
+        return true;
+    }
+
+    bool ApplyProfile(OpusMSEncoder* Encoder, int32 Bitrate, const FOpusEncoderProfileSettings& Settings)
+    {
+        return opus_multistream_encoder_ctl(Encoder, OPUS_SET_BITRATE(Bitrate)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_COMPLEXITY(Settings.Complexity)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_VBR(Settings.bVbr ? 1 : 0)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_VBR_CONSTRAINT(Settings.bConstrainedVbr ? 1 : 0)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_DTX(Settings.bDtx ? 1 : 0)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_INBAND_FEC(Settings.bInbandFec ? 1 : 0)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_PACKET_LOSS_PERC(Settings.PacketLossPerc)) == OPUS_OK
+            && opus_multistream_encoder_ctl(Encoder, OPUS_SET_SIGNAL(Settings.Signal)) == OPUS_OK;
+    }
+}
+
+// ================= ENCODER =================
+
+FOpusMultistreamEncoder::~FOpusMultistreamEncoder()
+{
+    Release();
+}
+
+bool FOpusMultistreamEncoder::Init(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile Profile)
+{
+    Release();
+
+    if (Channels < 1 || Channels > MaxChannels)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusMultistreamEncoder: unsupported channel count %d"), Channels);
+        return false;
+    }
+
+    const FOpusEncoderProfileSettings Settings = FOpusEncoderProfileSettings::Get(Profile);
+
+    int Err = OPUS_OK;
+    int NumStreams = 0;
+    int NumCoupled = 0;
+    Mapping.SetNumZeroed(Channels);
+    Encoder = opus_multistream_surround_encoder_create(SampleRate, Channels, /*mapping_family=*/1,
+        &NumStreams, &NumCoupled, Mapping.GetData(), (int)Settings.Application, &Err);
+    if (!Encoder || Err != OPUS_OK || !ApplyProfile(Encoder, InBitrate, Settings))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusMultistreamEncoder: cannot create encoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    Bitrate = InBitrate;
+    Streams = NumStreams;
+    CoupledStreams = NumCoupled;
+    return true;
+}
+
+void FOpusMultistreamEncoder::Release()
+{
+    if (Encoder)
+    {
+        opus_multistream_encoder_destroy(Encoder);
+        Encoder = nullptr;
+    }
+    Ch = 0;
+    Streams = 0;
+    CoupledStreams = 0;
+    Mapping.Reset();
+}
+
+void FOpusMultistreamEncoder::WriteLayout(FOpusStreamHeader& Header) const
+{
+    Header.Streams = Streams;
+    Header.CoupledStreams = CoupledStreams;
+    Header.ChannelMapping = Mapping;
+    Header.MappingFamily = 1;
+    Header.DemixingMatrix.Reset();
+}
+
+template <typename SampleType>
+bool FOpusMultistreamEncoder::EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    OutPackets.Reset();
+    if (!Encoder || FrameSizeSamplesPerCh <= 0) return false;
+
+    const int32 SamplesPerFrame = FrameSizeSamplesPerCh * Ch;
+    const int32 NumFrames = Pcm.Num() / SamplesPerFrame;
+    const int32 MaxBytes = MaxPacketSizePerStream * Streams;
+
+    const int64 BytesPerFrame = (int64)Bitrate * FrameSizeSamplesPerCh / FMath::Max(1, SR) / 8;
+    OutPackets.Reserve(NumFrames, (int32)FMath::Min<int64>((int64)NumFrames * (BytesPerFrame + BytesPerFrame / 4 + 8 * Streams) + MaxBytes, MAX_int32));
+
+    // One frame in Vorbis channel order.
+    TArray<SampleType> Scratch;
+    Scratch.SetNumUninitialized(SamplesPerFrame);
+
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        WavToVorbis(Pcm.GetData() + (int64)Frame * SamplesPerFrame, Scratch.GetData(), FrameSizeSamplesPerCh, Ch);
+
+        uint8* Dest = OutPackets.BeginPacket(MaxBytes);
+        const int EncBytes = EncodeFrame(Encoder, Scratch.GetData(), FrameSizeSamplesPerCh, Dest, MaxBytes);
+        OutPackets.CommitPacket(FMath::Max(EncBytes, 0));
+        if (EncBytes < 0)
+        {
+            OutPackets.RemoveLast();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FOpusMultistreamEncoder::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusMultistreamEncoder::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusMultistreamEncoder::GetSurroundLayout(int32 SampleRate, int32 Channels, int32& OutStreams, int32& OutCoupledStreams, TArray<uint8>& OutMapping)
+{
+    if (Channels < 1 || Channels > MaxChannels) return false;
+
+    // libopus owns the family 1 tables; a throwaway encoder reports them without duplicating them here.
+    int Err = OPUS_OK;
+    int NumStreams = 0;
+    int NumCoupled = 0;
+    OutMapping.SetNumZeroed(Channels);
+    OpusMSEncoder* Probe = opus_multistream_surround_encoder_create(SampleRate, Channels, 1,
+        &NumStreams, &NumCoupled, OutMapping.GetData(), OPUS_APPLICATION_AUDIO, &Err);
+    if (!Probe || Err != OPUS_OK)
+    {
+        if (Probe) opus_multistream_encoder_destroy(Probe);
+        return false;
+    }
+    opus_multistream_encoder_destroy(Probe);
+
+    OutStreams = NumStreams;
+    OutCoupledStreams = NumCoupled;
+    return true;
+}
+
+// ================= DECODER =================
+
+FOpusMultistreamDecoder::~FOpusMultistreamDecoder()
+{
+    Release();
+}
+
+bool FOpusMultistreamDecoder::Init(int32 SampleRate, int32 Channels, int32 Streams, int32 CoupledStreams, TConstArrayView<uint8> Mapping)
+{
+    Release();
+
+    if (Channels < 1 || Channels > FOpusMultistreamEncoder::MaxChannels || Mapping.Num() != Channels)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusMultistreamDecoder: bad layout (%d ch, %d mapping entries)"), Channels, Mapping.Num());
+        return false;
+    }
+
+    int Err = OPUS_OK;
+    Decoder = opus_multistream_decoder_create(SampleRate, Channels, Streams, CoupledStreams, Mapping.GetData(), &Err);
+    if (!Decoder || Err != OPUS_OK)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusMultistreamDecoder: cannot create decoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    return true;
+}
+
+bool FOpusMultistreamDecoder::InitFromHeader(const FOpusStreamHeader& Header, int32 SampleRate)
+{
+    return Init(SampleRate, Header.Channels, Header.Streams, Header.CoupledStreams, Header.ChannelMapping);
+}
+
+void FOpusMultistreamDecoder::Release()
+{
+    if (Decoder)
+    {
+        opus_multistream_decoder_destroy(Decoder);
+        Decoder = nullptr;
+    }
+    Ch = 0;
+    LastFrameSamples = 0;
+    ConcealHint = 0;
+}
+
+template <typename SampleType>
+bool FOpusMultistreamDecoder::DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm)
+{
+    OutPcm.Reset();
+    if (!Decoder) return false;
+
+    const int32 MaxFrameSamples = 120 * SR / 1000; // one packet carries at most 120 ms
+    int32 Written = 0; // per channel
+    for (const TArrayView<const uint8>& Packet : Packets)
+    {
+        int32 Room = MaxFrameSamples;
+        if (Packet.Num() == 0)
+        {
+            // Missing packet: keep the timeline with one concealed frame.
+            Room = (LastFrameSamples > 0) ? LastFrameSamples : ConcealHint;
+            if (Room <= 0) continue;
+        }
+
+        OutPcm.AddUninitialized(Room * Ch);
+        const int Decoded = DecodeFrame(Decoder, Packet.Num() > 0 ? Packet.GetData() : nullptr, Packet.Num(),
+            OutPcm.GetData() + (int64)Written * Ch, Room);
+        if (Decoded < 0)
+        {
+            OutPcm.Reset();
+            return false;
+        }
+
+        VorbisToWav(OutPcm.GetData() + (int64)Written * Ch, Decoded, Ch);
+        Written += Decoded;
+        OutPcm.SetNum(Written * Ch, EAllowShrinking::No);
+        if (Packet.Num() > 0)
+        {
+            LastFrameSamples = opus_packet_get_samples_per_frame(Packet.GetData(), SR);
+        }
+    }
+    return true;
+}
+
+bool FOpusMultistreamDecoder::DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
+
+bool FOpusMultistreamDecoder::DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
+
+// ================= PACKET FRAMING =================
+
+namespace OpusMultistreamPacket
+{
+    bool Pack(TConstArrayView<TArrayView<const uint8>> StreamPackets, TArray<uint8>& OutPacket)
+    {
+        OutPacket.Reset();
+        if (StreamPackets.Num() == 0 || StreamPackets.Num() > 255) return false;
+
+        for (int32 s = 0; s < StreamPackets.Num(); ++s)
+        {
+            const TArrayView<const uint8>& Packet = StreamPackets[s];
+            if (Packet.Num() == 0) return false;
+
+            if (s + 1 == StreamPackets.Num())
+            {
+                OutPacket.Append(Packet.GetData(), Packet.Num());
+                break;
+            }
+
+            unsigned char Toc = 0;
+            const unsigned char* Frames[48];
+            opus_int16 Sizes16[48];
+            const int Count = opus_packet_parse(Packet.GetData(), Packet.Num(), &Toc, Frames, Sizes16, nullptr);
+            if (Count <= 0) return false;
+
+            int32 Sizes[48];
+            for (int32 i = 0; i < Count; ++i)
+            {
+                Sizes[i] = Sizes16[i];
+            }
+            WritePacket(OutPacket, Toc, Frames, Sizes, Count, /*bSelfDelimited=*/true);
+        }
+        return true;
+    }
+
+    bool Unpack(TArrayView<const uint8> Packet, int32 NumStreams, TArray<TArray<uint8>>& OutStreamPackets)
+    {
+        OutStreamPackets.Reset();
+        if (NumStreams <= 0 || Packet.Num() == 0) return false;
+
+        OutStreamPackets.SetNum(NumStreams);
+        const uint8* P = Packet.GetData();
+        const uint8* End = P + Packet.Num();
+        for (int32 s = 0; s + 1 < NumStreams; ++s)
+        {
+            if (!ReadSelfDelimited(P, End, OutStreamPackets[s]))
+            {
+                OutStreamPackets.Reset();
+                return false;
+            }
+        }
+
+        if (P >= End)
+        {
+            OutStreamPackets.Reset();
+            return false;
+        }
+        OutStreamPackets.Last().Append(P, End - P);
+        return true;
+    }
+}
@@ -0,0 +1,171 @@
+#include "OpusPacketList.h"
+
+void GetOpusPacketViews(const TArray<FOpusPacket>& Packets, TArray<FOpusPacketView>& Out)
+{
+    Out.Reset(Packets.Num());
+    for (const FOpusPacket& P : Packets)
+    {
+        Out.Add(P.Data);
+    }
+}
+
+void FOpusPacketList::Reset()
+{
+    SharedBytes.Reset();
+    SharedPayloadBytes = 0;
+    Bytes.Reset();
+    Offsets.Reset();
+    Lengths.Reset();
+    PendingOffset = INDEX_NONE;
+}
+
+void FOpusPacketList::ResetShared(const FSharedBuffer& Buffer)
+{
+    Reset();
+    SharedBytes = Buffer;
+}
+
+void FOpusPacketList::AddShared(int32 Offset, int32 Length)
+{
+    check(IsShared() && PendingOffset == INDEX_NONE);
+    check(Offset >= 0 && Length >= 0 && Offset + Length <= SharedBytes->Num());
+
+    Offsets.Add(Offset);
+    Lengths.Add(Length);
+    SharedPayloadBytes += Length;
+}
+
+void FOpusPacketList::Detach()
+{
+    if (!IsShared())
+        return;
+
+    TArray<uint8> Own;
+    Own.Reserve(SharedPayloadBytes);
+    for (int32 i = 0; i < Num(); ++i)
+    {
+        const int32 Offset = Own.Num();
+        Own.Append(SharedBytes->GetData() + Offsets[i], Lengths[i]);
+        Offsets[i] = Offset;
+    }
+
+    Bytes = MoveTemp(Own);
+    SharedBytes.Reset();
+    SharedPayloadBytes = 0;
+}
+
+void FOpusPacketList::Reserve(int32 NumPackets, int32 NumBytes)
+{
+    Detach();
+    Offsets.Reserve(NumPackets);
+    Lengths.Reserve(NumPackets);
+    Bytes.Reserve(NumBytes);
+}
+
+void FOpusPacketList::Add(FOpusPacketView Packet)
+{
+    Detach();
+    Offsets.Add(Bytes.Num());
+    Lengths.Add(Packet.Num());
+    Bytes.Append(Packet.GetData(), Packet.Num());
+}
+
+uint8* FOpusPacketList::BeginPacket(int32 MaxBytes)
+{
+    check(PendingOffset == INDEX_NONE);
+    check(MaxBytes >= 0);
+    Detach();
+
+    PendingOffset = Bytes.Num();
+    // Grows geometrically when capacity runs out, so a reserved list never reallocates per packet.
+    Bytes.SetNumUninitialized(PendingOffset + MaxBytes, EAllowShrinking::No);
+    return Bytes.GetData() + PendingOffset;
+}
+
+void FOpusPacketList::CommitPacket(int32 NumBytes)
+{
+    check(PendingOffset != INDEX_NONE);
+    check(NumBytes >= 0 && PendingOffset + NumBytes <= Bytes.Num());
+
+    Offsets.Add(PendingOffset);
+    Lengths.Add(NumBytes);
+    Bytes.SetNum(PendingOffset + NumBytes, EAllowShrinking::No);
+    PendingOffset = INDEX_NONE;
+}
+
+void FOpusPacketList::RemoveLast()
+{
+    check(PendingOffset == INDEX_NONE && Num() > 0);
+
+    if (IsShared())
+    {
+        SharedPayloadBytes -= Lengths.Last();
+        Offsets.Pop(EAllowShrinking::No);
+        Lengths.Pop(EAllowShrinking::No);
+        return;
+    }
+
+    Bytes.SetNum(Offsets.Last(), EAllowShrinking::No);
+    Offsets.Pop(EAllowShrinking::No);
+    Lengths.Pop(EAllowShrinking::No);
+}
+
+void FOpusPacketList::Append(const FOpusPacketList& Other)
+{
+    if (Other.IsShared())
+    {
+        Reserve(Num() + Other.Num(), GetTotalBytes() + Other.GetTotalBytes());
+        for (int32 i = 0; i < Other.Num(); ++i)
+        {
+            Add(Other.GetPacket(i));
+        }
+        return;
+    }
+
+    Detach();
+    const int32 Base = Bytes.Num();
+    Bytes.Append(Other.Bytes);
+    Lengths.Append(Other.Lengths);
+
+    Offsets.Reserve(Offsets.Num() + Other.Offsets.Num());
+    for (const int32 Offset : Other.Offsets)
+    {
+        Offsets.Add(Base + Offset);
+    }
+}
+
+void FOpusPacketList::GetViews(TArray<FOpusPacketView>& Out) const
+{
+    Out.Reset(Num());
+    for (int32 i = 0; i < Num(); ++i)
+    {
+        Out.Add(GetPacket(i));
+    }
+}
+
+void FOpusPacketList::ToPackets(TArray<FOpusPacket>& Out) const
+{
+    Out.Reset(Num());
+    for (int32 i = 0; i < Num(); ++i)
+    {
+        FOpusPacket& P = Out.AddDefaulted_GetRef();
+        P.Data.Append(GetPacket(i).GetData(), GetLength(i));
+    }
+}
+
+FOpusPacketList FOpusPacketList::FromPackets(const TArray<FOpusPacket>& Packets)
+{
+    int32 TotalBytes = 0;
+    for (const FOpusPacket& P : Packets)
+    {
+        TotalBytes += P.Data.Num();
+    }
+
+    FOpusPacketList List;
+    List.Reserve(Packets.Num(), TotalBytes);
+    for (const FOpusPacket& P : Packets)
+    {
+        List.Add(P.Data);
+    }
+    return List;
+}
@@ -0,0 +1,100 @@
+#include "OpusParallelEncode.h"
+#include "OpusPacketList.h"
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+namespace
+{
+    inline bool EncodeSpan(FOpusEncoderState& Encoder, TConstArrayView<int16> Pcm, int32 FrameSize, FOpusPacketList& Out)
+    {
+        return Encoder.EncodePcm16ToPacketList(Pcm, FrameSize, Out);
+    }
+    inline bool EncodeSpan(FOpusEncoderState& Encoder, TConstArrayView<float> Pcm, int32 FrameSize, FOpusPacketList& Out)
+    {
+        return Encoder.EncodeFloatToPacketList(Pcm, FrameSize, Out);
+    }
+
+    template <typename SampleType>
+    bool EncodeSegmented(TConstArrayView<SampleType> Pcm, int32 SR, int32 Ch, int32 Bitrate, int32 FrameSize,
+        FOpusPacketList& OutPackets, const FOpusParallelEncodeSettings& Settings, EOpusEncoderProfile Profile)
+    {
+        OutPackets.Reset();
+        if (Ch <= 0 || FrameSize <= 0) return false;
+
+        const int32 FrameSamples = FrameSize * Ch;
+        const int32 NumFrames = Pcm.Num() / FrameSamples;
+
+        const int32 MaxSegments = (Settings.MaxSegments > 0)
+            ? Settings.MaxSegments
+            : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        const int32 NumSegments = FMath::Clamp(NumFrames / FMath::Max(1, Settings.MinFramesPerSegment), 1, FMath::Max(1, MaxSegments));
+
+        // Leases are taken on the calling thread; the pool itself is thread-safe, but the subsystem lookup is not.
+        TArray<FOpusEncoderLease> Encoders;
+        Encoders.Reserve(NumSegments);
+        for (int32 s = 0; s < NumSegments; ++s)
+        {
+            FOpusEncoderLease& Lease = Encoders.Add_GetRef(UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(SR, Ch, Bitrate, Profile));
+            if (!Lease) return false;
+        }
+
+        if (NumSegments == 1)
+        {
+            return EncodeSpan(*Encoders[0], Pcm, FrameSize, OutPackets);
+        }
+
+        TArray<FOpusPacketList> Segments;
+        Segments.SetNum(NumSegments);
+        TArray<bool> SegmentOk;
+        SegmentOk.Init(false, NumSegments);
+
+        const int32 PreRoll = FMath::Max(0, Settings.PreRollFrames);
+        ParallelFor(NumSegments, [&](int32 s)
+        {
+            const int32 FirstFrame = (int32)((int64)NumFrames * s / NumSegments);
+            const int32 EndFrame = (int32)((int64)NumFrames * (s + 1) / NumSegments);
+            const int32 PreRollStart = FMath::Max(0, FirstFrame - PreRoll);
+
+            FOpusEncoderState& Encoder = *Encoders[s];
+
+            // Warm the encoder on the audio just before the seam and throw those packets away, so
+            // the first kept frame is coded with (nearly) the same history as in a serial encode.
+            if (PreRollStart < FirstFrame)
+            {
+                FOpusPacketList Discard;
+                const TConstArrayView<SampleType> Warm = Pcm.Slice(PreRollStart * FrameSamples, (FirstFrame - PreRollStart) * FrameSamples);
+                if (!EncodeSpan(Encoder, Warm, FrameSize, Discard)) return;
+            }
+
+            const TConstArrayView<SampleType> Body = Pcm.Slice(FirstFrame * FrameSamples, (EndFrame - FirstFrame) * FrameSamples);
+            SegmentOk[s] = EncodeSpan(Encoder, Body, FrameSize, Segments[s]);
+        });
+
+        int32 TotalBytes = 0;
+        for (int32 s = 0; s < NumSegments; ++s)
+        {
+            if (!SegmentOk[s]) return false;
+            TotalBytes += Segments[s].GetTotalBytes();
+        }
+
+        OutPackets.Reserve(NumFrames, TotalBytes);
+        for (const FOpusPacketList& Segment : Segments)
+        {
+            OutPackets.Append(Segment);
+        }
+        return true;
+    }
+}
+
+bool OpusParallel::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate,
+    int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets, const FOpusParallelEncodeSettings& Settings, EOpusEncoderProfile Profile)
+{
+    return EncodeSegmented(Pcm, SampleRate, Channels, Bitrate, FrameSizeSamplesPerCh, OutPackets, Settings, Profile);
+}
+
+bool OpusParallel::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate,
+    int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets, const FOpusParallelEncodeSettings& Settings, EOpusEncoderProfile Profile)
+{
+    return EncodeSegmented(Pcm, SampleRate, Channels, Bitrate, FrameSizeSamplesPerCh, OutPackets, Settings, Profile);
+}
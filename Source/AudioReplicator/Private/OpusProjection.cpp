@@ -0,0 +1,267 @@
+#include "OpusProjection.h"
+#include "OpusCodec.h"
+#include "OpusPacketList.h"
+#include <opus_projection.h> // ThirdParty/Opus/Include
+
+namespace
+{
+    // Same per-stream budget as the surround path.
+    constexpr int32 MaxPacketSizePerStream = 4000;
+
+    inline int EncodeFrame(OpusProjectionEncoder* Enc, const int16* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_projection_encode(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int EncodeFrame(OpusProjectionEncoder* Enc, const float* Pcm, int FrameSize, uint8* Out, int32 MaxBytes)
+    {
+        return opus_projection_encode_float(Enc, Pcm, FrameSize, Out, MaxBytes);
+    }
+    inline int DecodeFrame(OpusProjectionDecoder* Dec, const uint8* Data, int32 Len, int16* Out, int FrameSize)
+    {
+        return opus_projection_decode(Dec, Data, Len, Out, FrameSize, 0);
+    }
+    inline int DecodeFrame(OpusProjectionDecoder* Dec, const uint8* Data, int32 Len, float* Out, int FrameSize)
+    {
+        return opus_projection_decode_float(Dec, Data, Len, Out, FrameSize, 0);
+    }
+
+    bool ApplyProfile(OpusProjectionEncoder* Encoder, int32 Bitrate, const FOpusEncoderProfileSettings& Settings)
+    {
+        return opus_projection_encoder_ctl(Encoder, OPUS_SET_BITRATE(Bitrate)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_COMPLEXITY(Settings.Complexity)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_VBR(Settings.bVbr ? 1 : 0)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_VBR_CONSTRAINT(Settings.bConstrainedVbr ? 1 : 0)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_DTX(Settings.bDtx ? 1 : 0)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_INBAND_FEC(Settings.bInbandFec ? 1 : 0)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_PACKET_LOSS_PERC(Settings.PacketLossPerc)) == OPUS_OK
+            && opus_projection_encoder_ctl(Encoder, OPUS_SET_SIGNAL(Settings.Signal)) == OPUS_OK;
+    }
+}
+
+// ================= ENCODER =================
+
+FOpusProjectionEncoder::~FOpusProjectionEncoder()
+{
+    Release();
+}
+
+bool FOpusProjectionEncoder::IsSupportedChannelCount(int32 Channels)
+{
+    // (order + 1)^2 ambisonic channels for order 1 and 2, optionally followed by a stereo pair.
+    return Channels == 4 || Channels == 6 || Channels == 9 || Channels == 11;
+}
+
+bool FOpusProjectionEncoder::Init(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile Profile)
+{
+    Release();
+
+    if (!IsSupportedChannelCount(Channels))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusProjectionEncoder: %d channels is not first or second order ambisonics"), Channels);
+        return false;
+    }
+
+    const FOpusEncoderProfileSettings Settings = FOpusEncoderProfileSettings::Get(Profile);
+
+    int Err = OPUS_OK;
+    int NumStreams = 0;
+    int NumCoupled = 0;
+    Encoder = opus_projection_ambisonics_encoder_create(SampleRate, Channels, /*mapping_family=*/3,
+        &NumStreams, &NumCoupled, (int)Settings.Application, &Err);
+    if (!Encoder || Err != OPUS_OK || !ApplyProfile(Encoder, InBitrate, Settings))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusProjectionEncoder: cannot create encoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    opus_int32 MatrixSize = 0;
+    if (opus_projection_encoder_ctl(Encoder, OPUS_PROJECTION_GET_DEMIXING_MATRIX_SIZE(&MatrixSize)) != OPUS_OK || MatrixSize <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusProjectionEncoder: no demixing matrix"));
+        Release();
+        return false;
+    }
+    DemixingMatrix.SetNumUninitialized(MatrixSize);
+    if (opus_projection_encoder_ctl(Encoder, OPUS_PROJECTION_GET_DEMIXING_MATRIX(DemixingMatrix.GetData(), MatrixSize)) != OPUS_OK)
+    {
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    Bitrate = InBitrate;
+    Streams = NumStreams;
+    CoupledStreams = NumCoupled;
+    return true;
+}
+
+void FOpusProjectionEncoder::Release()
+{
+    if (Encoder)
+    {
+        opus_projection_encoder_destroy(Encoder);
+        Encoder = nullptr;
+    }
+    Ch = 0;
+    Streams = 0;
+    CoupledStreams = 0;
+    DemixingMatrix.Reset();
+}
+
+bool FOpusProjectionEncoder::Reset()
+{
+    return Encoder && opus_projection_encoder_ctl(Encoder, OPUS_RESET_STATE) == OPUS_OK;
+}
+
+void FOpusProjectionEncoder::WriteLayout(FOpusStreamHeader& Header) const
+{
+    Header.Streams = Streams;
+    Header.CoupledStreams = CoupledStreams;
+    Header.ChannelMapping.Reset();
+    Header.MappingFamily = 3;
+    Header.DemixingMatrix = DemixingMatrix;
+}
+
+template <typename SampleType>
+bool FOpusProjectionEncoder::EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    OutPackets.Reset();
+    if (!Encoder || FrameSizeSamplesPerCh <= 0) return false;
+
+    const int32 SamplesPerFrame = FrameSizeSamplesPerCh * Ch;
+    const int32 NumFrames = Pcm.Num() / SamplesPerFrame;
+    const int32 MaxBytes = MaxPacketSizePerStream * Streams;
+
+    const int64 BytesPerFrame = (int64)Bitrate * FrameSizeSamplesPerCh / FMath::Max(1, SR) / 8;
+    OutPackets.Reserve(NumFrames, (int32)FMath::Min<int64>((int64)NumFrames * (BytesPerFrame + BytesPerFrame / 4 + 8 * Streams) + MaxBytes, MAX_int32));
+
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        uint8* Dest = OutPackets.BeginPacket(MaxBytes);
+        const int EncBytes = EncodeFrame(Encoder, Pcm.GetData() + (int64)Frame * SamplesPerFrame, FrameSizeSamplesPerCh, Dest, MaxBytes);
+        OutPackets.CommitPacket(FMath::Max(EncBytes, 0));
+        if (EncBytes < 0)
+        {
+            OutPackets.RemoveLast();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FOpusProjectionEncoder::EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+bool FOpusProjectionEncoder::EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets)
+{
+    return EncodeImpl(Pcm, FrameSizeSamplesPerCh, OutPackets);
+}
+
+// ================= DECODER =================
+
+FOpusProjectionDecoder::~FOpusProjectionDecoder()
+{
+    Release();
+}
+
+bool FOpusProjectionDecoder::Init(int32 SampleRate, int32 Channels, int32 Streams, int32 CoupledStreams, TConstArrayView<uint8> DemixingMatrix)
+{
+    Release();
+
+    if (!FOpusProjectionEncoder::IsSupportedChannelCount(Channels) || DemixingMatrix.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusProjectionDecoder: bad layout (%d ch, %d matrix bytes)"), Channels, DemixingMatrix.Num());
+        return false;
+    }
+
+    // libopus copies the matrix during creation but takes it as non-const.
+    TArray<uint8> Matrix(DemixingMatrix);
+
+    int Err = OPUS_OK;
+    Decoder = opus_projection_decoder_create(SampleRate, Channels, Streams, CoupledStreams, Matrix.GetData(), Matrix.Num(), &Err);
+    if (!Decoder || Err != OPUS_OK)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusProjectionDecoder: cannot create decoder (%d Hz, %d ch, err %d)"), SampleRate, Channels, Err);
+        Release();
+        return false;
+    }
+
+    SR = SampleRate;
+    Ch = Channels;
+    return true;
+}
+
+bool FOpusProjectionDecoder::InitFromHeader(const FOpusStreamHeader& Header, int32 SampleRate)
+{
+    return Init(SampleRate, Header.Channels, Header.Streams, Header.CoupledStreams, Header.DemixingMatrix);
+}
+
+void FOpusProjectionDecoder::Release()
+{
+    if (Decoder)
+    {
+        opus_projection_decoder_destroy(Decoder);
+        Decoder = nullptr;
+    }
+    Ch = 0;
+    LastFrameSamples = 0;
+    ConcealHint = 0;
+}
+
+bool FOpusProjectionDecoder::Reset()
+{
+    LastFrameSamples = 0;
+    ConcealHint = 0;
+    return Decoder && opus_projection_decoder_ctl(Decoder, OPUS_RESET_STATE) == OPUS_OK;
+}
+
+template <typename SampleType>
+bool FOpusProjectionDecoder::DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm)
+{
+    OutPcm.Reset();
+    if (!Decoder) return false;
+
+    const int32 MaxFrameSamples = 120 * SR / 1000; // one packet carries at most 120 ms
+    int32 Written = 0; // per channel
+    for (const TArrayView<const uint8>& Packet : Packets)
+    {
+        int32 Room = MaxFrameSamples;
+        if (Packet.Num() == 0)
+        {
+            // Missing packet: keep the timeline with one concealed frame.
+            Room = (LastFrameSamples > 0) ? LastFrameSamples : ConcealHint;
+            if (Room <= 0) continue;
+        }
+
+        OutPcm.AddUninitialized(Room * Ch);
+        const int Decoded = DecodeFrame(Decoder, Packet.Num() > 0 ? Packet.GetData() : nullptr, Packet.Num(),
+            OutPcm.GetData() + (int64)Written * Ch, Room);
+        if (Decoded < 0)
+        {
+            OutPcm.Reset();
+            return false;
+        }
+
+        Written += Decoded;
+        OutPcm.SetNum(Written * Ch, EAllowShrinking::No);
+        if (Packet.Num() > 0)
+        {
+            LastFrameSamples = opus_packet_get_samples_per_frame(Packet.GetData(), SR);
+        }
+    }
+    return true;
+}
+
+bool FOpusProjectionDecoder::DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
+
+bool FOpusProjectionDecoder::DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm)
+{
+    return DecodeImpl(Packets, OutPcm);
+}
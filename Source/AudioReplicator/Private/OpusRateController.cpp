@@ -0,0 +1,106 @@
+#include "OpusRateController.h"
+
+namespace
+{
+    // ~30 s of history at one entry per quarter second.
+    constexpr int32 HistorySize = 128;
+    constexpr double HistoryIntervalSec = 0.25;
+
+    // Floor for the hold time between decreases when the RTT is unknown or tiny.
+    constexpr double MinHoldSec = 0.2;
+
+    // The lowest RTT drifts up slowly so a route change does not leave it stuck too low.
+    constexpr double MinRttDriftPerSec = 0.05;
+}
+
+void FOpusRateController::Init(int32 StartBitrate, const FOpusRateControlSettings& InSettings, double NowSec)
+{
+    *this = FOpusRateController();
+
+    Settings = InSettings;
+    MaxTarget = (Settings.MaxBitrate > 0) ? Settings.MaxBitrate : StartBitrate;
+    MinTarget = FMath::Min<double>(FMath::Max(Settings.MinBitrate, 6000), MaxTarget);
+    Target = FMath::Clamp<double>(StartBitrate, MinTarget, MaxTarget);
+
+    StartSec = NowSec;
+    History.Reserve(HistorySize);
+}
+
+int32 FOpusRateController::Update(const FOpusRateSample& Sample, double NowSec)
+{
+    const double DeltaSec = (LastUpdateSec >= 0.0) ? FMath::Clamp(NowSec - LastUpdateSec, 0.0, 1.0) : 0.0;
+    LastUpdateSec = NowSec;
+
+    if (Sample.RttSec > 0.0)
+    {
+        MinRttSec = (MinRttSec > 0.0) ? FMath::Min(Sample.RttSec, MinRttSec + MinRttDriftPerSec * DeltaSec * MinRttSec) : Sample.RttSec;
+    }
+
+    const bool bQueue = Sample.QueueDelaySec * 1000.0 > Settings.QueueHighMs;
+    const bool bRtt = Sample.RttSec > 0.0 && MinRttSec > 0.0 && (Sample.RttSec - MinRttSec) * 1000.0 > Settings.RttSlackMs;
+    const bool bLoss = Sample.LossPercent > Settings.LossHighPercent;
+    const bool bCongested = bQueue || bRtt || bLoss;
+
+    // Wait a round trip after a cut before judging its effect.
+    const double HoldSec = FMath::Max(Sample.RttSec, MinHoldSec);
+    const bool bHolding = LastDecreaseSec >= 0.0 && NowSec - LastDecreaseSec < HoldSec;
+
+    if (bCongested)
+    {
+        if (!bHolding)
+        {
+            double NewTarget = Target * Settings.DecreaseFactor;
+            if (Sample.ThroughputBps > 0.0)
+            {
+                NewTarget = FMath::Min(NewTarget, Sample.ThroughputBps);
+            }
+            Target = NewTarget;
+            LastDecreaseSec = NowSec;
+        }
+    }
+    else if (!bHolding && Sample.QueueDelaySec * 1000.0 < Settings.QueueLowMs)
+    {
+        Target += Settings.IncreaseBpsPerSec * DeltaSec;
+    }
+
+    Target = FMath::Clamp(Target, MinTarget, MaxTarget);
+
+    // Cuts are always recorded; steady state at the history interval.
+    if (LastDecreaseSec == NowSec || LastRecordSec < 0.0 || NowSec - LastRecordSec >= HistoryIntervalSec)
+    {
+        Record(Sample, bCongested, NowSec);
+    }
+    return GetTargetBitrate();
+}
+
+void FOpusRateController::Record(const FOpusRateSample& Sample, bool bCongested, double NowSec)
+{
+    FAudioReplicatorBitrateSample Entry;
+    Entry.TimeSec = float(NowSec - StartSec);
+    Entry.Bitrate = GetTargetBitrate();
+    Entry.QueueDelayMs = float(Sample.QueueDelaySec * 1000.0);
+    Entry.RttMs = float(Sample.RttSec * 1000.0);
+    Entry.ThroughputKbps = float(Sample.ThroughputBps / 1000.0);
+    Entry.LossPercent = Sample.LossPercent;
+    Entry.bCongested = bCongested;
+
+    if (History.Num() < HistorySize)
+    {
+        History.Add(Entry);
+    }
+    else
+    {
+        History[HistoryCursor] = Entry;
+        HistoryCursor = (HistoryCursor + 1) % HistorySize;
+    }
+    LastRecordSec = NowSec;
+}
+
+void FOpusRateController::GetHistory(TArray<FAudioReplicatorBitrateSample>& Out) const
+{
+    Out.Reset(History.Num());
+    for (int32 i = 0; i < History.Num(); ++i)
+    {
+        Out.Add(History[(HistoryCursor + i) % History.Num()]);
+    }
+}
@@ -0,0 +1,140 @@
+#include "OpusRepacketizer.h"
+#include "OpusPacketList.h"
+#include <opus.h> // ThirdParty/Opus/Include
+
+namespace
+{
+    // Code 3 packets add a count byte, optional padding and up to two length bytes per frame
+    // on top of the concatenated frame payloads.
+    int32 GetMergedBound(int32 PayloadBytes, int32 NumPackets)
+    {
+        return PayloadBytes + 2 * NumPackets + 8;
+    }
+}
+
+FOpusRepacketizer::FOpusRepacketizer()
+    : State(opus_repacketizer_create())
+{
+}
+
+FOpusRepacketizer::~FOpusRepacketizer()
+{
+    if (State)
+    {
+        opus_repacketizer_destroy(State);
+        State = nullptr;
+    }
+}
+
+bool FOpusRepacketizer::FlushGroup(FOpusPacketList& Out)
+{
+    if (GroupPackets == 0)
+    {
+        return true;
+    }
+
+    const int32 MaxBytes = GetMergedBound(GroupBytes, GroupPackets);
+    uint8* Dest = Out.BeginPacket(MaxBytes);
+    const opus_int32 Len = opus_repacketizer_out(State, Dest, MaxBytes);
+    Out.CommitPacket(FMath::Max<int32>(Len, 0));
+
+    opus_repacketizer_init(State);
+    GroupPackets = 0;
+    GroupBytes = 0;
+
+    if (Len < 0)
+    {
+        Out.RemoveLast();
+        return false;
+    }
+    return true;
+}
+
+bool FOpusRepacketizer::Merge(const FOpusPacketList& In, int32 MaxPacketsPerGroup, FOpusPacketList& Out)
+{
+    Out.Reset();
+    if (!State) return false;
+
+    Out.Reserve(In.Num() / FMath::Max(1, MaxPacketsPerGroup) + 1, GetMergedBound(In.GetTotalBytes(), In.Num()));
+
+    opus_repacketizer_init(State);
+    GroupPackets = 0;
+    GroupBytes = 0;
+
+    // The repacketizer keeps pointers into In until the group is flushed, which is fine: In is not touched here.
+    for (int32 i = 0; i < In.Num(); ++i)
+    {
+        const FOpusPacketView Packet = In.GetPacket(i);
+        if (Packet.Num() == 0)
+        {
+            // Nothing to bundle; keep the slot so packet order is preserved.
+            if (!FlushGroup(Out)) return false;
+            Out.Add(Packet);
+            continue;
+        }
+
+        if (GroupPackets >= MaxPacketsPerGroup)
+        {
+            if (!FlushGroup(Out)) return false;
+        }
+
+        // Fails when the packet would push the group past 120 ms or its TOC config differs: start a new group.
+        if (opus_repacketizer_cat(State, Packet.GetData(), Packet.Num()) != OPUS_OK)
+        {
+            if (!FlushGroup(Out)) return false;
+            if (opus_repacketizer_cat(State, Packet.GetData(), Packet.Num()) != OPUS_OK)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("FOpusRepacketizer: packet %d is not a valid Opus packet"), i);
+                return false;
+            }
+        }
+
+        ++GroupPackets;
+        GroupBytes += Packet.Num();
+    }
+
+    return FlushGroup(Out);
+}
+
+bool FOpusRepacketizer::Split(const FOpusPacketList& In, FOpusPacketList& Out)
+{
+    Out.Reset();
+    if (!State) return false;
+
+    Out.Reserve(In.Num(), In.GetTotalBytes() + In.Num());
+
+    for (int32 i = 0; i < In.Num(); ++i)
+    {
+        const FOpusPacketView Packet = In.GetPacket(i);
+        if (Packet.Num() == 0)
+        {
+            Out.Add(Packet);
+            continue;
+        }
+
+        opus_repacketizer_init(State);
+        if (opus_repacketizer_cat(State, Packet.GetData(), Packet.Num()) != OPUS_OK)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FOpusRepacketizer: packet %d is not a valid Opus packet"), i);
+            return false;
+        }
+
+        const int32 NumFrames = opus_repacketizer_get_nb_frames(State);
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            // A single frame re-emitted as a code 0 packet is never larger than its container.
+            const int32 MaxBytes = Packet.Num() + 1;
+            uint8* Dest = Out.BeginPacket(MaxBytes);
+            const opus_int32 Len = opus_repacketizer_out_range(State, Frame, Frame + 1, Dest, MaxBytes);
+            Out.CommitPacket(FMath::Max<int32>(Len, 0));
+            if (Len < 0)
+            {
+                Out.RemoveLast();
+                return false;
+            }
+        }
+    }
+
+    opus_repacketizer_init(State);
+    return true;
+}
@@ -0,0 +1,252 @@
+#include "OpusResampler.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    constexpr int32 OpusRates[] = { 8000, 12000, 16000, 24000, 48000 };
+
+    // Beyond this many phases the coefficient table stops fitting in cache; such odd ratios are rejected.
+    constexpr int32 MaxPhases = 2048;
+
+    // Passband edge as a fraction of the output Nyquist; the rest is the transition band.
+    constexpr double Rolloff = 0.94;
+    constexpr double KaiserBeta = 8.0;
+
+    int32 Gcd(int32 A, int32 B)
+    {
+        while (B != 0)
+        {
+            const int32 T = A % B;
+            A = B;
+            B = T;
+        }
+        return A;
+    }
+
+    // Zeroth-order modified Bessel function of the first kind (series expansion), for the Kaiser window.
+    double BesselI0(double X)
+    {
+        double Sum = 1.0;
+        double Term = 1.0;
+        const double HalfX = 0.5 * X;
+        for (int32 k = 1; k < 50; ++k)
+        {
+            Term *= (HalfX / k) * (HalfX / k);
+            Sum += Term;
+            if (Term < Sum * 1e-12)
+            {
+                break;
+            }
+        }
+        return Sum;
+    }
+
+    FORCEINLINE float DotScalar(const float* RESTRICT A, const float* RESTRICT B, int32 N)
+    {
+        float Sum = 0.0f;
+        for (int32 j = 0; j < N; ++j)
+        {
+            Sum += A[j] * B[j];
+        }
+        return Sum;
+    }
+
+    // N is a multiple of 4. Two accumulators hide the FMA latency.
+    FORCEINLINE float DotVector(const float* RESTRICT A, const float* RESTRICT B, int32 N)
+    {
+        VectorRegister4Float Acc0 = VectorZeroFloat();
+        VectorRegister4Float Acc1 = VectorZeroFloat();
+
+        int32 j = 0;
+        for (; j + 8 <= N; j += 8)
+        {
+            Acc0 = VectorMultiplyAdd(VectorLoad(A + j), VectorLoad(B + j), Acc0);
+            Acc1 = VectorMultiplyAdd(VectorLoad(A + j + 4), VectorLoad(B + j + 4), Acc1);
+        }
+        for (; j < N; j += 4)
+        {
+            Acc0 = VectorMultiplyAdd(VectorLoad(A + j), VectorLoad(B + j), Acc0);
+        }
+
+        Acc0 = VectorAdd(Acc0, Acc1);
+        Acc0 = VectorAdd(Acc0, VectorSwizzle(Acc0, 2, 3, 0, 1));
+        Acc0 = VectorAdd(Acc0, VectorSwizzle(Acc0, 1, 0, 3, 2));
+
+        float Sum;
+        VectorStoreFloat1(Acc0, &Sum);
+        return Sum;
+    }
+}
+
+bool FOpusResampler::IsOpusRate(int32 SampleRate)
+{
+    for (const int32 Rate : OpusRates)
+    {
+        if (Rate == SampleRate)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 FOpusResampler::GetOpusRateFor(int32 SampleRate)
+{
+    for (const int32 Rate : OpusRates)
+    {
+        if (Rate >= SampleRate)
+        {
+            return Rate;
+        }
+    }
+    return 48000;
+}
+
+bool FOpusResampler::Init(int32 InInRate, int32 InOutRate, int32 InChannels, int32 TapsPerPhase)
+{
+    Channels = 0;
+    Coeffs.Reset();
+
+    if (InInRate <= 0 || InOutRate <= 0 || InChannels <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusResampler: invalid format %d -> %d Hz, %d ch"), InInRate, InOutRate, InChannels);
+        return false;
+    }
+
+    const int32 Div = Gcd(InInRate, InOutRate);
+    const int32 L = InOutRate / Div;
+    const int32 M = InInRate / Div;
+    if (L > MaxPhases)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusResampler: ratio %d/%d needs too many phases"), L, M);
+        return false;
+    }
+
+    InRate = InInRate;
+    OutRate = InOutRate;
+    Channels = InChannels;
+    Up = L;
+    Down = M;
+    Taps = Align(FMath::Max(4, TapsPerPhase), 4);
+
+    // Prototype low-pass at the upsampled rate, centred on N/2 so the output delay is exactly Taps/2 input samples.
+    const int32 N = Taps * L;
+    const double Center = 0.5 * N;
+    const double Cutoff = 0.5 * Rolloff / FMath::Max(L, M); // cycles per upsampled sample
+    const double InvI0Beta = 1.0 / BesselI0(KaiserBeta);
+
+    Coeffs.SetNumUninitialized(N);
+    for (int32 Phase = 0; Phase < L; ++Phase)
+    {
+        float* PhaseCoeffs = Coeffs.GetData() + Phase * Taps;
+        for (int32 j = 0; j < Taps; ++j)
+        {
+            const double T = (Phase + j * L) - Center;
+            const double X = 2.0 * Cutoff * T;
+            const double Sinc = (FMath::Abs(X) < 1e-12) ? 1.0 : FMath::Sin(PI * X) / (PI * X);
+            const double R = T / Center;
+            const double Window = (FMath::Abs(R) <= 1.0) ? BesselI0(KaiserBeta * FMath::Sqrt(1.0 - R * R)) * InvI0Beta : 0.0;
+
+            // Gain L compensates for the zeros inserted by upsampling.
+            PhaseCoeffs[Taps - 1 - j] = (float)(L * 2.0 * Cutoff * Sinc * Window);
+        }
+    }
+
+    return true;
+}
+
+bool FOpusResampler::ProcessChannelMajor(const float* Planar, int32 InFrames, TArray<float>& Out) const
+{
+    const int32 Pad = Taps;
+    const int32 Stride = InFrames + 2 * Pad;
+    const int64 OutFrames64 = ((int64)InFrames * Up + Down - 1) / Down;
+    if (OutFrames64 * Channels > MAX_int32)
+    {
+        return false;
+    }
+    const int32 OutFrames = (int32)OutFrames64;
+
+    Out.SetNumUninitialized(OutFrames * Channels);
+
+    // u = n * M + N/2 in upsampled units; track its phase (u % L) and input index (u / L) incrementally.
+    const int32 StepInt = Down / Up;
+    const int32 StepFrac = Down % Up;
+    const int64 Start = (int64)Taps * Up / 2;
+
+    for (int32 c = 0; c < Channels; ++c)
+    {
+        const float* X = Planar + (int64)c * Stride + Pad - Taps + 1;
+        float* Y = Out.GetData() + c;
+
+        int32 Index = (int32)(Start / Up);
+        int32 Phase = (int32)(Start % Up);
+        for (int32 n = 0; n < OutFrames; ++n)
+        {
+            const float* C = Coeffs.GetData() + Phase * Taps;
+            Y[(int64)n * Channels] = bUseVector ? DotVector(C, X + Index, Taps) : DotScalar(C, X + Index, Taps);
+
+            Index += StepInt;
+            Phase += StepFrac;
+            if (Phase >= Up)
+            {
+                Phase -= Up;
+                ++Index;
+            }
+        }
+    }
+    return true;
+}
+
+bool FOpusResampler::Process(TConstArrayView<float> In, TArray<float>& Out) const
+{
+    Out.Reset();
+    if (!IsValid() || In.Num() % Channels != 0) return false;
+
+    // De-interleave into zero-padded planar rows so each dot product reads contiguous memory.
+    const int32 InFrames = In.Num() / Channels;
+    const int32 Stride = InFrames + 2 * Taps;
+    TArray<float> Planar;
+    Planar.SetNumZeroed(Stride * Channels);
+    for (int32 i = 0; i < InFrames; ++i)
+    {
+        for (int32 c = 0; c < Channels; ++c)
+        {
+            Planar[c * Stride + Taps + i] = In[i * Channels + c];
+        }
+    }
+
+    return ProcessChannelMajor(Planar.GetData(), InFrames, Out);
+}
+
+bool FOpusResampler::Process(TConstArrayView<int16> In, TArray<float>& Out) const
+{
+    Out.Reset();
+    if (!IsValid() || In.Num() % Channels != 0) return false;
+
+    const int32 InFrames = In.Num() / Channels;
+    const int32 Stride = InFrames + 2 * Taps;
+    TArray<float> Planar;
+    Planar.SetNumZeroed(Stride * Channels);
+    for (int32 i = 0; i < InFrames; ++i)
+    {
+        for (int32 c = 0; c < Channels; ++c)
+        {
+            Planar[c * Stride + Taps + i] = In[i * Channels + c] * (1.0f / 32768.0f);
+        }
+    }
+
+    return ProcessChannelMajor(Planar.GetData(), InFrames, Out);
+}
+
+bool FOpusResampler::ResampleToOpusRate(TConstArrayView<float> In, int32 InRate, int32 Channels, TArray<float>& Out, int32& OutRate)
+{
+    OutRate = GetOpusRateFor(InRate);
+    if (OutRate == InRate)
+    {
+        Out = In;
+        return true;
+    }
+
+    FOpusResampler Resampler;
+    return Resampler.Init(InRate, OutRate, Channels) && Resampler.Process(In, Out);
+}
@@ -0,0 +1,58 @@
+#include "OpusStateArena.h"
+
+FOpusStateArena::FOpusStateArena(int32 InSlotSize, int32 InSlotsPerBlock)
+{
+    // Every slot must be able to hold the free-list link and keep the next slot aligned.
+    const int32 MinSize = FMath::Max<int32>(InSlotSize, (int32)sizeof(FFreeSlot));
+    SlotSize = Align(MinSize, SlotAlignment);
+    SlotsPerBlock = FMath::Max(1, InSlotsPerBlock);
+    NextSlotInBlock = SlotsPerBlock; // forces a block allocation on first use
+}
+
+FOpusStateArena::~FOpusStateArena()
+{
+    ensureMsgf(SlotsInUse == 0, TEXT("FOpusStateArena destroyed with %d live slots"), SlotsInUse);
+
+    for (uint8* Block : Blocks)
+    {
+        FMemory::Free(Block);
+    }
+    Blocks.Reset();
+    FreeList = nullptr;
+}
+
+void* FOpusStateArena::Allocate()
+{
+    if (FreeList)
+    {
+        FFreeSlot* Slot = FreeList;
+        FreeList = Slot->Next;
+        ++SlotsInUse;
+        return Slot;
+    }
+
+    if (NextSlotInBlock >= SlotsPerBlock)
+    {
+        const SIZE_T BlockBytes = (SIZE_T)SlotSize * (SIZE_T)SlotsPerBlock;
+        Blocks.Add(static_cast<uint8*>(FMemory::Malloc(BlockBytes, SlotAlignment)));
+        NextSlotInBlock = 0;
+    }
+
+    uint8* Slot = Blocks.Last() + (SIZE_T)NextSlotInBlock * (SIZE_T)SlotSize;
+    ++NextSlotInBlock;
+    ++SlotsInUse;
+    return Slot;
+}
+
+void FOpusStateArena::Free(void* Slot)
+{
+    if (!Slot)
+    {
+        return;
+    }
+
+    FFreeSlot* Node = static_cast<FFreeSlot*>(Slot);
+    Node->Next = FreeList;
+    FreeList = Node;
+    --SlotsInUse;
+}
@@ -0,0 +1,258 @@
+#include "OpusStreamEncoder.h"
+#include "OpusPacketList.h"
+
+namespace
+{
+    inline void ConvertSample(int16 In, float& Out)
+    {
+        Out = In / 32768.0f;
+    }
+    inline void ConvertSample(float In, int16& Out)
+    {
+        Out = (int16)FMath::Clamp(FMath::RoundToInt(In * 32767.0f), -32768, 32767);
+    }
+
+    // Switching sample format mid-frame: carry the staged samples over so no audio is lost.
+    template <typename FromType, typename ToType>
+    void MoveStaged(TArray<FromType>& From, TArray<ToType>& To)
+    {
+        if (From.Num() == 0)
+        {
+            return;
+        }
+
+        const int32 Base = To.Num();
+        To.AddUninitialized(From.Num());
+        for (int32 i = 0; i < From.Num(); ++i)
+        {
+            ConvertSample(From[i], To[Base + i]);
+        }
+        From.Reset();
+    }
+}
+
+bool FOpusStreamEncoder::Init(int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameSizeSamplesPerCh, EOpusEncoderProfile Profile)
+{
+    Release();
+
+    if (FrameSizeSamplesPerCh <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: invalid frame size %d"), FrameSizeSamplesPerCh);
+        return false;
+    }
+
+    Encoder = UAudioReplicatorCodecPoolSubsystem::AcquireEncoder(SampleRate, Channels, Bitrate, Profile);
+    if (!Encoder)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: cannot create encoder (%d Hz, %d ch)"), SampleRate, Channels);
+        return false;
+    }
+
+    FrameSize = FrameSizeSamplesPerCh;
+    SteadyFrameSize = FrameSizeSamplesPerCh;
+    StartupFramesLeft = 0;
+    PaddedSamplesPerCh = 0;
+
+    // One frame of staging is all that is ever needed; allocate it up front so pushes never allocate.
+    Staged16.Reset(FrameSize * Channels);
+    StagedFloat.Reset(FrameSize * Channels);
+    return true;
+}
+
+bool FOpusStreamEncoder::InitCustom(int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameSizeSamplesPerCh, EOpusEncoderProfile Profile)
+{
+    Release();
+
+    Custom = MakeUnique<FOpusCustomEncoder>();
+    if (!Custom->Init(SampleRate, Channels, Bitrate, FrameSizeSamplesPerCh, Profile))
+    {
+        Custom.Reset();
+        return false;
+    }
+
+    FrameSize = FrameSizeSamplesPerCh;
+    SteadyFrameSize = FrameSizeSamplesPerCh;
+    StartupFramesLeft = 0;
+    PaddedSamplesPerCh = 0;
+
+    Staged16.Reset(FrameSize * Channels);
+    StagedFloat.Reset(FrameSize * Channels);
+    return true;
+}
+
+bool FOpusStreamEncoder::SetStartupFrames(int32 StartupFrameSizeSamplesPerCh, int32 NumFrames)
+{
+    if (!IsValid() || Staged16.Num() > 0 || StagedFloat.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: startup frames must be set before the first push"));
+        return false;
+    }
+    if (IsCustom())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: custom-mode streams have a fixed frame size"));
+        return false;
+    }
+    if (StartupFrameSizeSamplesPerCh <= 0 || NumFrames < 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: invalid startup frame size %d"), StartupFrameSizeSamplesPerCh);
+        return false;
+    }
+
+    StartupFramesLeft = NumFrames;
+    FrameSize = (NumFrames > 0) ? StartupFrameSizeSamplesPerCh : SteadyFrameSize;
+
+    const int32 MaxFrameSamples = FMath::Max(FrameSize, SteadyFrameSize) * GetChannels();
+    Staged16.Reserve(MaxFrameSamples);
+    StagedFloat.Reserve(MaxFrameSamples);
+    return true;
+}
+
+void FOpusStreamEncoder::AdvanceFrame()
+{
+    if (StartupFramesLeft > 0 && --StartupFramesLeft == 0)
+    {
+        FrameSize = SteadyFrameSize;
+    }
+}
+
+void FOpusStreamEncoder::Release()
+{
+    Encoder.Release();
+    Custom.Reset();
+    FrameSize = 0;
+    SteadyFrameSize = 0;
+    StartupFramesLeft = 0;
+    Staged16.Empty();
+    StagedFloat.Empty();
+}
+
+bool FOpusStreamEncoder::Reset()
+{
+    Staged16.Reset();
+    StagedFloat.Reset();
+    PaddedSamplesPerCh = 0;
+    return IsCustom() ? Custom->Reset() : (IsValid() && Encoder->Reset());
+}
+
+bool FOpusStreamEncoder::SetBitrate(int32 Bitrate)
+{
+    return IsCustom() ? Custom->SetBitrate(Bitrate) : (IsValid() && Encoder->SetBitrate(Bitrate));
+}
+
+int32 FOpusStreamEncoder::GetBitrate() const
+{
+    return IsCustom() ? Custom->GetBitrate() : (IsValid() ? Encoder->GetBitrate() : 0);
+}
+
+int32 FOpusStreamEncoder::GetSampleRate() const
+{
+    return IsCustom() ? Custom->GetSampleRate() : (IsValid() ? Encoder->GetSampleRate() : 0);
+}
+
+int32 FOpusStreamEncoder::GetChannels() const
+{
+    return IsCustom() ? Custom->GetChannels() : (IsValid() ? Encoder->GetChannels() : 0);
+}
+
+template <typename SampleType>
+bool FOpusStreamEncoder::EncodeFrame(TConstArrayView<SampleType> FramePcm, FOpusPacketList& OutPackets)
+{
+    return IsCustom() ? Custom->EncodeFrame(FramePcm, OutPackets) : Encoder->EncodeFrame(FramePcm, OutPackets);
+}
+
+int32 FOpusStreamEncoder::GetStagedSamplesPerChannel() const
+{
+    const int32 Ch = GetChannels();
+    return (Ch > 0) ? (Staged16.Num() + StagedFloat.Num()) / Ch : 0;
+}
+
+template <typename SampleType>
+int32 FOpusStreamEncoder::PushImpl(TConstArrayView<SampleType> Pcm, TArray<SampleType>& Staging, FOpusPacketList& OutPackets)
+{
+    if (!IsValid()) return INDEX_NONE;
+
+    const int32 Ch = GetChannels();
+    if (Pcm.Num() % Ch != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FOpusStreamEncoder: push of %d samples is not a multiple of %d channels"), Pcm.Num(), Ch);
+        return INDEX_NONE;
+    }
+
+    int32 Emitted = 0;
+    int32 Pos = 0;
+
+    // Top up a partially filled frame first.
+    if (Staging.Num() > 0)
+    {
+        const int32 Take = FMath::Min(FrameSize * Ch - Staging.Num(), Pcm.Num());
+        Staging.Append(Pcm.GetData(), Take);
+        Pos = Take;
+
+        if (Staging.Num() < FrameSize * Ch)
+        {
+            return 0;
+        }
+
+        const bool bOk = EncodeFrame(TConstArrayView<SampleType>(Staging), OutPackets);
+        Staging.Reset();
+        if (!bOk) return INDEX_NONE;
+        AdvanceFrame();
+        ++Emitted;
+    }
+
+    // Whole frames are encoded straight out of the caller's buffer. The size can change between frames.
+    while (Pcm.Num() - Pos >= FrameSize * Ch)
+    {
+        const int32 FrameSamples = FrameSize * Ch;
+        if (!EncodeFrame(Pcm.Slice(Pos, FrameSamples), OutPackets)) return INDEX_NONE;
+        Pos += FrameSamples;
+        AdvanceFrame();
+        ++Emitted;
+    }
+
+    Staging.Append(Pcm.GetData() + Pos, Pcm.Num() - Pos);
+    return Emitted;
+}
+
+template <typename SampleType>
+int32 FOpusStreamEncoder::FlushImpl(TArray<SampleType>& Staging, FOpusPacketList& OutPackets)
+{
+    const int32 FrameSamples = FrameSize * GetChannels();
+    const int32 Padding = FrameSamples - Staging.Num();
+
+    Staging.AddZeroed(Padding);
+    const bool bOk = EncodeFrame(TConstArrayView<SampleType>(Staging), OutPackets);
+    Staging.Reset();
+    if (!bOk) return INDEX_NONE;
+    AdvanceFrame();
+
+    PaddedSamplesPerCh += Padding / GetChannels();
+    return 1;
+}
+
+int32 FOpusStreamEncoder::PushPcm16(TConstArrayView<int16> Pcm, FOpusPacketList& OutPackets)
+{
+    MoveStaged(StagedFloat, Staged16);
+    return PushImpl(Pcm, Staged16, OutPackets);
+}
+
+int32 FOpusStreamEncoder::PushFloat(TConstArrayView<float> Pcm, FOpusPacketList& OutPackets)
+{
+    MoveStaged(Staged16, StagedFloat);
+    return PushImpl(Pcm, StagedFloat, OutPackets);
+}
+
+int32 FOpusStreamEncoder::Flush(FOpusPacketList& OutPackets)
+{
+    if (!IsValid()) return INDEX_NONE;
+
+    if (StagedFloat.Num() > 0)
+    {
+        return FlushImpl(StagedFloat, OutPackets);
+    }
+    if (Staged16.Num() > 0)
+    {
+        return FlushImpl(Staged16, OutPackets);
+    }
+    return 0;
+}
@@ -0,0 +1,723 @@
+#include "PackedClip.h"
+#include "Chunking.h"
+#include "Crc32c.h"
+#include "PcmWavUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Algo/BinarySearch.h"
+#include <opus.h> // ThirdParty/Opus/Include
+
+namespace
+{
+    constexpr uint8 Magic[4] = { 'A', 'R', 'P', 'K' };
+
+    enum EContainerFlags : uint8
+    {
+        FlagChecksums = 1 << 0,
+        FlagIndex = 1 << 1,
+    };
+    constexpr uint8 KnownFlags = FlagChecksums | FlagIndex;
+
+    constexpr int32 ChecksumBytes = 4;
+
+    // Worst case for a 32-bit varint.
+    constexpr int32 MaxVarintBytes = 5;
+
+    void WriteVarint(TArray<uint8>& Out, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Out.Add((uint8)(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.Add((uint8)Value);
+    }
+
+    int32 GetVarintSize(uint32 Value)
+    {
+        int32 Size = 1;
+        while (Value >= 0x80)
+        {
+            Value >>= 7;
+            ++Size;
+        }
+        return Size;
+    }
+
+    void WriteSigned(TArray<uint8>& Out, int32 Value)
+    {
+        WriteVarint(Out, ((uint32)Value << 1) ^ (uint32)(Value >> 31));
+    }
+
+    void WriteUInt32(TArray<uint8>& Out, uint32 Value)
+    {
+        Out.Add((uint8)(Value & 0xFF));
+        Out.Add((uint8)((Value >> 8) & 0xFF));
+        Out.Add((uint8)((Value >> 16) & 0xFF));
+        Out.Add((uint8)((Value >> 24) & 0xFF));
+    }
+
+    void WriteFloat(TArray<uint8>& Out, float Value)
+    {
+        uint32 Bits;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        WriteUInt32(Out, Bits);
+    }
+
+    void WriteBytes(TArray<uint8>& Out, TConstArrayView<uint8> Bytes)
+    {
+        WriteVarint(Out, (uint32)Bytes.Num());
+        Out.Append(Bytes.GetData(), Bytes.Num());
+    }
+
+    // Field order is part of version 1. New fields go at the end: older readers skip what they do not know.
+    void WriteHeader(TArray<uint8>& Out, const FOpusStreamHeader& Header)
+    {
+        WriteSigned(Out, Header.SampleRate);
+        WriteSigned(Out, Header.Channels);
+        WriteSigned(Out, Header.Bitrate);
+        WriteFloat(Out, Header.FrameMs);
+        WriteSigned(Out, Header.SourceSampleRate);
+        WriteSigned(Out, Header.FramesPerPacket);
+        WriteVarint(Out, (uint32)Header.Profile);
+        WriteFloat(Out, Header.StartupFrameMs);
+        WriteSigned(Out, Header.StartupFrames);
+        WriteSigned(Out, Header.Streams);
+        WriteSigned(Out, Header.CoupledStreams);
+        WriteBytes(Out, Header.ChannelMapping);
+        WriteSigned(Out, Header.MappingFamily);
+        WriteBytes(Out, Header.DemixingMatrix);
+        WriteVarint(Out, (uint32)Header.CodecMode);
+        WriteSigned(Out, Header.PreSkip);
+        WriteSigned(Out, Header.EndTrim);
+    }
+
+    // Bounds-checked cursor over a container; every read fails instead of running past End.
+    struct FReader
+    {
+        const uint8* Data = nullptr;
+        int32 Pos = 0;
+        int32 End = 0;
+
+        bool ReadByte(uint8& Out)
+        {
+            if (Pos >= End) return false;
+            Out = Data[Pos++];
+            return true;
+        }
+
+        bool ReadVarint(uint32& Out)
+        {
+            Out = 0;
+            for (int32 i = 0; i < MaxVarintBytes; ++i)
+            {
+                uint8 Byte;
+                if (!ReadByte(Byte)) return false;
+                // The fifth byte may only carry the top 4 bits.
+                if (i == MaxVarintBytes - 1 && Byte > 0x0F) return false;
+
+                Out |= (uint32)(Byte & 0x7F) << (7 * i);
+                if ((Byte & 0x80) == 0) return true;
+            }
+            return false;
+        }
+
+        // Lengths and counts: also rejects values that do not fit an int32.
+        bool ReadCount(int32& Out)
+        {
+            uint32 Value;
+            if (!ReadVarint(Value) || Value > (uint32)MAX_int32) return false;
+            Out = (int32)Value;
+            return true;
+        }
+
+        bool ReadSigned(int32& Out)
+        {
+            uint32 Value;
+            if (!ReadVarint(Value)) return false;
+            Out = (int32)((Value >> 1) ^ (0u - (Value & 1)));
+            return true;
+        }
+
+        bool ReadUInt32(uint32& Out)
+        {
+            if (End - Pos < 4) return false;
+            Out = (uint32)Data[Pos] | ((uint32)Data[Pos + 1] << 8) | ((uint32)Data[Pos + 2] << 16) | ((uint32)Data[Pos + 3] << 24);
+            Pos += 4;
+            return true;
+        }
+
+        bool ReadFloat(float& Out)
+        {
+            uint32 Bits;
+            if (!ReadUInt32(Bits)) return false;
+            FMemory::Memcpy(&Out, &Bits, sizeof(Out));
+            return FMath::IsFinite(Out);
+        }
+
+        bool ReadBytes(TArray<uint8>& Out)
+        {
+            int32 Num;
+            if (!ReadCount(Num) || Num > End - Pos) return false;
+            Out.Reset(Num);
+            Out.Append(Data + Pos, Num);
+            Pos += Num;
+            return true;
+        }
+
+        template <typename EnumType>
+        bool ReadEnum(EnumType& Out)
+        {
+            uint32 Value;
+            if (!ReadVarint(Value) || Value > 0xFF) return false;
+            Out = (EnumType)Value;
+            return true;
+        }
+    };
+
+    bool ReadHeader(FReader& Reader, FOpusStreamHeader& Out)
+    {
+        return Reader.ReadSigned(Out.SampleRate)
+            && Reader.ReadSigned(Out.Channels)
+            && Reader.ReadSigned(Out.Bitrate)
+            && Reader.ReadFloat(Out.FrameMs)
+            && Reader.ReadSigned(Out.SourceSampleRate)
+            && Reader.ReadSigned(Out.FramesPerPacket)
+            && Reader.ReadEnum(Out.Profile)
+            && Reader.ReadFloat(Out.StartupFrameMs)
+            && Reader.ReadSigned(Out.StartupFrames)
+            && Reader.ReadSigned(Out.Streams)
+            && Reader.ReadSigned(Out.CoupledStreams)
+            && Reader.ReadBytes(Out.ChannelMapping)
+            && Reader.ReadSigned(Out.MappingFamily)
+            && Reader.ReadBytes(Out.DemixingMatrix)
+            && Reader.ReadEnum(Out.CodecMode)
+            // Trims were added later; headers written before them end here.
+            && (Reader.Pos >= Reader.End || (Reader.ReadSigned(Out.PreSkip) && Reader.ReadSigned(Out.EndTrim)));
+    }
+
+    bool VerifyChecksum(FReader& Reader, int32 Start, const TCHAR* What)
+    {
+        const uint32 Actual = Crc32c::Compute(Reader.Data + Start, Reader.Pos - Start);
+        uint32 Stored;
+        if (!Reader.ReadUInt32(Stored))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated %s checksum"), What);
+            return false;
+        }
+        if (Stored != Actual)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: %s checksum mismatch at byte %d"), What, Start);
+            return false;
+        }
+        return true;
+    }
+
+    // Duration of packet Index in samples per channel at the stream rate. Empty packets and anything libopus cannot
+    // parse count as one nominal frame, which is also how the decoders conceal them. Writer and reader must agree.
+    int32 GetPacketSamples(const FOpusStreamHeader& Header, int32 Index, FOpusPacketView Packet)
+    {
+        const int32 Nominal = GetOpusFrameSamples(Header.SampleRate, GetOpusFrameMsAt(Header, Index));
+        if (Packet.Num() == 0 || IsOpusCustom(Header))
+            return Nominal;
+
+        // Multistream packets start with the first stream's TOC, which fixes the duration of all of them.
+        const int Samples = opus_packet_get_nb_samples(Packet.GetData(), Packet.Num(), Header.SampleRate);
+        return Samples > 0 ? Samples : Nominal;
+    }
+
+    // Everything before the first block.
+    struct FPreamble
+    {
+        FOpusStreamHeader Header; // NumPackets included
+        bool bChecksums = false;
+        int32 PacketsPerBlock = 0;
+        int32 NumBlocks = 0;
+        int32 BlocksStart = 0;
+        TArray<PackedClip::FBlockIndexEntry> Index; // empty when the container was written without one
+        int64 TotalSamples = 0;                      // only known with an index
+    };
+
+    bool ReadPreamble(TConstArrayView<uint8> Buffer, FPreamble& Out)
+    {
+        FReader Reader{ Buffer.GetData(), (int32)sizeof(Magic), Buffer.Num() };
+
+        uint8 Version = 0, Flags = 0;
+        if (!Reader.ReadByte(Version) || !Reader.ReadByte(Flags))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated preamble"));
+            return false;
+        }
+        if (Version != PackedClip::FormatVersion || (Flags & ~KnownFlags) != 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: unsupported version %d (flags 0x%02x)"), Version, Flags);
+            return false;
+        }
+        Out.bChecksums = (Flags & FlagChecksums) != 0;
+
+        int32 HeaderBytes = 0;
+        if (!Reader.ReadCount(HeaderBytes) || HeaderBytes > Reader.End - Reader.Pos)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated stream header"));
+            return false;
+        }
+
+        FReader HeaderReader{ Reader.Data, Reader.Pos, Reader.Pos + HeaderBytes };
+        if (!ReadHeader(HeaderReader, Out.Header))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: malformed stream header"));
+            return false;
+        }
+        Reader.Pos += HeaderBytes;
+
+        int32 NumPackets = 0;
+        if (!Reader.ReadCount(NumPackets) || !Reader.ReadCount(Out.PacketsPerBlock) || Out.PacketsPerBlock == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated preamble"));
+            return false;
+        }
+        Out.Header.NumPackets = NumPackets;
+        Out.NumBlocks = (int32)(((int64)NumPackets + Out.PacketsPerBlock - 1) / Out.PacketsPerBlock);
+
+        // Each packet costs at least its length byte and each index entry two bytes, which bounds hostile
+        // counts before anything is reserved.
+        if (NumPackets > Reader.End - Reader.Pos)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: %d packets cannot fit in %d bytes"), NumPackets, Reader.End - Reader.Pos);
+            return false;
+        }
+
+        if (Flags & FlagIndex)
+        {
+            if ((int64)Out.NumBlocks * 2 > Reader.End - Reader.Pos)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated block index"));
+                return false;
+            }
+
+            Out.Index.SetNum(Out.NumBlocks);
+            int64 Offset = 0;
+            for (PackedClip::FBlockIndexEntry& Entry : Out.Index)
+            {
+                int32 Samples = 0;
+                if (!Reader.ReadCount(Entry.Size) || !Reader.ReadCount(Samples))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated block index"));
+                    return false;
+                }
+                Entry.Offset = (int32)FMath::Min<int64>(Offset, MAX_int32);
+                Entry.FirstSample = Out.TotalSamples;
+                Offset += Entry.Size;
+                Out.TotalSamples += Samples;
+            }
+        }
+
+        if (Out.bChecksums && !VerifyChecksum(Reader, 0, TEXT("preamble")))
+            return false;
+
+        Out.BlocksStart = Reader.Pos;
+        if (Out.Index.Num() > 0)
+        {
+            const int64 BlockBytes = (int64)Out.Index.Last().Offset + Out.Index.Last().Size;
+            if (BlockBytes != Reader.End - Reader.Pos)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("PackedClip: block index covers %lld bytes, clip has %d"), BlockBytes, Reader.End - Reader.Pos);
+                return false;
+            }
+            for (PackedClip::FBlockIndexEntry& Entry : Out.Index)
+            {
+                Entry.Offset += Out.BlocksStart;
+            }
+        }
+        return true;
+    }
+
+    // Parse block Block starting at Reader.Pos: Visit(Offset, Length) for each packet, then the checksum.
+    template <typename VisitorType>
+    bool ReadBlock(FReader& Reader, int32 NumPackets, int32 PacketsPerBlock, bool bChecksums, int32 Block, VisitorType&& Visit)
+    {
+        const int32 BlockStart = Reader.Pos;
+        const int64 First = (int64)Block * PacketsPerBlock;
+        const int64 Last = FMath::Min<int64>(NumPackets, First + PacketsPerBlock);
+        for (int64 Index = First; Index < Last; ++Index)
+        {
+            int32 Length = 0;
+            if (!Reader.ReadCount(Length) || Length > Reader.End - Reader.Pos)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("PackedClip: truncated packet %lld"), Index);
+                return false;
+            }
+            Visit(Reader.Pos, Length);
+            Reader.Pos += Length;
+        }
+        return !bChecksums || VerifyChecksum(Reader, BlockStart, TEXT("block"));
+    }
+
+    /**
+     * Single validation pass over a container: parses the preamble into Header (NumPackets included), then
+     * calls Visit(Offset, Length) for every packet in order. Fails on any truncation, checksum mismatch,
+     * index disagreement or trailing byte; packets visited before a failure are not rolled back.
+     */
+    template <typename VisitorType>
+    bool ParseContainer(TConstArrayView<uint8> Buffer, FOpusStreamHeader& Header, VisitorType&& Visit)
+    {
+        FPreamble Preamble;
+        if (!ReadPreamble(Buffer, Preamble))
+            return false;
+
+        Header = Preamble.Header;
+
+        // With an index, block durations are summed as we go and must match it, or seeks would land off time.
+        const bool bHaveIndex = Preamble.Index.Num() > 0;
+        int32 PacketIndex = 0;
+        int64 BlockSamples = 0;
+        auto VisitAndCount = [&](int32 Offset, int32 Length)
+        {
+            if (bHaveIndex)
+            {
+                BlockSamples += GetPacketSamples(Preamble.Header, PacketIndex, FOpusPacketView(Buffer.GetData() + Offset, Length));
+            }
+            ++PacketIndex;
+            Visit(Offset, Length);
+        };
+
+        FReader Reader{ Buffer.GetData(), Preamble.BlocksStart, Buffer.Num() };
+        for (int32 Block = 0; Block < Preamble.NumBlocks; ++Block)
+        {
+            BlockSamples = 0;
+            if (!ReadBlock(Reader, Preamble.Header.NumPackets, Preamble.PacketsPerBlock, Preamble.bChecksums, Block, VisitAndCount))
+                return false;
+
+            if (bHaveIndex)
+            {
+                const PackedClip::FBlockIndexEntry& Entry = Preamble.Index[Block];
+                if (Reader.Pos - Entry.Offset != Entry.Size)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("PackedClip: block %d is %d bytes, index says %d"), Block, Reader.Pos - Entry.Offset, Entry.Size);
+                    return false;
+                }
+                const int64 IndexSamples = (Block + 1 < Preamble.NumBlocks ? Preamble.Index[Block + 1].FirstSample : Preamble.TotalSamples) - Entry.FirstSample;
+                if (BlockSamples != IndexSamples)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("PackedClip: block %d is %lld samples, index says %lld"), Block, BlockSamples, IndexSamples);
+                    return false;
+                }
+            }
+        }
+
+        if (Reader.Pos != Reader.End)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: trailing bytes (%d)"), Reader.End - Reader.Pos);
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace PackedClip
+{
+    bool IsContainer(TConstArrayView<uint8> Buffer)
+    {
+        return Buffer.Num() >= (int32)sizeof(Magic) && FMemory::Memcmp(Buffer.GetData(), Magic, sizeof(Magic)) == 0;
+    }
+
+    void Pack(const FOpusStreamHeader& Header, const FOpusPacketList& Packets, TArray<uint8>& OutBuffer, const FPackOptions& Options)
+    {
+        const int32 PacketsPerBlock = FMath::Max(1, Options.PacketsPerBlock);
+        const int32 NumBlocks = (Packets.Num() + PacketsPerBlock - 1) / PacketsPerBlock;
+
+        // Block sizes are known up front (varint lengths + payloads + checksum), so the index goes into the
+        // preamble without a second buffer.
+        TArray<TPair<int32, int32>> Index; // bytes, samples
+        if (Options.bIndex)
+        {
+            Index.Reserve(NumBlocks);
+            for (int32 First = 0; First < Packets.Num(); First += PacketsPerBlock)
+            {
+                int32 Bytes = Options.bChecksums ? ChecksumBytes : 0;
+                int32 Samples = 0;
+                const int32 Last = FMath::Min(Packets.Num(), First + PacketsPerBlock);
+                for (int32 i = First; i < Last; ++i)
+                {
+                    const FOpusPacketView Packet = Packets.GetPacket(i);
+                    Bytes += GetVarintSize((uint32)Packet.Num()) + Packet.Num();
+                    Samples += GetPacketSamples(Header, i, Packet);
+                }
+                Index.Emplace(Bytes, Samples);
+            }
+        }
+
+        OutBuffer.Reset();
+        OutBuffer.Reserve(64 + Header.ChannelMapping.Num() + Header.DemixingMatrix.Num() + Index.Num() * 6
+            + Packets.Num() * 2 + Packets.GetTotalBytes() + NumBlocks * ChecksumBytes);
+
+        OutBuffer.Append(Magic, sizeof(Magic));
+        OutBuffer.Add(FormatVersion);
+        OutBuffer.Add((uint8)((Options.bChecksums ? FlagChecksums : 0) | (Options.bIndex ? FlagIndex : 0)));
+
+        TArray<uint8> HeaderBytes;
+        WriteHeader(HeaderBytes, Header);
+        WriteBytes(OutBuffer, HeaderBytes);
+
+        WriteVarint(OutBuffer, (uint32)Packets.Num());
+        WriteVarint(OutBuffer, (uint32)PacketsPerBlock);
+        for (const TPair<int32, int32>& Entry : Index)
+        {
+            WriteVarint(OutBuffer, (uint32)Entry.Key);
+            WriteVarint(OutBuffer, (uint32)Entry.Value);
+        }
+        if (Options.bChecksums)
+        {
+            WriteUInt32(OutBuffer, Crc32c::Compute(OutBuffer.GetData(), OutBuffer.Num()));
+        }
+
+        for (int32 First = 0; First < Packets.Num(); First += PacketsPerBlock)
+        {
+            const int32 BlockStart = OutBuffer.Num();
+            const int32 Last = FMath::Min(Packets.Num(), First + PacketsPerBlock);
+            for (int32 i = First; i < Last; ++i)
+            {
+                const FOpusPacketView Packet = Packets.GetPacket(i);
+                WriteVarint(OutBuffer, (uint32)Packet.Num());
+                OutBuffer.Append(Packet.GetData(), Packet.Num());
+            }
+            if (Options.bChecksums)
+            {
+                WriteUInt32(OutBuffer, Crc32c::Compute(OutBuffer.GetData() + BlockStart, OutBuffer.Num() - BlockStart));
+            }
+        }
+    }
+
+    bool UnpackViews(TConstArrayView<uint8> Buffer, FOpusStreamHeader& InOutHeader, TArray<FOpusPacketView>& OutViews)
+    {
+        if (!IsContainer(Buffer))
+            return Chunking::UnpackViews(Buffer, OutViews);
+
+        OutViews.Reset();
+        FOpusStreamHeader Header;
+        const uint8* Data = Buffer.GetData();
+        const bool bOk = ParseContainer(Buffer, Header, [&OutViews, &Header, Data](int32 Offset, int32 Length)
+        {
+            if (OutViews.Num() == 0)
+            {
+                OutViews.Reserve(Header.NumPackets);
+            }
+            OutViews.Add(FOpusPacketView(Data + Offset, Length));
+        });
+
+        if (!bOk)
+        {
+            OutViews.Reset();
+            return false;
+        }
+        InOutHeader = MoveTemp(Header);
+        return true;
+    }
+
+    bool Unpack(TConstArrayView<uint8> Buffer, FOpusStreamHeader& InOutHeader, FOpusPacketList& OutPackets)
+    {
+        OutPackets.Reset();
+
+        TArray<FOpusPacketView> Views;
+        if (!UnpackViews(Buffer, InOutHeader, Views))
+            return false;
+
+        // Payload bytes never exceed the buffer size, so the byte store is allocated once.
+        OutPackets.Reserve(Views.Num(), Buffer.Num());
+        for (const FOpusPacketView& View : Views)
+        {
+            OutPackets.Add(View);
+        }
+        return true;
+    }
+
+    bool Unpack(const FOpusPacketList::FSharedBuffer& Buffer, FOpusStreamHeader& InOutHeader, FOpusPacketList& OutPackets)
+    {
+        if (!IsContainer(*Buffer))
+            return Chunking::UnpackWithLengths(Buffer, OutPackets);
+
+        OutPackets.ResetShared(Buffer);
+        FOpusStreamHeader Header;
+        const bool bOk = ParseContainer(*Buffer, Header, [&OutPackets](int32 Offset, int32 Length)
+        {
+            OutPackets.AddShared(Offset, Length);
+        });
+
+        if (!bOk)
+        {
+            OutPackets.Reset();
+            return false;
+        }
+        InOutHeader = MoveTemp(Header);
+        return true;
+    }
+
+    bool SaveToFile(const FString& InPath, const FOpusStreamHeader& Header, const FOpusPacketList& Packets, const FPackOptions& Options)
+    {
+        TArray<uint8> Buffer;
+        Pack(Header, Packets, Buffer, Options);
+
+        const FString FullPath = PcmWav::ResolveProjectPath_V3(InPath);
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), /*Tree=*/true);
+        if (!FFileHelper::SaveArrayToFile(Buffer, *FullPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip::SaveToFile: failed to save %s"), *FullPath);
+            return false;
+        }
+        return true;
+    }
+}
+
+bool FPackedClipReader::Open(TConstArrayView<uint8> InBuffer)
+{
+    Buffer = TConstArrayView<uint8>();
+    Blocks.Reset();
+    TotalSamples = 0;
+
+    if (!PackedClip::IsContainer(InBuffer))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FPackedClipReader: not a packed clip container"));
+        return false;
+    }
+
+    FPreamble Preamble;
+    if (!ReadPreamble(InBuffer, Preamble))
+        return false;
+
+    if (Preamble.Index.Num() == 0 && Preamble.NumBlocks > 0)
+    {
+        // Written without an index: build it with one pass over the packets.
+        const uint8* Data = InBuffer.GetData();
+        FReader Reader{ Data, Preamble.BlocksStart, InBuffer.Num() };
+        Preamble.Index.SetNum(Preamble.NumBlocks);
+
+        int32 PacketIndex = 0;
+        for (int32 Block = 0; Block < Preamble.NumBlocks; ++Block)
+        {
+            PackedClip::FBlockIndexEntry& Entry = Preamble.Index[Block];
+            Entry.Offset = Reader.Pos;
+            Entry.FirstSample = Preamble.TotalSamples;
+
+            const bool bOk = ReadBlock(Reader, Preamble.Header.NumPackets, Preamble.PacketsPerBlock, Preamble.bChecksums, Block,
+                [&Preamble, &PacketIndex, Data](int32 Offset, int32 Length)
+                {
+                    Preamble.TotalSamples += GetPacketSamples(Preamble.Header, PacketIndex++, FOpusPacketView(Data + Offset, Length));
+                });
+            if (!bOk)
+                return false;
+
+            Entry.Size = Reader.Pos - Entry.Offset;
+        }
+
+        if (Reader.Pos != Reader.End)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("PackedClip: trailing bytes (%d)"), Reader.End - Reader.Pos);
+            return false;
+        }
+    }
+
+    Buffer = InBuffer;
+    Header = MoveTemp(Preamble.Header);
+    bChecksums = Preamble.bChecksums;
+    PacketsPerBlock = Preamble.PacketsPerBlock;
+    TotalSamples = Preamble.TotalSamples;
+    Blocks = MoveTemp(Preamble.Index);
+    return true;
+}
+
+bool FPackedClipReader::ReadRange(int64 StartSample, int64 EndSample, TArray<FOpusPacketView>& OutViews, int32& OutFirstPacket, int64& OutFirstSample) const
+{
+    OutViews.Reset();
+    OutFirstPacket = 0;
+    OutFirstSample = 0;
+    if (!IsOpen())
+        return false;
+
+    StartSample = FMath::Clamp<int64>(StartSample, 0, TotalSamples);
+    EndSample = FMath::Clamp<int64>(EndSample, StartSample, TotalSamples);
+
+    // Last block that starts at or before StartSample.
+    const int32 FirstBlock = FMath::Max(0, Algo::UpperBoundBy(Blocks, StartSample, &PackedClip::FBlockIndexEntry::FirstSample) - 1);
+
+    const uint8* Data = Buffer.GetData();
+    for (int32 Block = FirstBlock; Block < Blocks.Num() && Blocks[Block].FirstSample < EndSample; ++Block)
+    {
+        const PackedClip::FBlockIndexEntry& Entry = Blocks[Block];
+        FReader Reader{ Data, Entry.Offset, Entry.Offset + Entry.Size };
+
+        int32 PacketIndex = Block * PacketsPerBlock;
+        int64 Sample = Entry.FirstSample;
+        const bool bOk = ReadBlock(Reader, Header.NumPackets, PacketsPerBlock, bChecksums, Block,
+            [&](int32 Offset, int32 Length)
+            {
+                const FOpusPacketView Packet(Data + Offset, Length);
+                const int32 Samples = GetPacketSamples(Header, PacketIndex, Packet);
+                if (Sample + Samples > StartSample && Sample < EndSample)
+                {
+                    if (OutViews.Num() == 0)
+                    {
+                        OutFirstPacket = PacketIndex;
+                        OutFirstSample = Sample;
+                    }
+                    OutViews.Add(Packet);
+                }
+                Sample += Samples;
+                ++PacketIndex;
+            });
+
+        if (!bOk || Reader.Pos != Reader.End)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FPackedClipReader: block %d does not match the index"), Block);
+            OutViews.Reset();
+            return false;
+        }
+    }
+    return true;
+}
+
+int32 FPackedClipReader::GetPacketSampleCount(int32 PacketIndex, FOpusPacketView Packet) const
+{
+    return GetPacketSamples(Header, PacketIndex, Packet);
+}
+
+bool FMappedPackedClip::Open(const FString& InPath)
+{
+    Close();
+
+    const FString Path = PcmWav::ResolveProjectPath_V3(InPath);
+    if (File.Open(Path))
+    {
+        if (File.GetSize() > MAX_int32)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FMappedPackedClip: %s is larger than 2 GB"), *Path);
+            Close();
+            return false;
+        }
+        Buffer = TConstArrayView<uint8>(File.GetData(), (int32)File.GetSize());
+    }
+    else
+    {
+        if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FMappedPackedClip: read failed: %s"), *Path);
+            return false;
+        }
+        Buffer = Bytes;
+    }
+
+    if (!Reader.Open(Buffer))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void FMappedPackedClip::Close()
+{
+    Reader = FPackedClipReader();
+    Buffer = TConstArrayView<uint8>();
+    File.Close();
+    Bytes.Empty();
+}
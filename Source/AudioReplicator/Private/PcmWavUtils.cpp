@@ -5,22 +5,30 @@
 
 // Lightweight utilities for reading and writing PCM16 WAV (RIFF/WAVE) files.
 //
-// This module provides two primary functions:
+// This module provides these primary functions:
 // - PcmWav::LoadWavFileToPcm16: Parse a WAV file on disk and extract
 //   interleaved PCM16 samples, sample rate, and channel count.
+// - PcmWav::LoadWavFileToFloat: Same, but produce float samples for the
+//   float Opus path (also accepts 32-bit IEEE float WAVs).
 // - PcmWav::SavePcm16ToWavFile: Serialize interleaved PCM16 samples to a
 //   standard RIFF/WAVE file on disk.
+// - PcmWav::FWavFileView: Parse a memory-mapped WAV file and expose its
+//   samples in place; the loaders above read through it.
 //
 // Notes and assumptions:
-// - Only uncompressed PCM format (AudioFormat = 1) is supported.
-// - Only 16-bit samples are supported.
-// - Only mono or stereo (1 or 2 channels) is supported.
+// - Only uncompressed PCM format (AudioFormat = 1) is supported, plus
+//   IEEE float (AudioFormat = 3) in the float loader. WAVE_FORMAT_EXTENSIBLE
+//   files are accepted when their sub-format is one of these.
+// - Only 16-bit samples are supported (32-bit for IEEE float).
+// - 1 to 8 channels (up to 7.1) in WAV channel order; files with more than
+//   two channels are written as WAVE_FORMAT_EXTENSIBLE.
 // - Endianness: WAV is little-endian; helpers read/write LE explicitly.
 // - The code performs basic validation of RIFF/WAVE headers and chunk bounds
 //   and logs warnings via UE_LOG on failure, returning false.
 //
 // The implementation avoids allocations where possible and uses simple
-// byte-wise parsing of the RIFF chunk structure.
+// byte-wise parsing of the RIFF chunk structure. Files are memory-mapped
+// when the platform allows it, so the only copy made is the caller's output.
 
 namespace
 {
@@ -47,6 +55,141 @@ namespace
     {
         return p[0] == (uint8)tag[0] && p[1] == (uint8)tag[1] && p[2] == (uint8)tag[2] && p[3] == (uint8)tag[3];
     }
+
+    constexpr uint16 WavFormatPcm = 1;
+    constexpr uint16 WavFormatFloat = 3;
+    constexpr uint16 WavFormatExtensible = 0xFFFE;
+    constexpr int32 WavMaxChannels = 8;
+
+    // dwChannelMask for the default layouts of 1..8 channels (mono, stereo, 3.0, quad, 5.0, 5.1, 6.1, 7.1).
+    constexpr uint32 WavChannelMasks[WavMaxChannels] = { 0x4, 0x3, 0x7, 0x33, 0x37, 0x3F, 0x70F, 0x63F };
+
+    // KSDATAFORMAT_SUBTYPE_PCM minus its first two bytes (the format tag).
+    constexpr uint8 WavSubFormatTail[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+
+    // Location and format of the sample payload inside a parsed RIFF/WAVE image.
+    struct FWavInfo
+    {
+        int32 AudioFormat = 0;
+        int32 Channels = 0;
+        int32 SampleRate = 0;
+        int32 BitsPerSample = 0;
+        const uint8* Data = nullptr;
+        uint32 DataSize = 0;
+    };
+
+    /**
+     * Walk the RIFF chunk list of an in-memory WAV image and locate the "fmt " and "data" chunks.
+     * Accepts 16-bit PCM, and 32-bit IEEE float when bAllowFloat is set. Logs with Context as prefix.
+     */
+    bool ParseWav(const uint8* p, int64 Size, const TCHAR* Context, const FString& Path, bool bAllowFloat, FWavInfo& Out)
+    {
+        const uint8* end = p + Size;
+
+        // Validate RIFF/WAVE header
+        if (Size < 12 || !Match4(p, "RIFF"))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: not RIFF %s"), Context, *Path);
+            return false;
+        }
+        uint32 riffSize = ReadU32LE(p + 4); (void)riffSize;
+        if (!Match4(p + 8, "WAVE"))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: not WAVE %s"), Context, *Path);
+            return false;
+        }
+        const uint8* cursor = p + 12;
+
+        // Scan for required chunks: "fmt " and "data"
+        bool haveFmt = false, haveData = false;
+
+        while (cursor + 8 <= end)
+        {
+            const uint8* chunkId = cursor;
+            uint32 chunkSize = ReadU32LE(cursor + 4);
+            const uint8* chunkData = cursor + 8;
+            if ((int64)chunkSize > (int64)(end - chunkData))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("%s: truncated chunk"), Context);
+                return false;
+            }
+            const uint8* next = chunkData + chunkSize;
+
+            if (Match4(chunkId, "fmt "))
+            {
+                // PCM format chunk (at least 16 bytes for PCM)
+                if (chunkSize < 16)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s: fmt chunk too small"), Context);
+                    return false;
+                }
+                uint16 audioFormat = ReadU16LE(chunkData + 0);
+                uint16 numChannels = ReadU16LE(chunkData + 2);
+                uint32 sampleRate = ReadU32LE(chunkData + 4);
+                /*uint32 byteRate    =*/ ReadU32LE(chunkData + 8);
+                /*uint16 blockAlign  =*/ ReadU16LE(chunkData + 12);
+                uint16 bitsPerSample = ReadU16LE(chunkData + 14);
+
+                // Extensible: the real format tag is the first two bytes of the sub-format GUID.
+                if (audioFormat == WavFormatExtensible)
+                {
+                    if (chunkSize < 40)
+                    {
+                        UE_LOG(LogTemp, Warning, TEXT("%s: extensible fmt chunk too small"), Context);
+                        return false;
+                    }
+                    audioFormat = ReadU16LE(chunkData + 24);
+                }
+
+                const bool bPcm16 = (audioFormat == WavFormatPcm && bitsPerSample == 16);
+                const bool bFloat32 = (audioFormat == WavFormatFloat && bitsPerSample == 32);
+                if (audioFormat != WavFormatPcm && !(bAllowFloat && audioFormat == WavFormatFloat))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s: only PCM supported (format=%u)"), Context, (unsigned)audioFormat);
+                    return false;
+                }
+                if (!bPcm16 && !(bAllowFloat && bFloat32))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s: only 16-bit PCM supported (bps=%u)"), Context, (unsigned)bitsPerSample);
+                    return false;
+                }
+                if (numChannels < 1 || numChannels > WavMaxChannels)
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("%s: unsupported channels=%u"), Context, (unsigned)numChannels);
+                    return false;
+                }
+
+                Out.AudioFormat = (int32)audioFormat;
+                Out.Channels = (int32)numChannels;
+                Out.SampleRate = (int32)sampleRate;
+                Out.BitsPerSample = (int32)bitsPerSample;
+                haveFmt = true;
+            }
+            else if (Match4(chunkId, "data"))
+            {
+                Out.Data = chunkData;
+                Out.DataSize = chunkSize;
+                haveData = true;
+            }
+
+            // Chunks are word-aligned: advance by size plus pad byte if size is odd.
+            cursor = next + (chunkSize & 1 ? 1 : 0);
+        }
+
+        if (!haveFmt || !haveData || Out.Data == nullptr)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: missing fmt or data chunk"), Context);
+            return false;
+        }
+
+        if (Out.Channels <= 0 || Out.SampleRate <= 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: bad fmt parameters"), Context);
+            return false;
+        }
+
+        return true;
+    }
 }
 
 namespace PcmWav
@@ -115,7 +258,7 @@ namespace PcmWav
      * Supported formats:
      * - AudioFormat = 1 (PCM)
      * - BitsPerSample = 16
-     * - Channels = 1 or 2
+     * - Channels = 1..8 (WAV channel order, e.g. FL FR FC LFE BL BR for 5.1)
      *
      * On success, fills OutPcm with interleaved int16 samples, sets OutSR to the
      * sample rate and OutCh to the channel count, and returns true. On failure,
@@ -125,149 +268,155 @@ namespace PcmWav
     {
         OutPcm.Reset(); OutSR = 0; OutCh = 0;
 
-        const FString Path = ResolveProjectPath_V3(InPath);
-        UE_LOG(LogTemp, Display, TEXT("LoadWavFileToPcm16: '%s' -> '%s'"), *InPath, *Path);
-
-        if (!FPaths::FileExists(Path))
+        FWavFileView Wav;
+        if (!Wav.Open(InPath, /*bAllowFloat=*/false, TEXT("LoadWavFileToPcm16")))
         {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: file not found: %s"), *Path);
             return false;
         }
 
+        // Copy PCM payload as int16 little-endian samples (interleaved by channel).
+        const TConstArrayView<int16> Pcm = Wav.GetPcm16();
+        OutPcm.Append(Pcm.GetData(), Pcm.Num());
 
-        TArray<uint8> Bytes;
-        if (!FFileHelper::LoadFileToArray(Bytes, *Path))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: read failed: %s"), *Path);
-            return false;
-        }
+        OutSR = Wav.GetSampleRate();
+        OutCh = Wav.GetChannels();
+
+        return true;
+    }
 
-        const uint8* p = Bytes.GetData();
-        const uint8* end = p + Bytes.Num();
+    /**
+     * Load a WAV file as interleaved float samples in [-1, 1].
+     *
+     * Accepts 16-bit PCM (scaled by 1/32768) and 32-bit IEEE float (AudioFormat = 3),
+     * which is copied through untouched.
+     */
+    bool LoadWavFileToFloat(const FString& InPath, TArray<float>& OutPcm, int32& OutSR, int32& OutCh)
+    {
+        OutPcm.Reset(); OutSR = 0; OutCh = 0;
 
-        // Validate RIFF/WAVE header
-        if (!Match4(p, "RIFF"))
-        {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: not RIFF %s"), *Path);
-            return false;
-        }
-        uint32 riffSize = ReadU32LE(p + 4); (void)riffSize;
-        if (!Match4(p + 8, "WAVE"))
+        FWavFileView Wav;
+        if (!Wav.Open(InPath, /*bAllowFloat=*/true, TEXT("LoadWavFileToFloat")))
         {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: not WAVE %s"), *Path);
             return false;
         }
-        const uint8* cursor = p + 12;
 
-        // Scan for required chunks: "fmt " and "data"
-        bool haveFmt = false, haveData = false;
-        int32 Channels = 0;
-        int32 SampleRate = 0;
-        int32 BitsPerSample = 0;
-        const uint8* dataPtr = nullptr;
-        uint32 dataSize = 0;
+        Wav.ToFloat(OutPcm);
 
-        while (cursor + 8 <= end)
-        {
-            const uint8* chunkId = cursor;
-            uint32 chunkSize = ReadU32LE(cursor + 4);
-            const uint8* chunkData = cursor + 8;
-            const uint8* next = chunkData + chunkSize;
-            if (next > end)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: truncated chunk"));
-                return false;
-            }
+        OutSR = Wav.GetSampleRate();
+        OutCh = Wav.GetChannels();
 
-            if (Match4(chunkId, "fmt "))
-            {
-                // PCM format chunk (at least 16 bytes for PCM)
-                if (chunkSize < 16)
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: fmt chunk too small"));
-                    return false;
-                }
-                uint16 audioFormat = ReadU16LE(chunkData + 0);
-                uint16 numChannels = ReadU16LE(chunkData + 2);
-                uint32 sampleRate = ReadU32LE(chunkData + 4);
-                /*uint32 byteRate    =*/ ReadU32LE(chunkData + 8);
-                /*uint16 blockAlign  =*/ ReadU16LE(chunkData + 12);
-                uint16 bitsPerSample = ReadU16LE(chunkData + 14);
-
-                if (audioFormat != 1 /*PCM*/)
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: only PCM supported (format=%u)"), (unsigned)audioFormat);
-                    return false;
-                }
-                if (bitsPerSample != 16)
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: only 16-bit PCM supported (bps=%u)"), (unsigned)bitsPerSample);
-                    return false;
-                }
-                if (numChannels != 1 && numChannels != 2)
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: unsupported channels=%u"), (unsigned)numChannels);
-                    return false;
-                }
+        return true;
+    }
 
-                Channels = (int32)numChannels;
-                SampleRate = (int32)sampleRate;
-                BitsPerSample = (int32)bitsPerSample;
-                haveFmt = true;
-            }
-            else if (Match4(chunkId, "data"))
-            {
-                dataPtr = chunkData;
-                dataSize = chunkSize;
-                haveData = true;
-            }
+    bool FWavFileView::Open(const FString& InPath, bool bAllowFloat, const TCHAR* Context)
+    {
+        Close();
 
-            // Chunks are word-aligned: advance by size plus pad byte if size is odd.
-            cursor = next + (chunkSize & 1 ? 1 : 0);
-        }
+        const FString Path = ResolveProjectPath_V3(InPath);
+        UE_LOG(LogTemp, Display, TEXT("%s: '%s' -> '%s'"), Context, *InPath, *Path);
 
-        if (!haveFmt || !haveData || dataPtr == nullptr)
+        if (!FPaths::FileExists(Path))
         {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: missing fmt or data chunk"));
+            UE_LOG(LogTemp, Warning, TEXT("%s: file not found: %s"), Context, *Path);
             return false;
         }
 
-        if (BitsPerSample != 16 || Channels <= 0 || SampleRate <= 0)
+        // Parse in place over a mapping; read the file into memory only where mapping is unavailable.
+        const uint8* Image = nullptr;
+        int64 ImageSize = 0;
+        if (Mapping.Open(Path))
         {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: bad fmt parameters"));
-            return false;
+            Image = Mapping.GetData();
+            ImageSize = Mapping.GetSize();
+        }
+        else
+        {
+            if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("%s: read failed: %s"), Context, *Path);
+                return false;
+            }
+            Image = Bytes.GetData();
+            ImageSize = Bytes.Num();
         }
 
-        if (dataPtr + dataSize > end)
+        FWavInfo Info;
+        if (!ParseWav(Image, ImageSize, Context, Path, bAllowFloat, Info))
         {
-            UE_LOG(LogTemp, Warning, TEXT("LoadWavFileToPcm16: data size out of bounds"));
+            Close();
             return false;
         }
 
-        // Copy PCM payload as int16 little-endian samples (interleaved by channel).
-        const int32 SampleCount = (int32)(dataSize / sizeof(int16));
-        OutPcm.SetNumUninitialized(SampleCount);
-        FMemory::Memcpy(OutPcm.GetData(), dataPtr, SampleCount * sizeof(int16));
+        const int64 BytesPerSample = Info.BitsPerSample / 8;
+        Data = Info.Data;
+        NumSamples = (int32)FMath::Min<int64>(Info.DataSize / BytesPerSample, MAX_int32);
+        SampleRate = Info.SampleRate;
+        Channels = Info.Channels;
+        bFloat = (Info.AudioFormat == WavFormatFloat);
+        return true;
+    }
 
-        OutSR = SampleRate;
-        OutCh = Channels;
+    void FWavFileView::Close()
+    {
+        Mapping.Close();
+        Bytes.Empty();
+        Data = nullptr;
+        NumSamples = 0;
+        SampleRate = 0;
+        Channels = 0;
+        bFloat = false;
+    }
 
-        return true;
+    TConstArrayView<int16> FWavFileView::GetPcm16() const
+    {
+        // RIFF chunks start on even offsets, so 16-bit samples are always aligned.
+        if (!IsOpen() || bFloat || !IsAligned(Data, alignof(int16)))
+            return TConstArrayView<int16>();
+        return TConstArrayView<int16>(reinterpret_cast<const int16*>(Data), NumSamples);
+    }
+
+    TConstArrayView<float> FWavFileView::GetFloat() const
+    {
+        if (!IsOpen() || !bFloat || !IsAligned(Data, alignof(float)))
+            return TConstArrayView<float>();
+        return TConstArrayView<float>(reinterpret_cast<const float*>(Data), NumSamples);
+    }
+
+    void FWavFileView::ToFloat(TArray<float>& OutPcm) const
+    {
+        OutPcm.Reset();
+        if (!IsOpen()) return;
+
+        OutPcm.SetNumUninitialized(NumSamples);
+        if (bFloat)
+        {
+            FMemory::Memcpy(OutPcm.GetData(), Data, (SIZE_T)NumSamples * sizeof(float));
+        }
+        else
+        {
+            const int16* Src = reinterpret_cast<const int16*>(Data);
+            constexpr float Scale = 1.0f / 32768.0f;
+            for (int32 i = 0; i < NumSamples; ++i)
+            {
+                OutPcm[i] = (float)Src[i] * Scale;
+            }
+        }
     }
 
     /**
      * Save interleaved PCM16 samples to a WAV (RIFF/WAVE) file on disk.
      *
      * Inputs:
-     * - Pcm: interleaved int16 samples (mono or stereo).
+     * - Pcm: interleaved int16 samples in WAV channel order.
      * - SR: sample rate in Hz (> 0).
-     * - Ch: channel count (1 or 2).
+     * - Ch: channel count (1..8). More than two channels are written as
+     *   WAVE_FORMAT_EXTENSIBLE with the default speaker mask for that count.
      *
      * Returns true on success, false on failure (with a warning log).
      */
     bool SavePcm16ToWavFile(const FString& InPath, const TArray<int16>& Pcm, int32 SR, int32 Ch)
     {
-        if (SR <= 0 || (Ch != 1 && Ch != 2))
+        if (SR <= 0 || Ch < 1 || Ch > WavMaxChannels)
         {
             UE_LOG(LogTemp, Warning, TEXT("SavePcm16ToWavFile: bad params SR=%d Ch=%d"), SR, Ch);
             return false;
@@ -277,7 +426,8 @@ namespace PcmWav
         const uint32 BlockAlign = (BitsPerSample / 8) * (uint32)Ch;
         const uint32 ByteRate = (uint32)SR * BlockAlign;
         const uint32 DataBytes = (uint32)(Pcm.Num() * sizeof(int16));
-        const uint32 FmtChunkSize = 16; // PCM fmt chunk payload size
+        const bool bExtensible = Ch > 2;
+        const uint32 FmtChunkSize = bExtensible ? 40 : 16; // PCM fmt chunk payload size
         // RIFF chunk size (file size - 8): "WAVE" (4) + fmt chunk (8+N) + data chunk (8+M)
         const uint32 RiffSize = 4 /*WAVE*/ + (8 + FmtChunkSize) + (8 + DataBytes);
 
@@ -292,12 +442,20 @@ namespace PcmWav
         // fmt chunk (PCM)
         Out.Append((const uint8*)"fmt ", 4);
         WriteU32LE(Out, FmtChunkSize);
-        WriteU16LE(Out, 1);                 // AudioFormat = PCM
+        WriteU16LE(Out, bExtensible ? WavFormatExtensible : WavFormatPcm); // AudioFormat
         WriteU16LE(Out, (uint16)Ch);        // NumChannels
         WriteU32LE(Out, (uint32)SR);        // SampleRate
         WriteU32LE(Out, ByteRate);          // ByteRate
         WriteU16LE(Out, (uint16)BlockAlign);// BlockAlign
         WriteU16LE(Out, (uint16)BitsPerSample); // BitsPerSample
+        if (bExtensible)
+        {
+            WriteU16LE(Out, 22);                        // cbSize
+            WriteU16LE(Out, (uint16)BitsPerSample);     // ValidBitsPerSample
+            WriteU32LE(Out, WavChannelMasks[Ch - 1]);   // ChannelMask
+            WriteU16LE(Out, WavFormatPcm);              // SubFormat = KSDATAFORMAT_SUBTYPE_PCM
+            Out.Append(WavSubFormatTail, UE_ARRAY_COUNT(WavSubFormatTail));
+        }
 
         // data chunk header
         Out.Append((const uint8*)"data", 4);
@@ -14,22 +14,105 @@ public:
     static bool LoadWavToPcm16(const FString& WavPath, TArray<int32>& OutPcm16, int32& OutSampleRate, int32& OutChannels);
 
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
-    static bool EncodePcm16ToOpusPackets(const TArray<int32>& Pcm16, int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameMs, TArray<FOpusPacket>& OutPackets);
+    static bool EncodePcm16ToOpusPackets(const TArray<int32>& Pcm16, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets);
 
+    // Float path: samples stay in [-1, 1] float end to end (opus_encode_float / opus_decode_float).
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool LoadWavToFloat(const FString& WavPath, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels);
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool EncodeFloatToOpusPackets(const TArray<float>& Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets);
+
+    // First/second order ambisonics (AmbiX, 4/6/9/11 channels) through the projection encoder. OutHeader carries the
+    // demixing matrix; decode with DecodeOpusPacketsAtRate.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool EncodeAmbisonicsToOpusPackets(const TArray<float>& Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader);
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool DecodeOpusPacketsToFloat(const TArray<FOpusPacket>& Packets, int32 SampleRate, int32 Channels, TArray<float>& OutPcm);
+
+    // Polyphase sample rate conversion of interleaved float PCM (e.g. 44.1 kHz assets to 48 kHz for Opus).
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool ResamplePcmFloat(const TArray<float>& Pcm, int32 InSampleRate, int32 Channels, int32 OutSampleRate, TArray<float>& OutPcm);
+
+    // Smallest rate Opus accepts that is >= SampleRate (capped at 48 kHz).
+    UFUNCTION(BlueprintPure, Category = "AudioReplicator|Local")
+    static int32 GetOpusSampleRateFor(int32 SampleRate);
+
+    // Legacy headerless format (2-byte lengths, packets up to 64 KB); prefer PackOpusClip for anything stored.
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
     static void PackOpusPackets(const TArray<FOpusPacket>& Packets, TArray<uint8>& OutBuffer);
 
+    // Reads both PackOpusClip and legacy PackOpusPackets buffers.
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
     static bool UnpackOpusPackets(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets);
 
+    // Versioned container with the stream header embedded and CRC32C-checked blocks (see PackedClip.h).
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static void PackOpusClip(const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header, TArray<uint8>& OutBuffer);
+
+    // OutHeader is the embedded header; legacy buffers have none and return a default header.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool UnpackOpusClip(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader);
+
+    // Standard .opus file (Ogg Opus, RFC 7845) playable by browsers, ffmpeg and media players. OpusHead pre-skip is
+    // Header.PreSkip, or the delay of Header.Profile when 0; Opus Custom streams cannot be saved.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool SaveOggOpusFile(const FString& Path, const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header);
+
+    // Packets of the first Opus stream in an .opus/.ogg file. OutHeader is at 48 kHz with frame size and bitrate
+    // measured from the packets; OutHeader.PreSkip and OutHeader.EndTrim are trimmed on decode.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool LoadOggOpusFile(const FString& Path, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader);
+
+    // Bundle up to FramesPerPacket consecutive frames (max 120 ms) into multi-frame Opus packets.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool RepacketizeOpusPackets(const TArray<FOpusPacket>& Packets, int32 FramesPerPacket, TArray<FOpusPacket>& OutPackets);
+
+    // Inverse of RepacketizeOpusPackets: one single-frame packet per Opus frame.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool SplitOpusPackets(const TArray<FOpusPacket>& Packets, TArray<FOpusPacket>& OutPackets);
+
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
     static bool DecodeOpusPacketsToPcm16(const TArray<FOpusPacket>& Packets, int32 SampleRate, int32 Channels, TArray<int32>& OutPcm16);
 
+    // Decode at a reduced rate for cheap listeners. OutSampleRate is the rate the PCM was actually produced at.
+    // Header.PreSkip and Header.EndTrim are cut from the output.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool DecodeOpusPacketsAtRate(const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate);
+
+    // Same, straight from a packed clip: packets are decoded in place, without unpacking copies.
+    // Header is only used for legacy buffers; containers carry their own.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool DecodePackedOpusAtRate(const TArray<uint8>& Packed, const FOpusStreamHeader& Header, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate);
+
+    // Header and duration of a PackOpusClip container, read from its preamble and block index only.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool GetPackedClipInfo(const TArray<uint8>& Packed, FOpusStreamHeader& OutHeader, float& OutDurationSec);
+
+    // Decode DurationSec of a PackOpusClip container starting at StartSec (measured after the pre-skip), touching
+    // only the blocks in range (plus 80 ms of decoder pre-roll, which is discarded). Output is interleaved at
+    // OutSampleRate.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool DecodePackedRange(const TArray<uint8>& Packed, float StartSec, float DurationSec, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels);
+
+    // Write a PackOpusClip container to disk for GetPackedClipFileInfo / DecodePackedFileRange.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool SaveOpusClipFile(const FString& Path, const TArray<FOpusPacket>& Packets, const FOpusStreamHeader& Header);
+
+    // File variants of GetPackedClipInfo and DecodePackedRange. The container is memory-mapped instead of loaded,
+    // so opening costs the same for any length and only the blocks in range are read from disk.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool GetPackedClipFileInfo(const FString& Path, FOpusStreamHeader& OutHeader, float& OutDurationSec);
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
+    static bool DecodePackedFileRange(const FString& Path, float StartSec, float DurationSec, EOpusDecodeRate Rate, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels);
+
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
     static bool SavePcm16ToWav(const FString& OutPath, const TArray<int32>& Pcm16, int32 SampleRate, int32 Channels);
 
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Local")
-    static bool TranscodeWavToOpusAndBack(const FString& InWavPath, const FString& OutWavPath, int32 Bitrate = 32000, int32 FrameMs = 20);
+    static bool TranscodeWavToOpusAndBack(const FString& InWavPath, const FString& OutWavPath, int32 Bitrate = 32000, float FrameMs = 20.0f);
 
     UFUNCTION(BlueprintPure, Category = "AudioReplicator|Paths")
     static FString ResolveProjectPath(const FString& Path);
@@ -44,7 +127,7 @@ public:
     static FString FormatAudioTestReport(
         int32 SampleRate,
         int32 Channels,
-        int32 FrameMs /*=20*/,
+        float FrameMs /*=20*/,
         int32 BitrateKbps /*=32*/,
         int32 PcmSamplesTotal,
         int32 DecPcmSamplesTotal /*=-1 if unknown*/,
@@ -0,0 +1,61 @@
+#pragma once
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "AudioReplicatorBenchmarkLibrary.generated.h"
+
+/**
+ * Self-contained micro-benchmarks for the Opus pipeline.
+ * Every function synthesises its own test signal, runs each variant Iterations times,
+ * keeps the fastest run and returns a human-readable report.
+ */
+UCLASS()
+class AUDIOREPLICATOR_API UAudioReplicatorBenchmarkLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+public:
+
+    /** Float pipeline (opus_encode_float/opus_decode_float) vs the int16 pipeline with its conversions. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkFloatVsPcm16(int32 SampleRate = 48000, int32 Channels = 1, int32 Bitrate = 32000, float FrameMs = 20.0f, float DurationSec = 10.0f, int32 Iterations = 3);
+
+    /** Decode cost of one 48 kHz stream at every listener decode rate (EOpusDecodeRate), relative to full rate. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkDecodeRates(int32 Channels = 1, int32 Bitrate = 32000, float FrameMs = 20.0f, float DurationSec = 30.0f, int32 Iterations = 3);
+
+    /** Polyphase resampler throughput (output samples/sec on one core), vector kernel vs plain C++ kernel. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkResampler(int32 InSampleRate = 44100, int32 OutSampleRate = 48000, int32 Channels = 2, int32 TapsPerPhase = 32, float DurationSec = 10.0f, int32 Iterations = 3);
+
+    /**
+     * Encode cost and output size of every EOpusEncoderProfile on the same clip (talk spurts with silent gaps,
+     * so DTX shows up in the byte count). Realtime factor is per encoder on one core.
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkEncoderProfiles(int32 SampleRate = 48000, int32 Channels = 1, int32 Bitrate = 32000, float FrameMs = 20.0f, float DurationSec = 30.0f, int32 Iterations = 3);
+
+    /**
+     * Ambisonic ambience (Channels = 4/6/9/11, a moving source over a diffuse bed) through the projection encoder at
+     * Bitrate in total, vs coding every channel as its own mono stream at MonoBitrate. Reports bytes/sec and CPU of both.
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkAmbisonics(int32 Channels = 4, int32 Bitrate = 96000, int32 MonoBitrate = 32000, float FrameMs = 20.0f, float DurationSec = 30.0f, int32 Iterations = 3);
+
+    /**
+     * Mouth-to-ear latency budget of live voice at 48 kHz, excluding the network's base delay: frame fill + encoder
+     * lookahead + per-frame encode/decode time (99th percentile) + jitter buffer delay. The buffer is driven by a
+     * simulated link whose arrivals wobble by up to NetworkJitterMs, with its floor at MinBufferMs. Compares standard
+     * Opus at StandardFrameMs, RESTRICTED_LOWDELAY at CustomFrameMs and Opus Custom at CustomFrameMs (2.5 or 5).
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkLatency(int32 Channels = 1, int32 Bitrate = 64000, float StandardFrameMs = 20.0f, float CustomFrameMs = 2.5f, float NetworkJitterMs = 2.0f, int32 MinBufferMs = 0, float DurationSec = 10.0f);
+
+    /**
+     * Size and load-time validation cost of a voice clip stored as a legacy length-prefixed buffer vs the PackedClip
+     * container, with and without block checksums. Reports the CRC32C backend in use.
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkPackedClip(int32 Bitrate = 24000, float FrameMs = 20.0f, float DurationSec = 120.0f, int32 Iterations = 3);
+
+    /** Single-encoder encode vs segmented encode on worker threads (MaxSegments = 0 uses every worker). */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Benchmark")
+    static FString BenchmarkParallelEncode(int32 SampleRate = 48000, int32 Channels = 2, int32 Bitrate = 64000, float FrameMs = 20.0f, float DurationSec = 180.0f, int32 MaxSegments = 0, int32 Iterations = 3);
+};
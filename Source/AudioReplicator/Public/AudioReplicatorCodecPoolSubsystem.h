@@ -0,0 +1,209 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "OpusCodec.h"
+#include "AudioReplicatorDebugTypes.h"
+#include "AudioReplicatorCodecPoolSubsystem.generated.h"
+
+class FOpusCodecPool;
+
+/** Stream format that identifies interchangeable codec instances inside the pool. */
+struct FOpusCodecKey
+{
+    int32 SampleRate = AUDIO_REPL_OPUS_SR;
+    int32 Channels = 1;
+    int32 Bitrate = 32000;
+    EOpusApplication Application = EOpusApplication::Audio;
+    // Default = legacy settings with Application; any other profile also fixes Application.
+    EOpusEncoderProfile Profile = EOpusEncoderProfile::Default;
+
+    bool operator==(const FOpusCodecKey& Other) const
+    {
+        return SampleRate == Other.SampleRate
+            && Channels == Other.Channels
+            && Bitrate == Other.Bitrate
+            && Application == Other.Application
+            && Profile == Other.Profile;
+    }
+
+    friend uint32 GetTypeHash(const FOpusCodecKey& Key)
+    {
+        uint32 Hash = ::GetTypeHash(Key.SampleRate);
+        Hash = HashCombine(Hash, ::GetTypeHash(Key.Channels));
+        Hash = HashCombine(Hash, ::GetTypeHash(Key.Bitrate));
+        Hash = HashCombine(Hash, ::GetTypeHash((int32)Key.Application));
+        return HashCombine(Hash, ::GetTypeHash((uint8)Key.Profile));
+    }
+};
+
+/**
+ * Move-only handle to an encoder, decoder or full codec borrowed from FOpusCodecPool.
+ * The object goes back to the pool (after OPUS_RESET_STATE) when the lease is released or destroyed.
+ */
+template <typename CodecType>
+class TOpusLease
+{
+public:
+    TOpusLease() = default;
+    ~TOpusLease() { Release(); }
+
+    TOpusLease(TOpusLease&& Other) = default;
+    TOpusLease& operator=(TOpusLease&& Other)
+    {
+        if (this != &Other)
+        {
+            Release();
+            Pool = MoveTemp(Other.Pool);
+            Key = Other.Key;
+            Codec = MoveTemp(Other.Codec);
+        }
+        return *this;
+    }
+
+    TOpusLease(const TOpusLease&) = delete;
+    TOpusLease& operator=(const TOpusLease&) = delete;
+
+    bool IsValid() const { return Codec.IsValid(); }
+    explicit operator bool() const { return IsValid(); }
+
+    CodecType* Get() const { return Codec.Get(); }
+    CodecType* operator->() const { return Codec.Get(); }
+    CodecType& operator*() const { return *Codec; }
+
+    // Return the object to its pool early. Safe to call more than once.
+    void Release();
+
+private:
+    friend class FOpusCodecPool;
+
+    TWeakPtr<FOpusCodecPool, ESPMode::ThreadSafe> Pool;
+    FOpusCodecKey Key;
+    TUniquePtr<CodecType> Codec;
+};
+
+using FOpusCodecLease = TOpusLease<FOpusCodec>;
+using FOpusEncoderLease = TOpusLease<FOpusEncoderState>;
+using FOpusDecoderLease = TOpusLease<FOpusDecoderState>;
+
+/**
+ * Thread-safe free lists of Opus codec objects keyed by stream format.
+ * Encoders, decoders and full codecs are pooled separately so decode-only callers never pay for encoder state.
+ * Idle instances are capped per key; anything beyond the cap is destroyed on release.
+ */
+class AUDIOREPLICATOR_API FOpusCodecPool : public TSharedFromThis<FOpusCodecPool, ESPMode::ThreadSafe>
+{
+public:
+    explicit FOpusCodecPool(int32 InMaxPooledPerKey = 8);
+
+    // Borrow an object for the given format. Returns an invalid lease if it cannot be created.
+    // Decoders ignore Key.Bitrate, Key.Application and Key.Profile.
+    FOpusCodecLease Acquire(const FOpusCodecKey& Key);
+    FOpusEncoderLease AcquireEncoder(const FOpusCodecKey& Key);
+    FOpusDecoderLease AcquireDecoder(int32 SampleRate, int32 Channels);
+
+    // Change the per-key cap. Surplus idle instances are destroyed immediately.
+    void SetMaxPooledPerKey(int32 InMaxPooledPerKey);
+    int32 GetMaxPooledPerKey() const;
+
+    // Destroy every idle instance; outstanding leases are unaffected.
+    void Trim();
+
+    FAudioReplicatorCodecPoolStats GetStats() const;
+    void ResetStats();
+
+    // Called by TOpusLease::Release.
+    void Return(const FOpusCodecKey& Key, TUniquePtr<FOpusCodec> Codec);
+    void Return(const FOpusCodecKey& Key, TUniquePtr<FOpusEncoderState> Encoder);
+    void Return(const FOpusCodecKey& Key, TUniquePtr<FOpusDecoderState> Decoder);
+
+private:
+    template <typename CodecType>
+    using TIdleMap = TMap<FOpusCodecKey, TArray<TUniquePtr<CodecType>>>;
+
+    template <typename CodecType>
+    TOpusLease<CodecType> AcquireImpl(TIdleMap<CodecType>& Idle, const FOpusCodecKey& Key);
+
+    template <typename CodecType>
+    void ReturnImpl(TIdleMap<CodecType>& Idle, const FOpusCodecKey& Key, TUniquePtr<CodecType> Codec);
+
+    template <typename CodecType>
+    void TrimToCap(TIdleMap<CodecType>& Idle);
+
+    mutable FCriticalSection Mutex;
+    TIdleMap<FOpusCodec> IdleCodecs;
+    TIdleMap<FOpusEncoderState> IdleEncoders;
+    TIdleMap<FOpusDecoderState> IdleDecoders;
+    int32 MaxPooledPerKey = 8;
+    int32 IdleCount = 0;
+    int32 LeasedCount = 0;
+    int64 Hits = 0;
+    int64 Misses = 0;
+    int64 Discards = 0;
+};
+
+template <typename CodecType>
+void TOpusLease<CodecType>::Release()
+{
+    if (!Codec.IsValid())
+    {
+        return;
+    }
+
+    if (TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> PinnedPool = Pool.Pin())
+    {
+        PinnedPool->Return(Key, MoveTemp(Codec));
+    }
+
+    // Either handed back or the pool is gone; in the latter case the object dies with the lease.
+    Codec.Reset();
+    Pool.Reset();
+}
+
+/**
+ * Engine-wide owner of the Opus codec pool used by the blueprint library and components.
+ * Encoding and decoding short clips borrows codecs from here instead of creating and destroying them per call.
+ */
+UCLASS()
+class AUDIOREPLICATOR_API UAudioReplicatorCodecPoolSubsystem : public UEngineSubsystem
+{
+    GENERATED_BODY()
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /**
+     * Borrow a codec from the engine pool. Falls back to an unpooled codec when the subsystem
+     * is not available (e.g. before the engine is initialized), so callers never need a special case.
+     */
+    static FOpusCodecLease AcquireCodec(int32 SampleRate, int32 Channels, int32 Bitrate,
+        EOpusApplication Application = EOpusApplication::Audio);
+    static FOpusEncoderLease AcquireEncoder(int32 SampleRate, int32 Channels, int32 Bitrate,
+        EOpusApplication Application = EOpusApplication::Audio);
+    static FOpusCodecLease AcquireCodec(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+    static FOpusEncoderLease AcquireEncoder(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+    static FOpusCodecLease AcquireCodec(const FOpusCodecKey& Key);
+    static FOpusEncoderLease AcquireEncoder(const FOpusCodecKey& Key);
+    static FOpusDecoderLease AcquireDecoder(int32 SampleRate, int32 Channels);
+
+    /** Shared pool instance; may be captured by worker threads. Null when the subsystem is unavailable. */
+    static TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> GetPool();
+
+    /** Maximum number of idle codecs kept per stream format. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Codec Pool")
+    void SetMaxPooledPerKey(int32 InMaxPooledPerKey);
+
+    /** Destroy every idle codec currently held by the pool. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Codec Pool")
+    void TrimPool();
+
+    /** Hit/miss counters and current occupancy of the pool. */
+    UFUNCTION(BlueprintPure, Category = "AudioReplicator|Codec Pool")
+    FAudioReplicatorCodecPoolStats GetPoolStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Codec Pool")
+    void ResetPoolStats();
+
+private:
+    TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe> Pool;
+};
@@ -2,11 +2,16 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "OpusTypes.h"
+#include "OpusPacketList.h"
 #include "AudioReplicatorDebugTypes.h"
 #include "AudioReplicatorComponent.generated.h"
 
 // Blueprint delegates for monitoring replicated Opus sessions.
 class UAudioReplicatorComponent;
+class FOpusStreamEncoder;
+class FOpusJitterBuffer;
+class FOpusRateController;
+struct FOpusRateSample;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnOpusTransferStarted, FGuid, SessionId, FOpusStreamHeader, Header);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnOpusChunkReceived, FGuid, SessionId, FOpusChunk, Chunk);
@@ -18,10 +23,22 @@ struct FOutgoingTransfer
     GENERATED_BODY()
     FGuid SessionId;
     FOpusStreamHeader Header;
-    TArray<FOpusChunk> Chunks;
+    FOpusPacketList Packets; // Packed payloads; chunks are built one at a time when sent.
     int32 NextIndex = 0;
     bool bHeaderSent = false;
     bool bEndSent = false;
+
+    // Live sessions keep accepting PCM until EndLiveBroadcast; the end marker waits for that.
+    TSharedPtr<FOpusStreamEncoder> LiveEncoder;
+    bool bLive = false;
+    bool bLiveFinished = false;
+
+    // DTX frames skipped in total, and those not yet announced by a chunk's ElidedBefore or the end marker.
+    int32 ElidedFrames = 0;
+    int32 PendingElided = 0;
+
+    // Live sessions with bAdaptiveBitrate: retargets LiveEncoder from link measurements.
+    TSharedPtr<FOpusRateController> RateControl;
 };
 
 USTRUCT()
@@ -33,6 +50,58 @@ struct FIncomingTransfer
     int32 Received = 0;
     bool bStarted = false;
     bool bEnded = false;
+
+    // Set by Multicast_StartTransfer. Relayed chunks travel on the hub's channel and may get here before the header.
+    bool bHaveHeader = false;
+
+    // Slots the sender elided as silent; they stay empty in Packets and are concealed on decode.
+    TBitArray<> ElidedSlots;
+    int32 ElidedFrames = 0;
+
+    // Slots a chunk was placed in, and how many leading slots hold either a chunk or elided silence.
+    TBitArray<> ReceivedSlots;
+    int32 CoveredSlots = 0;
+
+    // Set by Multicast_EndTransfer. Relayed chunks may still be in flight on the hub's channel, so the session only
+    // ends once every slot before the trailing silence is covered, or EndMarkerTime is too long ago.
+    int32 EndSlots = INDEX_NONE;
+    int32 EndTrailingElided = 0;
+    double EndMarkerTime = 0.0;
+
+    // Playout buffer for live sessions when bEnableJitterBuffer is set.
+    TSharedPtr<FOpusJitterBuffer> Jitter;
+};
+
+// Live chunks of several speakers relayed by the hub in one RPC; entry i of each array describes stream i of Packet.
+USTRUCT()
+struct FOpusRelayBundle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<TObjectPtr<UAudioReplicatorComponent>> Speakers;
+
+    UPROPERTY()
+    TArray<FGuid> SessionIds;
+
+    UPROPERTY()
+    TArray<int32> Indices;
+
+    UPROPERTY()
+    TArray<int32> ElidedBefore;
+
+    // One single-stream packet per speaker, framed with OpusMultistreamPacket::Pack.
+    UPROPERTY()
+    FOpusPacket Packet;
+};
+
+// Server-side: a chunk waiting for the hub's next bundle.
+struct FOpusRelayedChunk
+{
+    TWeakObjectPtr<UAudioReplicatorComponent> Speaker;
+    FGuid SessionId;
+    FOpusChunk Chunk;
+    bool bReliable = true;
 };
 
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
@@ -46,6 +115,83 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net")
     int32 MaxPacketsPerTick = 32;
 
+    // Bundle up to this many consecutive frames (capped at 120 ms) into one multi-frame Opus packet per chunk,
+    // cutting the number of RPCs for clip broadcasts. Receivers split them back transparently. Live sessions are not bundled.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net", meta = (ClampMin = "1", ClampMax = "48"))
+    int32 FramesPerChunk = 1;
+
+    // Send live-session chunks over unreliable RPCs: a lost chunk is concealed (or FEC-recovered) by the
+    // receivers' jitter buffer instead of stalling the channel. Header and end marker stay reliable.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net")
+    bool bUnreliableLiveChunks = false;
+
+    // Adapt the bitrate of live sessions to the owning connection: backlog, RTT and loss push it down,
+    // a clear link lets it climb back to the session bitrate. The header keeps the starting bitrate.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net")
+    bool bAdaptiveBitrate = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net", meta = (EditCondition = "bAdaptiveBitrate"))
+    FOpusRateControlSettings RateControlSettings;
+
+    // Server relay hub: put one component with this flag on an always-relevant actor (e.g. the GameState).
+    // Live chunks of every speaker that arrive during a tick are then sent to clients as one multistream
+    // bundle instead of one multicast per speaker. Clip transfers and surround sessions are relayed as before.
+    // Chunks and the speaker's own header/end marker travel on different actor channels; receivers cope with
+    // chunks arriving before the header, and with a bundle landing after the end marker.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AudioReplicator|Net")
+    bool bRelayHub = false;
+
+    // Rate received sessions are decoded at. Mobile clients and server-side analysis can drop to 16/8 kHz
+    // for a fraction of the decode CPU and memory; OutSampleRate of the decode calls reports the actual rate.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Decode")
+    EOpusDecodeRate DecodeRate = EOpusDecodeRate::Native;
+
+    // Give each incoming live session a playout jitter buffer so it can be heard while it is still streaming
+    // (see PullLiveAudio). Clip transfers are unaffected.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Playback")
+    bool bEnableJitterBuffer = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Playback")
+    FOpusJitterBufferSettings JitterBufferSettings;
+
+    // Encode long clips on worker threads: the PCM is split into segments (with a short pre-roll)
+    // that are encoded concurrently and stitched in order. Clips too short to split stay single-threaded.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding")
+    bool bParallelEncode = false;
+
+    // Encoder settings for broadcasts started by this component; travels to receivers in FOpusStreamHeader::Profile.
+    // Low-latency/VOIP/bulk profiles cost less encode CPU than Default, music HQ costs more.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding")
+    EOpusEncoderProfile EncoderProfile = EOpusEncoderProfile::Default;
+
+    // Treat clips with 4, 6, 9 or 11 channels as first/second order ambisonics (AmbiX: ACN order, SN3D, optionally
+    // followed by a head-locked stereo pair) and code them with the Opus projection encoder. Much cheaper on the
+    // wire than coding the channels independently; receivers get ACN back.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding")
+    bool bAmbisonicInput = false;
+
+    // Live broadcasts open with StartupFrames short frames of StartupFrameMs so the first audio leaves (and plays)
+    // sooner, then settle on the FrameMs passed to BeginLiveBroadcast. Receivers follow the schedule in the header.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding")
+    bool bAdaptiveFrameSize = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding", meta = (EditCondition = "bAdaptiveFrameSize", ClampMin = "2.5", ClampMax = "120"))
+    float StartupFrameMs = 10.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding", meta = (EditCondition = "bAdaptiveFrameSize", ClampMin = "0"))
+    int32 StartupFrames = 10;
+
+    // Codec for live broadcasts. CustomLowDelay uses Opus Custom (CELT only, 2.5 or 5 ms frames at 48 kHz, 2.5 ms
+    // lookahead) for the shortest possible mouth-to-ear delay; only where libopus has custom modes (WITH_OPUS_CUSTOM),
+    // and not decodable at a reduced DecodeRate. Recorded in the header, so receivers pick the matching decoder.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Encoding")
+    EOpusCodecMode LiveCodecMode = EOpusCodecMode::Standard;
+
+    // Do not transmit DTX frames (packets of 2 bytes or less, produced by the VOIP profile during silence).
+    // Receivers regenerate them with the decoder's PLC/comfort-noise path.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Net")
+    bool bElideSilentFrames = true;
+
     // Multicast events exposed to gameplay code.
     UPROPERTY(BlueprintAssignable, Category = "AudioReplicator|Net")
     FOnOpusTransferStarted OnTransferStarted;
@@ -63,7 +209,51 @@ public:
 
     // 2) Broadcast from a WAV file (encode locally, then stream).
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
-    bool StartBroadcastFromWav(const FString& WavPath, int32 Bitrate, int32 FrameMs, FGuid SessionId, FGuid& OutSessionId);
+    bool StartBroadcastFromWav(const FString& WavPath, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId);
+
+    // Broadcast a pre-encoded .opus file as is (no decode or re-encode); see LoadOggOpusFile.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool StartBroadcastFromOggOpus(const FString& Path, FGuid SessionId, FGuid& OutSessionId);
+
+    // 3) Broadcast float PCM (e.g. a submix capture) without converting to int16 first.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool StartBroadcastFromFloat(const TArray<float>& Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId);
+
+    // C++ variant for audio callbacks that hand out views into mixer buffers.
+    bool StartBroadcastFromFloatView(TConstArrayView<float> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId);
+
+    // C++ entry point for packed packet lists; avoids a per-packet allocation for the whole transfer.
+    bool StartBroadcastPacketList(FOpusPacketList Packets, FOpusStreamHeader Header, FGuid SessionId, FGuid& OutSessionId);
+
+    // Rebroadcast a packed clip (PackOpusClip, or legacy PackOpusPackets with Header describing it; containers carry
+    // their own header). The buffer is copied once and every packet is sent as a view into it.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool StartBroadcastPacked(const TArray<uint8>& Packed, FOpusStreamHeader Header, FGuid SessionId, FGuid& OutSessionId);
+
+    // Rebroadcast DurationSec of a PackOpusClip container from StartSec. Only the packets in range are read and copied.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool StartBroadcastPackedRange(const TArray<uint8>& Packed, float StartSec, float DurationSec, FGuid SessionId, FGuid& OutSessionId);
+
+    // Same, from a PackOpusClip container on disk (see SaveOpusClipFile). The file is memory-mapped, so only the
+    // blocks in range are read, however long the archive.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool StartBroadcastPackedFile(const FString& Path, float StartSec, float DurationSec, FGuid SessionId, FGuid& OutSessionId);
+
+    // 4) Live capture (push-to-talk): open a session, push PCM as it is captured, then end it.
+    // Each frame is sent as soon as it fills, so latency is one frame rather than the clip length.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool BeginLiveBroadcast(int32 SampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId);
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool PushLiveFloat(const FGuid& SessionId, const TArray<float>& Pcm);
+
+    // C++ variants that take views straight from capture callbacks.
+    bool PushLiveFloatView(const FGuid& SessionId, TConstArrayView<float> Pcm);
+    bool PushLivePcm16(const FGuid& SessionId, TConstArrayView<int16> Pcm);
+
+    // Pad and send the last partial frame, then close the session once everything is out.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool EndLiveBroadcast(const FGuid& SessionId);
 
     // Abort an active transfer early if required.
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
@@ -73,6 +263,18 @@ public:
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
     bool GetReceivedPackets(const FGuid& SessionId, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader) const;
 
+    // Decode a received session straight to float PCM, ready for a procedural sound wave.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Net")
+    bool DecodeReceivedToFloat(const FGuid& SessionId, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels) const;
+
+    // Live playout: append every frame of a live session that is due now (decoded at DecodeRate) to OutPcm.
+    // Returns false if the session has no jitter buffer or has fully drained.
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Playback")
+    bool PullLiveAudio(const FGuid& SessionId, TArray<float>& OutPcm, int32& OutSampleRate, int32& OutChannels);
+
+    // Jitter buffer of a live incoming session, for pull-driven playout from C++. Null if there is none.
+    FOpusJitterBuffer* GetJitterBuffer(const FGuid& SessionId) const;
+
     // Debug helpers that expose the current state of transfers without having to gather data manually.
     UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Debug")
     bool GetOutgoingDebugInfo(const FGuid& SessionId, FAudioReplicatorOutgoingDebug& OutDebug) const;
@@ -92,8 +294,13 @@ protected:
     UFUNCTION(Server, Reliable)
     void Server_SendChunk(const FGuid& SessionId, const FOpusChunk& Chunk);
 
+    UFUNCTION(Server, Unreliable)
+    void Server_SendChunkUnreliable(const FGuid& SessionId, const FOpusChunk& Chunk);
+
+    // TrailingElided: silent frames after the last chunk that were not transmitted.
+    // NumSlots: slots in the whole session, trailing silence included.
     UFUNCTION(Server, Reliable)
-    void Server_EndTransfer(const FGuid& SessionId);
+    void Server_EndTransfer(const FGuid& SessionId, int32 TrailingElided, int32 NumSlots);
 
     // === MULTICAST RPC ===
     UFUNCTION(NetMulticast, Reliable)
@@ -102,8 +309,18 @@ protected:
     UFUNCTION(NetMulticast, Reliable)
     void Multicast_SendChunk(const FGuid& SessionId, const FOpusChunk& Chunk);
 
+    UFUNCTION(NetMulticast, Unreliable)
+    void Multicast_SendChunkUnreliable(const FGuid& SessionId, const FOpusChunk& Chunk);
+
     UFUNCTION(NetMulticast, Reliable)
-    void Multicast_EndTransfer(const FGuid& SessionId);
+    void Multicast_EndTransfer(const FGuid& SessionId, int32 TrailingElided, int32 NumSlots);
+
+    // Hub only: one tick's worth of relayed chunks. Unreliable when every chunk in it came in unreliably.
+    UFUNCTION(NetMulticast, Reliable)
+    void Multicast_RelayBundle(const FOpusRelayBundle& Bundle);
+
+    UFUNCTION(NetMulticast, Unreliable)
+    void Multicast_RelayBundleUnreliable(const FOpusRelayBundle& Bundle);
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
@@ -116,11 +333,54 @@ private:
     UPROPERTY()
     TMap<FGuid, FIncomingTransfer> Incoming;
 
-    // Helper: convert packets into indexed chunks for replication.
-    static void BuildChunks(const TArray<FOpusPacket>& Packets, TArray<FOpusChunk>& OutChunks);
+    // Server: live sessions of this speaker whose chunks go through the relay hub.
+    TSet<FGuid> RelayedSessions;
+
+    // Hub: chunks queued since the last flush.
+    TArray<FOpusRelayedChunk> PendingRelay;
+
+    // Helper: the world's relay hub, if any.
+    UAudioReplicatorComponent* GetRelayHub() const;
+
+    // Helper: hand a chunk to the hub; false if this session is not relayed through it.
+    bool RelayChunk(const FGuid& SessionId, const FOpusChunk& Chunk, bool bReliable);
+
+    // Hub: multicast everything queued, bundled per MaxStreamsPerRelayBundle speakers.
+    void FlushRelayBundles();
+
+    // Hub: unpack one bundle into the speakers' incoming transfers.
+    void ReceiveRelayBundle(const FOpusRelayBundle& Bundle);
+
+    // Helper: fill a replicated chunk from one entry of a packed list (reuses OutChunk's allocation).
+    static void BuildChunk(const FOpusPacketList& Packets, int32 Index, FOpusChunk& OutChunk);
+
+    // Helper: encode float PCM already at an Opus rate and start broadcasting it.
+    bool StartBroadcastResampledFloat(TConstArrayView<float> Pcm, int32 SampleRate, int32 SourceSampleRate, int32 Channels, int32 Bitrate, float FrameMs, FGuid SessionId, FGuid& OutSessionId);
+
+    // Helper: pick SessionId, or a fresh one if it is invalid. Fails if the id is already in use.
+    bool MakeOutgoingSessionId(const FGuid& SessionId, const TCHAR* Context, FGuid& OutSessionId) const;
+
+    // Helper: send up to MaxPacketsPerTick pending chunks; returns true once the end marker went out.
+    bool PumpTransfer(FOutgoingTransfer& Tr, FOpusChunk& Scratch);
+
+    // Helper: store a chunk that arrived over either RPC flavour.
+    void ReceiveChunk(const FGuid& SessionId, const FOpusChunk& Chunk);
+
+    // Helper: record silent frames the sender skipped, starting at slot First.
+    static void MarkElided(FIncomingTransfer& In, int32 First, int32 Count);
+
+    // Helper: end a session whose end marker arrived once every chunk before its trailing silence is in (or bForce).
+    void TryFinishIncoming(const FGuid& SessionId, FIncomingTransfer& In, bool bForce);
+
+    // Helper: current send backlog, RTT, throughput and loss of the connection this component sends through.
+    FOpusRateSample MeasureLink(const FOutgoingTransfer& Tr) const;
+
+    // Helper: encode one live push and send the resulting chunks immediately.
+    template <typename SampleType>
+    bool PushLiveImpl(const FGuid& SessionId, TConstArrayView<SampleType> Pcm);
 
-    // Helper: encode a WAV file into Opus packets on the client.
-    bool EncodeWavToOpusPackets(const FString& WavPath, int32 Bitrate, int32 FrameMs, TArray<FOpusPacket>& OutPackets, FOpusStreamHeader& OutHeader) const;
+    // Helper: encode a WAV file into a packed Opus packet list on the client.
+    bool EncodeWavToOpusPackets(const FString& WavPath, int32 Bitrate, float FrameMs, FOpusPacketList& OutPackets, FOpusStreamHeader& OutHeader) const;
 
     bool IsOwnerClient() const;
 };
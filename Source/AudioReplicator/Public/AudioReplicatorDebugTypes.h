@@ -27,6 +27,41 @@ struct FAudioReplicatorChunkDebug
     // True if this chunk has been received locally.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     bool bIsReceived = false;
+
+    // True if this is a silent DTX frame that is not transmitted and is concealed by the receiver.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    bool bIsElided = false;
+};
+
+/**
+ * One decision of a live session's bitrate controller and the link measurements behind it.
+ */
+USTRUCT(BlueprintType)
+struct FAudioReplicatorBitrateSample
+{
+    GENERATED_BODY()
+
+    // Seconds since the controller started.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float TimeSec = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 Bitrate = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float QueueDelayMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float RttMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float ThroughputKbps = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float LossPercent = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    bool bCongested = false;
 };
 
 /**
@@ -73,6 +108,24 @@ struct FAudioReplicatorOutgoingDebug
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     bool bTransferComplete = false;
 
+    // True while a live session is still accepting captured PCM.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    bool bLiveCapturing = false;
+
+    // Silent frames skipped on the wire so far (DTX).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 ElidedFrames = 0;
+
+    // Live sessions with bAdaptiveBitrate: the encoder's current target and recent controller decisions (oldest first).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    bool bRateControlled = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 CurrentBitrate = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    TArray<FAudioReplicatorBitrateSample> BitrateHistory;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     TArray<int32> PendingChunkIndices;
 
@@ -80,6 +133,59 @@ struct FAudioReplicatorOutgoingDebug
     TArray<FAudioReplicatorChunkDebug> Chunks;
 };
 
+/**
+ * Playout counters of a live session's jitter buffer.
+ */
+USTRUCT(BlueprintType)
+struct FAudioReplicatorJitterStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 PacketsReceived = 0;
+
+    // Packets that arrived after their slot had already been played or concealed.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 LatePackets = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 FramesPlayed = 0;
+
+    // Frames decoded from their own packet.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 FramesDecoded = 0;
+
+    // Lost frames rebuilt from the next packet's in-band FEC.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 FecRecoveredFrames = 0;
+
+    // Lost frames synthesised by PLC.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 ConcealedFrames = 0;
+
+    // DTX silence the sender skipped, played as comfort noise.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 ElidedFrames = 0;
+
+    // Frames stretched with PLC because the buffer ran dry.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 Underruns = 0;
+
+    // Buffered frames skipped to bring the delay back down.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 DroppedFrames = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float CurrentDelayMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float TargetDelayMs = 0.0f;
+
+    // 95th percentile of arrival delay above the fastest recent packet.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float JitterMs = 0.0f;
+};
+
 /**
  * Aggregated state for an incoming transfer that is useful during debugging.
  */
@@ -112,6 +218,10 @@ struct FAudioReplicatorIncomingDebug
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     int32 MissingChunks = 0;
 
+    // Silent frames the sender did not transmit (DTX); they are concealed on decode and do not count as missing.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 ElidedFrames = 0;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     int32 TotalBytes = 0;
 
@@ -124,6 +234,13 @@ struct FAudioReplicatorIncomingDebug
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     bool bReadyToAssemble = false;
 
+    // Live sessions with a playout jitter buffer report its counters here.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    bool bHasJitterBuffer = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    FAudioReplicatorJitterStats Jitter;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
     TArray<int32> MissingChunkIndices;
 
@@ -131,3 +248,40 @@ struct FAudioReplicatorIncomingDebug
     TArray<FAudioReplicatorChunkDebug> Chunks;
 };
 
+
+/**
+ * Counters and occupancy of the engine-wide Opus codec pool.
+ */
+USTRUCT(BlueprintType)
+struct FAudioReplicatorCodecPoolStats
+{
+    GENERATED_BODY()
+
+    // Acquisitions served by an idle pooled codec.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int64 Hits = 0;
+
+    // Acquisitions that had to create a new codec.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int64 Misses = 0;
+
+    // Released codecs destroyed because their key was already at the pool cap.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int64 Discards = 0;
+
+    // Codecs currently idle in the pool.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 IdleCodecs = 0;
+
+    // Codecs currently leased out.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 LeasedCodecs = 0;
+
+    // Number of distinct stream formats with idle codecs.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    int32 PooledKeys = 0;
+
+    // Hits / (Hits + Misses), or 0 when nothing was acquired yet.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Debug")
+    float HitRate = 0.0f;
+};
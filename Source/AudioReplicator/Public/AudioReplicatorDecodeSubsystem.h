@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h"
+#include "OpusTypes.h"
+#include "OpusPacketList.h"
+#include "AudioReplicatorDecodeSubsystem.generated.h"
+
+class UAudioReplicatorComponent;
+class FOpusCodecPool;
+
+/** Outcome of an async decode job, delivered on the game thread. */
+struct FOpusDecodeResult
+{
+    int64 JobId = 0;
+    FGuid SessionId;
+    bool bSuccess = false;
+    int32 SampleRate = 0;
+    int32 Channels = 0;
+
+    // Exactly one of these is filled, depending on the format the job was submitted with.
+    TArray<int16> Pcm16;
+    TArray<float> PcmFloat;
+};
+
+DECLARE_DELEGATE_OneParam(FOnOpusDecodeDone, FOpusDecodeResult& /*Result*/);
+
+// Blueprint notification for jobs submitted through DecodeReceivedSessionAsync.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FOnOpusDecodeCompleted, int64, JobId, FGuid, SessionId, bool, bSuccess, const TArray<float>&, Pcm, int32, SampleRate);
+
+/**
+ * Decodes received sessions on worker threads so a burst of finished transfers never hitches the game thread.
+ *
+ * Jobs borrow decoders from the engine codec pool, so decoder state is reused across jobs. Results are queued
+ * and handed back from Tick on the game thread, at most MaxCompletionsPerFrame / CompletionBudgetMs per frame.
+ * Cancelled jobs stop at the next packet batch and never invoke their callback.
+ */
+UCLASS()
+class AUDIOREPLICATOR_API UAudioReplicatorDecodeSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /**
+     * Queue a decode of Packets at Header.SampleRate (any Opus rate works, whatever the stream was encoded at). OnDone runs on the game thread unless the job is cancelled first.
+     * Header.PreSkip and Header.EndTrim are cut from the result. Returns the job id, or 0 if the job could not be queued.
+     */
+    int64 SubmitDecode(const FOpusStreamHeader& Header, FOpusPacketList Packets, bool bDecodeToFloat, FOnOpusDecodeDone OnDone, const FGuid& SessionId = FGuid());
+
+    /**
+     * Copy the packets of a received session and decode them in the background at the source component's
+     * DecodeRate; completion fires OnDecodeCompleted.
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Decode")
+    int64 DecodeReceivedSessionAsync(UAudioReplicatorComponent* Source, const FGuid& SessionId);
+
+    /**
+     * Decode a packed clip in the background; completion fires OnDecodeCompleted. Header describes legacy
+     * PackOpusPackets buffers, containers (PackOpusClip) carry their own.
+     * The buffer is copied once and the job decodes views into that copy, not per-packet arrays.
+     */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Decode")
+    int64 DecodePackedClipAsync(const TArray<uint8>& Packed, const FOpusStreamHeader& Header);
+
+    /** Cancel a queued or running job. Returns false if the job already completed or is unknown. */
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Decode")
+    bool CancelDecode(int64 JobId);
+
+    UFUNCTION(BlueprintCallable, Category = "AudioReplicator|Decode")
+    void CancelAllDecodes();
+
+    UFUNCTION(BlueprintPure, Category = "AudioReplicator|Decode")
+    int32 GetPendingDecodeCount() const { return Jobs.Num(); }
+
+    /** Upper bound on completion callbacks delivered per frame (0 = unlimited). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Decode")
+    int32 MaxCompletionsPerFrame = 4;
+
+    /** Stop delivering completions once this much game-thread time was spent in one frame (0 = unlimited). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator|Decode")
+    float CompletionBudgetMs = 1.0f;
+
+    UPROPERTY(BlueprintAssignable, Category = "AudioReplicator|Decode")
+    FOnOpusDecodeCompleted OnDecodeCompleted;
+
+private:
+    struct FJob;
+    using FJobRef = TSharedRef<FJob, ESPMode::ThreadSafe>;
+    using FJobPtr = TSharedPtr<FJob, ESPMode::ThreadSafe>;
+
+    // Shared with worker tasks so a task finishing after Deinitialize has somewhere safe to post to.
+    struct FCompletionQueue
+    {
+        TQueue<FJobPtr, EQueueMode::Mpsc> Done;
+    };
+
+    static void RunJob(const FJobRef& Job, const TSharedPtr<FOpusCodecPool, ESPMode::ThreadSafe>& Pool);
+
+    TSharedPtr<FCompletionQueue, ESPMode::ThreadSafe> Completions;
+    TMap<int64, FJobPtr> Jobs;
+    int64 NextJobId = 1;
+};
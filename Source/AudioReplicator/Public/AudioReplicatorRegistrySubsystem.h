@@ -72,6 +72,9 @@ public:
     /** Record activity for a session so subscribers can resolve the source component. */
     void NotifySessionActivity(const FGuid& SessionId, UAudioReplicatorComponent* Component);
 
+    /** Server-side component that bundles live chunks of all speakers (see UAudioReplicatorComponent::bRelayHub). */
+    UAudioReplicatorComponent* GetRelayHub() const { return RelayHub.Get(); }
+
 private:
     struct FReplicatorSubscription
     {
@@ -107,6 +110,7 @@ private:
     TMap<FGuid, TArray<FReplicatorSubscription>> ChannelSubscriptions;
     TMap<TWeakObjectPtr<APlayerState>, TArray<FReplicatorSubscription>> PlayerSubscriptions;
     TMap<FGuid, TWeakObjectPtr<UAudioReplicatorComponent>> LastSessionSenders;
+    TWeakObjectPtr<UAudioReplicatorComponent> RelayHub;
 
     FDelegateHandle ActorSpawnedHandle;
     FDelegateHandle GameStateSetHandle;
@@ -1,9 +1,20 @@
 ﻿#pragma once
 #include "CoreMinimal.h"
 #include "OpusTypes.h"
+#include "OpusPacketList.h"
 
 namespace Chunking
 {
     void PackWithLengths(const TArray<FOpusPacket>& Packets, TArray<uint8>& OutBuffer);
     bool UnpackWithLengths(const TArray<uint8>& Buffer, TArray<FOpusPacket>& OutPackets);
+
+    // Packed packet list variants: same wire format, no per-packet allocations.
+    void PackWithLengths(const FOpusPacketList& Packets, TArray<uint8>& OutBuffer);
+    bool UnpackWithLengths(const TArray<uint8>& Buffer, FOpusPacketList& OutPackets);
+
+    // Zero-copy unpack: OutPackets views the payloads inside Buffer and keeps it alive; see FOpusPacketList::ResetShared.
+    bool UnpackWithLengths(const FOpusPacketList::FSharedBuffer& Buffer, FOpusPacketList& OutPackets);
+
+    // Borrowed views into Buffer, valid only while Buffer is; for synchronous decode/inspect of a packed clip.
+    bool UnpackViews(TConstArrayView<uint8> Buffer, TArray<FOpusPacketView>& OutViews);
 }
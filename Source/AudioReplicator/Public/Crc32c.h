@@ -0,0 +1,17 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * CRC32C (Castagnoli polynomial, as in iSCSI/ext4) for validating packed clips.
+ *
+ * Uses the SSE4.2 crc32 instruction on x64 and the ARMv8 CRC extension on arm64 when the CPU has them
+ * (checked once at startup), and a table-driven loop elsewhere. All paths produce identical values.
+ */
+namespace Crc32c
+{
+    // CRC of NumBytes at Data. Pass the previous result as Crc to continue over split buffers.
+    uint32 Compute(const void* Data, int64 NumBytes, uint32 Crc = 0);
+
+    // True when Compute runs on hardware CRC instructions.
+    bool IsHardwareAccelerated();
+}
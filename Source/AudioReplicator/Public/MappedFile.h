@@ -0,0 +1,38 @@
+#pragma once
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Read-only memory mapping of a whole file (IPlatformFile::OpenMapped).
+ *
+ * Opening costs no reads: pages are faulted in from the OS file cache as the bytes are touched and can be
+ * dropped again under memory pressure, so large WAVs and packed clip archives never need a heap copy. Views
+ * into the mapping stay valid until Close or destruction. Platforms or files that cannot be mapped (e.g.
+ * files inside a pak) make Open fail quietly; callers fall back to FFileHelper.
+ */
+class AUDIOREPLICATOR_API FMappedFileView
+{
+public:
+    FMappedFileView();
+    ~FMappedFileView();
+
+    FMappedFileView(const FMappedFileView&) = delete;
+    FMappedFileView& operator=(const FMappedFileView&) = delete;
+
+    // FullPath must already be resolved (see PcmWav::ResolveProjectPath_V3). Empty files cannot be mapped.
+    bool Open(const FString& FullPath);
+    void Close();
+
+    bool IsOpen() const { return Region.IsValid(); }
+
+    const uint8* GetData() const { return Data; }
+    int64 GetSize() const { return Size; }
+
+private:
+    TUniquePtr<IMappedFileHandle> Handle;
+    TUniquePtr<IMappedFileRegion> Region; // must be released before Handle
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+
+class FOpusPacketList;
+
+namespace OggOpus
+{
+    /**
+     * Encoder delay to record as pre-skip, in 48 kHz samples, for a stream encoded with Header.Profile
+     * (2.5 ms for RESTRICTED_LOWDELAY profiles, 6.5 ms otherwise).
+     */
+    int32 GetDefaultPreSkip(const FOpusStreamHeader& Header);
+
+    /**
+     * Serialize encoded packets as an Ogg Opus stream (RFC 7845): an OpusHead page, an OpusTags page, then
+     * audio pages of at most about a second each with 48 kHz granule positions.
+     *
+     * Mono/stereo, surround (mapping family 1) and ambisonics (family 3) layouts are supported; Opus Custom
+     * streams have no Ogg mapping and are rejected. Empty packets (elided silence, missing chunks) are written as
+     * zero-length frames, as many as the packet before them held, which players conceal like lost packets. PreSkip defaults to Header.PreSkip, or to
+     * GetDefaultPreSkip when that is 0; Header.EndTrim shortens the final granule position.
+     */
+    bool WriteToMemory(const FOpusStreamHeader& Header, const FOpusPacketList& Packets, TArray<uint8>& OutBytes, int32 PreSkip = INDEX_NONE);
+
+    /**
+     * Parse the first Opus logical stream of an Ogg file. OutHeader describes the stream for our decoders
+     * (SampleRate 48000, layout from OpusHead, FrameMs/FramesPerPacket/Bitrate measured from the packets,
+     * PreSkip from OpusHead, EndTrim from the final granule position). Page CRCs are verified.
+     * Output gain and tags are ignored.
+     */
+    bool ReadFromMemory(TConstArrayView<uint8> Bytes, FOpusStreamHeader& OutHeader, FOpusPacketList& OutPackets);
+
+    // File variants; relative paths resolve like PcmWav::ResolveProjectPath_V3.
+    bool SaveOggOpusFile(const FString& Path, const FOpusStreamHeader& Header, const FOpusPacketList& Packets, int32 PreSkip = INDEX_NONE);
+    bool LoadOggOpusFile(const FString& Path, FOpusStreamHeader& OutHeader, FOpusPacketList& OutPackets);
+}
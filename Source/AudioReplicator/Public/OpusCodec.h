@@ -1,36 +1,243 @@
 #pragma once
 #include "CoreMinimal.h"
+#include "OpusTypes.h"
 
 // forward-declare,    <opus.h>   
 struct OpusEncoder;
 struct OpusDecoder;
 
-class AUDIOREPLICATOR_API FOpusCodec
+class FOpusStateArena;
+class FOpusPacketList;
+
+// Opus application modes (values mirror OPUS_APPLICATION_* from opus_defines.h).
+enum class EOpusApplication : int32
+{
+    Voip = 2048,
+    Audio = 2049,
+    RestrictedLowDelay = 2051
+};
+
+// Encoder CTLs applied for an EOpusEncoderProfile.
+struct AUDIOREPLICATOR_API FOpusEncoderProfileSettings
+{
+    EOpusApplication Application = EOpusApplication::Audio;
+    int32 Complexity = 8;
+    bool bVbr = true;
+    bool bConstrainedVbr = true; // libopus default
+    bool bDtx = false;
+    // In-band FEC (LBRR): each SILK packet carries a low-rate copy of the previous frame, tuned for PacketLossPerc.
+    bool bInbandFec = false;
+    int32 PacketLossPerc = 0;
+    // OPUS_SIGNAL_VOICE / OPUS_SIGNAL_MUSIC, or OPUS_AUTO to let the encoder decide.
+    int32 Signal = -1000;
+
+    static FOpusEncoderProfileSettings Get(EOpusEncoderProfile Profile);
+};
+
+/**
+ * Encoder-only Opus state.
+ *
+ * The OpusEncoder struct is sized with opus_encoder_get_size and initialised in place with
+ * opus_encoder_init, either in memory owned by this object (one allocation), in caller-provided
+ * memory, or in a slot of an FOpusStateArena.
+ */
+class AUDIOREPLICATOR_API FOpusEncoderState
 {
 public:
-    static TUniquePtr<FOpusCodec> Create(int32 SampleRate = AUDIO_REPL_OPUS_SR, int32 Channels = 1, int32 Bitrate = 32000);
+    // Bytes required for an encoder with the given channel count, or 0 if unsupported.
+    static int32 GetStateSize(int32 Channels);
+
+    FOpusEncoderState() = default;
+    ~FOpusEncoderState();
+
+    FOpusEncoderState(FOpusEncoderState&& Other);
+    FOpusEncoderState& operator=(FOpusEncoderState&& Other);
+
+    FOpusEncoderState(const FOpusEncoderState&) = delete;
+    FOpusEncoderState& operator=(const FOpusEncoderState&) = delete;
+
+    // Initialise in memory owned by this object.
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application = EOpusApplication::Audio);
+    // Initialise in caller memory (at least GetStateSize bytes, 16-byte aligned, must outlive this object).
+    bool InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application = EOpusApplication::Audio);
+    // Initialise in a slot taken from Arena; the slot is returned on Release().
+    bool InitFromArena(FOpusStateArena& Arena, int32 SampleRate, int32 Channels, int32 Bitrate, EOpusApplication Application = EOpusApplication::Audio);
+
+    // Same as above, configured from a named profile (the profile picks the application).
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+    bool InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+    bool InitFromArena(FOpusStateArena& Arena, int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+
+    // Drop the state and give its memory back to wherever it came from.
+    void Release();
+
+    bool IsValid() const { return Encoder != nullptr; }
+
+    // OPUS_RESET_STATE: forget stream history, keep bitrate and other settings.
+    bool Reset();
+
+    // OPUS_SET_BITRATE mid-stream; takes effect from the next encoded frame.
+    bool SetBitrate(int32 InBitrate);
+
+    // OPUS_GET_LOOKAHEAD: algorithmic delay in samples per channel (2.5 ms with RESTRICTED_LOWDELAY, 6.5 ms otherwise).
+    int32 GetLookaheadSamples() const;
 
     // PCM16 -> Opus packets
     bool EncodePcm16ToPackets(const TArray<int16>& Pcm, int32 FrameSizeSamplesPerCh, TArray<TArray<uint8>>& OutPackets);
+    // PCM16 -> packed packet list (all payloads in one buffer, O(1) allocations per clip)
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+    // Float PCM (nominal range [-1, 1]) -> packed packet list via opus_encode_float, no int16 round trip.
+    bool EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    // Encode exactly one interleaved frame (FramePcm.Num() / Channels samples per channel) and append it to OutPackets.
+    bool EncodeFrame(TConstArrayView<int16> FramePcm, FOpusPacketList& OutPackets);
+    bool EncodeFrame(TConstArrayView<float> FramePcm, FOpusPacketList& OutPackets);
+
+    OpusEncoder* GetHandle() const { return Encoder; }
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+    int32 GetBitrate() const { return Bitrate; }
+    EOpusApplication GetApplication() const { return Application; }
+    EOpusEncoderProfile GetProfile() const { return Profile; }
+
+private:
+    bool InitImpl(int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings);
+    bool InitInPlaceImpl(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings);
+    bool InitFromArenaImpl(FOpusStateArena& Arena, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings);
+    bool Setup(void* Memory, int32 SampleRate, int32 Channels, int32 InBitrate, EOpusEncoderProfile InProfile, const FOpusEncoderProfileSettings& Settings);
+
+    OpusEncoder* Encoder = nullptr;
+    void* OwnedMemory = nullptr;
+    FOpusStateArena* Arena = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 1;
+    int32 Bitrate = 32000;
+    EOpusApplication Application = EOpusApplication::Audio;
+    EOpusEncoderProfile Profile = EOpusEncoderProfile::Default;
+};
+
+/**
+ * Decoder-only Opus state; same memory options as FOpusEncoderState.
+ * Listeners that only play back received audio should use this and skip the (larger) encoder state.
+ */
+class AUDIOREPLICATOR_API FOpusDecoderState
+{
+public:
+    // Bytes required for a decoder with the given channel count, or 0 if unsupported.
+    static int32 GetStateSize(int32 Channels);
+
+    FOpusDecoderState() = default;
+    ~FOpusDecoderState();
+
+    FOpusDecoderState(FOpusDecoderState&& Other);
+    FOpusDecoderState& operator=(FOpusDecoderState&& Other);
+
+    FOpusDecoderState(const FOpusDecoderState&) = delete;
+    FOpusDecoderState& operator=(const FOpusDecoderState&) = delete;
+
+    bool Init(int32 SampleRate, int32 Channels);
+    bool InitInPlace(void* Memory, int32 MemorySize, int32 SampleRate, int32 Channels);
+    bool InitFromArena(FOpusStateArena& Arena, int32 SampleRate, int32 Channels);
+
+    void Release();
+
+    bool IsValid() const { return Decoder != nullptr; }
+
+    bool Reset();
+
     // Opus packets -> PCM16
     bool DecodePacketsToPcm16(const TArray<TArray<uint8>>& Packets, TArray<int16>& OutPcm);
 
+    /**
+     * Streaming decode without per-frame temporaries. OutPcm is sized once from
+     * opus_decoder_get_nb_samples and every packet is decoded straight into its slice.
+     * Empty packets (missing chunks, elided DTX frames) are concealed as one frame of the
+     * previous packet's frame length via the decoder's PLC path, so the timeline is preserved.
+     */
+    bool DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm);
+    bool DecodePacketListToPcm16(const FOpusPacketList& Packets, TArray<int16>& OutPcm);
+
+    /**
+     * Decode into caller-owned memory. Returns the number of interleaved samples written,
+     * or INDEX_NONE if a packet is invalid or OutPcm is too small (see GetDecodedSampleCount).
+     */
+    int32 DecodePacketsToBuffer(TConstArrayView<TArrayView<const uint8>> Packets, TArrayView<int16> OutPcm);
+
+    // Float variants via opus_decode_float, for handing buffers to the audio mixer without conversion.
+    bool DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm);
+    int32 DecodePacketsToBuffer(TConstArrayView<TArrayView<const uint8>> Packets, TArrayView<float> OutPcm);
+
+    /**
+     * Decode one frame for playout into Out (at least FrameSamplesPerCh * channels samples): Packet itself,
+     * PLC when Packet is empty, or with bFec the in-band FEC copy of the frame *before* Packet.
+     * Returns samples per channel written, or INDEX_NONE on error.
+     */
+    int32 DecodeFrameToBuffer(TArrayView<const uint8> Packet, int32 FrameSamplesPerCh, bool bFec, TArrayView<float> Out);
+
+    // Samples per channel carried by one packet at this decoder's rate, or INDEX_NONE if invalid.
+    int32 GetPacketSamplesPerChannel(TArrayView<const uint8> Packet) const;
+    // Interleaved samples (all channels) that decoding Packets will produce, or INDEX_NONE if any packet is invalid.
+    int32 GetDecodedSampleCount(TConstArrayView<TArrayView<const uint8>> Packets) const;
+
+    // Frame length (samples per channel at this decoder's rate) used to conceal empty packets that arrive before
+    // any frame was decoded. Without it leading gaps take the length of the first non-empty packet. Cleared by Reset().
+    void SetConcealFrameSamples(int32 SamplesPerCh) { ConcealHint = FMath::Max(0, SamplesPerCh); }
+
+    OpusDecoder* GetHandle() const { return Decoder; }
     int32 GetSampleRate() const { return SR; }
     int32 GetChannels() const { return Ch; }
 
+private:
+    bool Setup(void* Memory, int32 SampleRate, int32 Channels);
+
+    OpusDecoder* Decoder = nullptr;
+    void* OwnedMemory = nullptr;
+    FOpusStateArena* Arena = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 1;
+    int32 LastFrameSamples = 0; // frame length of the last decoded packet, carried across batched calls
+    int32 ConcealHint = 0;
+};
+
+/**
+ * Convenience pair of an encoder and a decoder sharing one stream format.
+ */
+class AUDIOREPLICATOR_API FOpusCodec
+{
+public:
+    static TUniquePtr<FOpusCodec> Create(int32 SampleRate = AUDIO_REPL_OPUS_SR, int32 Channels = 1, int32 Bitrate = 32000,
+        EOpusApplication Application = EOpusApplication::Audio);
+    static TUniquePtr<FOpusCodec> Create(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile);
+
+    // PCM16 -> Opus packets
+    bool EncodePcm16ToPackets(const TArray<int16>& Pcm, int32 FrameSizeSamplesPerCh, TArray<TArray<uint8>>& OutPackets);
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+    // Opus packets -> PCM16
+    bool DecodePacketsToPcm16(const TArray<TArray<uint8>>& Packets, TArray<int16>& OutPcm);
+
+    // Drop encoder/decoder history (OPUS_RESET_STATE) while keeping bitrate and other settings,
+    // so the instance can be reused for an unrelated stream.
+    bool Reset();
+
+    FOpusEncoderState& GetEncoder() { return Encoder; }
+    FOpusDecoderState& GetDecoder() { return Decoder; }
+
+    int32 GetSampleRate() const { return Encoder.GetSampleRate(); }
+    int32 GetChannels() const { return Encoder.GetChannels(); }
+    int32 GetBitrate() const { return Encoder.GetBitrate(); }
+    EOpusApplication GetApplication() const { return Encoder.GetApplication(); }
+    EOpusEncoderProfile GetProfile() const { return Encoder.GetProfile(); }
+
     //   ,  TUniquePtr   
-    ~FOpusCodec();
+    ~FOpusCodec() = default;
 
     //  
     FOpusCodec(const FOpusCodec&) = delete;
     FOpusCodec& operator=(const FOpusCodec&) = delete;
 
 private:
-    FOpusCodec(int32 InSR, int32 InCh, int32 InBitrate);
+    FOpusCodec() = default;
 
-    OpusEncoder* Encoder = nullptr;
-    OpusDecoder* Decoder = nullptr;
-    int32 SR = 48000;
-    int32 Ch = 1;
-    int32 Bitrate = 32000;
+    FOpusEncoderState Encoder;
+    FOpusDecoderState Decoder;
 };
@@ -0,0 +1,128 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+
+// Set by the Opus module: 1 where libopus is built with OPUS_CUSTOM_MODES (see BuildLinux.sh).
+#ifndef WITH_OPUS_CUSTOM
+#define WITH_OPUS_CUSTOM 0
+#endif
+
+struct OpusCustomMode;
+struct OpusCustomEncoder;
+struct OpusCustomDecoder;
+class FOpusPacketList;
+
+/**
+ * Ultra-low-delay encoder on top of the Opus Custom API (opus_custom_*), for 2.5 and 5 ms frames at 48 kHz.
+ *
+ * Custom mode is plain CELT: no SILK, no mode switching and no lookahead beyond the 2.5 ms MDCT overlap,
+ * so mouth-to-wire delay is one frame plus 2.5 ms. Packets carry no TOC byte and are not decodable by
+ * opus_decode; streams are marked with EOpusCodecMode::CustomLowDelay (WriteLayout) and must go through
+ * FOpusCustomDecoder. Every packet holds exactly one frame of the size given to Init.
+ *
+ * Only available when WITH_OPUS_CUSTOM is set; elsewhere Init fails with a warning.
+ */
+class AUDIOREPLICATOR_API FOpusCustomEncoder
+{
+public:
+    FOpusCustomEncoder() = default;
+    ~FOpusCustomEncoder();
+
+    FOpusCustomEncoder(const FOpusCustomEncoder&) = delete;
+    FOpusCustomEncoder& operator=(const FOpusCustomEncoder&) = delete;
+
+    // True when this build links a libopus with custom modes.
+    static bool IsAvailable() { return WITH_OPUS_CUSTOM != 0; }
+
+    // 48 kHz with 2.5 or 5 ms frames; both map onto libopus' built-in 48 kHz mode.
+    static bool IsSupportedFormat(int32 SampleRate, float FrameMs);
+
+    // Encoder lookahead (the CELT MDCT overlap) in samples per channel at SampleRate.
+    static int32 GetLookaheadSamples(int32 SampleRate) { return SampleRate / 400; }
+
+    // Complexity and VBR come from Profile; DTX, FEC and the application have no meaning for CELT and are ignored.
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameSizeSamplesPerCh, EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+    void Release();
+
+    bool IsValid() const { return Encoder != nullptr; }
+
+    // OPUS_RESET_STATE: forget stream history, keep bitrate and other settings.
+    bool Reset();
+
+    bool SetBitrate(int32 InBitrate);
+
+    // Encode exactly one interleaved frame of the Init size and append it to OutPackets.
+    bool EncodeFrame(TConstArrayView<int16> FramePcm, FOpusPacketList& OutPackets);
+    bool EncodeFrame(TConstArrayView<float> FramePcm, FOpusPacketList& OutPackets);
+
+    // Interleaved PCM -> packed packet list. FrameSizeSamplesPerCh must match Init; a trailing partial frame is dropped.
+    bool EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    // Mark Header as a custom-mode stream.
+    void WriteLayout(FOpusStreamHeader& Header) const;
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+    int32 GetBitrate() const { return Bitrate; }
+    int32 GetFrameSize() const { return FrameSize; }
+
+private:
+    template <typename SampleType>
+    bool AppendFrame(const SampleType* FramePcm, FOpusPacketList& OutPackets);
+
+    template <typename SampleType>
+    bool EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    OpusCustomMode* Mode = nullptr;
+    OpusCustomEncoder* Encoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 Bitrate = 0;
+    int32 FrameSize = 0; // per channel
+};
+
+/**
+ * Decoder for streams produced by FOpusCustomEncoder. Decodes at the stream rate only (custom streams cannot be
+ * decoded at a lower EOpusDecodeRate). Empty packets are concealed with CELT PLC, one frame each.
+ */
+class AUDIOREPLICATOR_API FOpusCustomDecoder
+{
+public:
+    FOpusCustomDecoder() = default;
+    ~FOpusCustomDecoder();
+
+    FOpusCustomDecoder(const FOpusCustomDecoder&) = delete;
+    FOpusCustomDecoder& operator=(const FOpusCustomDecoder&) = delete;
+
+    bool Init(int32 SampleRate, int32 Channels, int32 FrameSizeSamplesPerCh);
+
+    // Rate, channels and frame size from Header (FrameMs must be a custom-mode duration).
+    bool InitFromHeader(const FOpusStreamHeader& Header);
+
+    void Release();
+
+    bool IsValid() const { return Decoder != nullptr; }
+
+    bool Reset();
+
+    bool DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm);
+    bool DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm);
+
+    // Decode one packet (PLC when empty) into Out (at least one frame). Returns samples per channel, or INDEX_NONE.
+    int32 DecodeFrameToBuffer(TArrayView<const uint8> Packet, TArrayView<float> Out);
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+    int32 GetFrameSize() const { return FrameSize; }
+
+private:
+    template <typename SampleType>
+    bool DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm);
+
+    OpusCustomMode* Mode = nullptr;
+    OpusCustomDecoder* Decoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 FrameSize = 0; // per channel
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+#include "AudioReplicatorDebugTypes.h"
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "OpusCustom.h"
+
+/**
+ * Playout buffer for one live Opus session (one frame per packet).
+ *
+ * Packets are pushed by index as they arrive and decoded into float PCM as playout reaches them.
+ * The playout delay follows the 95th percentile of recent arrival jitter, clamped to the settings.
+ * A frame that never arrived is rebuilt from the next packet's in-band FEC when that packet is
+ * already buffered, otherwise concealed with PLC. Silence the sender elided (DTX) plays as comfort
+ * noise and is the first thing dropped when the buffer has to shrink.
+ *
+ * Frame durations follow the stream header, including a short-frame startup schedule, so timing
+ * is kept in stream seconds rather than frame counts.
+ *
+ * Custom-mode sessions (EOpusCodecMode::CustomLowDelay) get their own FOpusCustomDecoder instead of a pooled one;
+ * CELT carries no FEC, so lost frames there are always concealed.
+ *
+ * Packets are assumed to arrive in index order with gaps (RPCs may be dropped but are not reordered).
+ * Not thread-safe; push and pop from one thread.
+ */
+class AUDIOREPLICATOR_API FOpusJitterBuffer
+{
+public:
+    // Borrows a decoder from the codec pool; SampleRate is the decode rate, Header the live session's header.
+    // Custom-mode sessions always decode at the header rate.
+    bool Init(int32 SampleRate, const FOpusStreamHeader& Header, const FOpusJitterBufferSettings& InSettings);
+
+    bool IsValid() const { return Decoder.IsValid() || CustomDecoder.IsValid(); }
+
+    // Store packet Index that arrived at NowSec; the ElidedBefore slots right before it are DTX silence.
+    void Push(int32 Index, TConstArrayView<uint8> Packet, int32 ElidedBefore, double NowSec);
+
+    // The sender closed the session: play what is buffered without waiting for anything else.
+    void MarkEnded() { bEnded = true; }
+
+    /**
+     * Clock-driven playout: append every frame due by NowSec to OutPcm (interleaved float).
+     * The clock starts once the initial target delay is buffered. Returns the number of frames produced.
+     */
+    int32 PopDue(double NowSec, TArray<float>& OutPcm);
+
+    // Pull-driven playout (e.g. from an audio render callback): append exactly one frame to OutPcm.
+    // Returns false while prebuffering and once the session has drained.
+    bool PopFrame(TArray<float>& OutPcm);
+
+    // Ended and every buffered frame played.
+    bool IsDrained() const { return bEnded && bHaveFirst && NextIndex > HighestIndex; }
+
+    FAudioReplicatorJitterStats GetStats() const;
+
+    int32 GetSampleRate() const { return SampleRate; }
+    int32 GetChannels() const { return Channels; }
+
+private:
+    struct FSlot
+    {
+        int32 Index = INDEX_NONE;
+        bool bElided = false;
+        TArray<uint8> Data;
+    };
+
+    FSlot* FindSlot(int32 Index);
+    FSlot& ClaimSlot(int32 Index);
+    void UpdateJitter(int32 Index, double NowSec);
+    int32 GetBufferedFrames() const { return bHaveFirst ? FMath::Max(0, HighestIndex + 1 - NextIndex) : 0; }
+    double GetBufferedSec() const;
+    double GetFrameSec(int32 Index) const { return GetOpusFrameMsAt(Header, Index) / 1000.0; }
+    int32 GetFrameSamples(int32 Index) const { return GetOpusFrameSamples(SampleRate, GetOpusFrameMsAt(Header, Index)); }
+    bool TryStart();
+    void DecodeInto(TArray<float>& OutPcm, TArrayView<const uint8> Packet, int32 FrameSamplesPerCh, bool bFec);
+
+    FOpusDecoderLease Decoder;
+    TUniquePtr<FOpusCustomDecoder> CustomDecoder;
+    FOpusJitterBufferSettings Settings;
+    FOpusStreamHeader Header; // frame schedule
+    int32 SampleRate = 0;
+    int32 Channels = 0;
+
+    TArray<FSlot> Slots; // ring indexed by packet index
+    int32 NextIndex = 0;
+    int32 HighestIndex = INDEX_NONE;
+    bool bHaveFirst = false;
+    bool bStarted = false;
+    bool bEnded = false;
+
+    // Arrival offsets (arrival time - stream time of the packet) of recent packets.
+    TArray<double> Offsets;
+    int32 OffsetCursor = 0;
+    double JitterSec = 0.0;
+    double TargetDelaySec = 0.0;
+
+    // PopDue clock.
+    double PlayStartSec = 0.0;
+    double PlayedSec = 0.0;
+
+    FAudioReplicatorJitterStats Stats;
+};
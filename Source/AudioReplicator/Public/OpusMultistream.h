@@ -0,0 +1,114 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+
+struct OpusMSEncoder;
+struct OpusMSDecoder;
+class FOpusPacketList;
+
+/**
+ * Surround encoder for 1..8 channel clips (5.1, 7.1, ...) on top of opus_multistream.
+ *
+ * Uses the Vorbis channel mapping (RFC 7845 family 1): libopus splits the channels into coupled
+ * stereo and mono streams and spends the bitrate across them. Interleaved PCM is in WAV / Unreal
+ * channel order (FL FR FC LFE BL BR SL SR); it is reordered to Vorbis order internally. The stream
+ * layout the decoder needs is written to FOpusStreamHeader by WriteLayout.
+ */
+class AUDIOREPLICATOR_API FOpusMultistreamEncoder
+{
+public:
+    static constexpr int32 MaxChannels = 8;
+
+    FOpusMultistreamEncoder() = default;
+    ~FOpusMultistreamEncoder();
+
+    FOpusMultistreamEncoder(const FOpusMultistreamEncoder&) = delete;
+    FOpusMultistreamEncoder& operator=(const FOpusMultistreamEncoder&) = delete;
+
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+    void Release();
+
+    bool IsValid() const { return Encoder != nullptr; }
+
+    // Interleaved PCM -> packed packet list, one multistream packet per frame.
+    bool EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    // Record Streams, CoupledStreams, ChannelMapping and MappingFamily in Header.
+    void WriteLayout(FOpusStreamHeader& Header) const;
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+    int32 GetStreams() const { return Streams; }
+    int32 GetCoupledStreams() const { return CoupledStreams; }
+
+    // Layout libopus picks for Channels in family 1; lets a decoder be built when only the channel count is known.
+    static bool GetSurroundLayout(int32 SampleRate, int32 Channels, int32& OutStreams, int32& OutCoupledStreams, TArray<uint8>& OutMapping);
+
+private:
+    template <typename SampleType>
+    bool EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    OpusMSEncoder* Encoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 Bitrate = 0;
+    int32 Streams = 0;
+    int32 CoupledStreams = 0;
+    TArray<uint8> Mapping;
+};
+
+/**
+ * Decoder for streams produced by FOpusMultistreamEncoder. Output is interleaved in WAV / Unreal channel order.
+ * Empty packets (missing chunks) are concealed with PLC at the previous frame length, like FOpusDecoderState.
+ */
+class AUDIOREPLICATOR_API FOpusMultistreamDecoder
+{
+public:
+    FOpusMultistreamDecoder() = default;
+    ~FOpusMultistreamDecoder();
+
+    FOpusMultistreamDecoder(const FOpusMultistreamDecoder&) = delete;
+    FOpusMultistreamDecoder& operator=(const FOpusMultistreamDecoder&) = delete;
+
+    bool Init(int32 SampleRate, int32 Channels, int32 Streams, int32 CoupledStreams, TConstArrayView<uint8> Mapping);
+
+    // Use the layout carried by Header, decoding at SampleRate (Header.SampleRate or a lower Opus rate).
+    bool InitFromHeader(const FOpusStreamHeader& Header, int32 SampleRate);
+
+    void Release();
+
+    bool IsValid() const { return Decoder != nullptr; }
+
+    bool DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm);
+    bool DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm);
+
+    // See FOpusDecoderState::SetConcealFrameSamples.
+    void SetConcealFrameSamples(int32 SamplesPerCh) { ConcealHint = FMath::Max(0, SamplesPerCh); }
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+
+private:
+    template <typename SampleType>
+    bool DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm);
+
+    OpusMSDecoder* Decoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 LastFrameSamples = 0;
+    int32 ConcealHint = 0;
+};
+
+/**
+ * Multistream packet framing (RFC 6716 appendix B) used as a container: every stream but the last is stored
+ * self-delimited, the last one as is. The relay uses it to ship one packet per speaker in a single RPC.
+ */
+namespace OpusMultistreamPacket
+{
+    // Concatenate single-stream packets (none may be empty) into one multistream packet.
+    AUDIOREPLICATOR_API bool Pack(TConstArrayView<TArrayView<const uint8>> StreamPackets, TArray<uint8>& OutPacket);
+
+    // Split a multistream packet of NumStreams streams back into standalone single-stream packets.
+    AUDIOREPLICATOR_API bool Unpack(TArrayView<const uint8> Packet, int32 NumStreams, TArray<TArray<uint8>>& OutStreamPackets);
+}
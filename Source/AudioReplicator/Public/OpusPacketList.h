@@ -0,0 +1,100 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+
+// Non-owning view of a single Opus packet payload.
+using FOpusPacketView = TArrayView<const uint8>;
+
+// Fill Out with views over the payloads of blueprint-facing packets (valid while Packets is alive and unmodified).
+AUDIOREPLICATOR_API void GetOpusPacketViews(const TArray<FOpusPacket>& Packets, TArray<FOpusPacketView>& Out);
+
+/**
+ * Packed list of Opus packets: every payload is stored back to back in one contiguous byte
+ * buffer, with an offsets/lengths table on the side.
+ *
+ * Encoding a whole clip into a packet list costs O(1) allocations instead of one TArray per
+ * frame, and individual packets are exposed as cheap FOpusPacketView slices.
+ *
+ * A list can also view payloads that live in someone else's buffer (ResetShared / AddShared), e.g. a
+ * packed clip parsed by Chunking::UnpackWithLengths: the buffer is kept alive by a shared reference and
+ * nothing is copied. Copies of such a list share the buffer. The first modification other than
+ * AddShared copies the viewed payloads into the list's own storage (copy on write).
+ */
+class AUDIOREPLICATOR_API FOpusPacketList
+{
+public:
+    FOpusPacketList() = default;
+
+    // Drop all packets but keep the allocations for reuse.
+    void Reset();
+
+    using FSharedBuffer = TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+    // Drop all packets and view payloads inside Buffer from now on; add them with AddShared.
+    void ResetShared(const FSharedBuffer& Buffer);
+
+    // Append a view of Length bytes at Offset inside the shared buffer (must be in range).
+    void AddShared(int32 Offset, int32 Length);
+
+    // True while the payloads live in a shared buffer rather than in this list.
+    bool IsShared() const { return SharedBytes.IsValid(); }
+
+    // Pre-size storage for the given number of packets and payload bytes.
+    void Reserve(int32 NumPackets, int32 NumBytes);
+
+    int32 Num() const { return Offsets.Num(); }
+    bool IsEmpty() const { return Offsets.Num() == 0; }
+    bool IsValidIndex(int32 Index) const { return Offsets.IsValidIndex(Index); }
+
+    // Total payload bytes across all packets.
+    int32 GetTotalBytes() const { return IsShared() ? SharedPayloadBytes : Bytes.Num(); }
+
+    int32 GetLength(int32 Index) const { return Lengths[Index]; }
+
+    FOpusPacketView GetPacket(int32 Index) const
+    {
+        return FOpusPacketView(GetByteData() + Offsets[Index], Lengths[Index]);
+    }
+    FOpusPacketView operator[](int32 Index) const { return GetPacket(Index); }
+
+    // Append a copy of Packet.
+    void Add(FOpusPacketView Packet);
+
+    /**
+     * Two-phase append for encoders that write in place: BeginPacket returns room for at
+     * least MaxBytes at the tail of the buffer, CommitPacket records how many were used.
+     */
+    uint8* BeginPacket(int32 MaxBytes);
+    void CommitPacket(int32 NumBytes);
+
+    // Remove the most recently added packet and its payload bytes.
+    void RemoveLast();
+
+    // Append every packet of Other.
+    void Append(const FOpusPacketList& Other);
+
+    // Fill Out with views over every packet (valid until the list is modified).
+    void GetViews(TArray<FOpusPacketView>& Out) const;
+
+    // Conversion to/from the blueprint-facing per-packet representation.
+    void ToPackets(TArray<FOpusPacket>& Out) const;
+    static FOpusPacketList FromPackets(const TArray<FOpusPacket>& Packets);
+
+    // Own payload storage; empty while the list is shared.
+    const TArray<uint8>& GetBytes() const { return Bytes; }
+    const TArray<int32>& GetOffsets() const { return Offsets; }
+    const TArray<int32>& GetLengths() const { return Lengths; }
+
+private:
+    const uint8* GetByteData() const { return IsShared() ? SharedBytes->GetData() : Bytes.GetData(); }
+
+    // Copy the viewed payloads into Bytes, compacted, and let go of the shared buffer.
+    void Detach();
+
+    TArray<uint8> Bytes;
+    TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> SharedBytes;
+    int32 SharedPayloadBytes = 0;
+    TArray<int32> Offsets;
+    TArray<int32> Lengths;
+    int32 PendingOffset = INDEX_NONE;
+};
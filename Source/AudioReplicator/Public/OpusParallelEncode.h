@@ -0,0 +1,40 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusCodec.h"
+
+class FOpusPacketList;
+
+/**
+ * Tuning for segmented multi-threaded encoding of long clips.
+ */
+struct FOpusParallelEncodeSettings
+{
+    // Segments shorter than this are not worth a worker; short clips fall back to a single encoder.
+    int32 MinFramesPerSegment = 250;
+
+    // Frames encoded and discarded before each segment so the encoder's history matches a serial run at the seam.
+    int32 PreRollFrames = 5;
+
+    // Upper bound on segments; 0 uses one per worker thread plus the calling thread.
+    int32 MaxSegments = 0;
+};
+
+namespace OpusParallel
+{
+    /**
+     * Encode interleaved PCM into OutPackets by splitting it into independent segments that are
+     * encoded concurrently (one pooled encoder per segment) and stitched back in order.
+     *
+     * The output has exactly the frames a serial encode would produce (trailing partial frame dropped),
+     * and every packet is decodable by a single decoder walking the stitched list.
+     */
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate,
+        int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets,
+        const FOpusParallelEncodeSettings& Settings = FOpusParallelEncodeSettings(),
+        EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+
+    bool EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 SampleRate, int32 Channels, int32 Bitrate,
+        int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets,
+        const FOpusParallelEncodeSettings& Settings = FOpusParallelEncodeSettings(),
+        EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+
+struct OpusProjectionEncoder;
+struct OpusProjectionDecoder;
+class FOpusPacketList;
+
+/**
+ * Ambisonics encoder on top of opus_projection (RFC 7845 mapping family 3).
+ *
+ * Input is interleaved AmbiX (ACN channel order, SN3D normalisation) of first or second order: 4 or 9
+ * channels, or 6 / 11 with a trailing non-diegetic stereo pair. The encoder mixes the ambisonic channels
+ * into coupled streams before coding, which spends far fewer bits than coding every channel on its own.
+ * The demixing matrix the decoder needs is written to FOpusStreamHeader by WriteLayout.
+ */
+class AUDIOREPLICATOR_API FOpusProjectionEncoder
+{
+public:
+    FOpusProjectionEncoder() = default;
+    ~FOpusProjectionEncoder();
+
+    FOpusProjectionEncoder(const FOpusProjectionEncoder&) = delete;
+    FOpusProjectionEncoder& operator=(const FOpusProjectionEncoder&) = delete;
+
+    // True for 4, 6, 9 and 11 channels.
+    static bool IsSupportedChannelCount(int32 Channels);
+
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+    void Release();
+
+    bool IsValid() const { return Encoder != nullptr; }
+
+    // OPUS_RESET_STATE: forget stream history, keep bitrate, layout and other settings.
+    bool Reset();
+
+    // Interleaved ACN PCM -> packed packet list, one multistream packet per frame.
+    bool EncodeFloatToPacketList(TConstArrayView<float> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+    bool EncodePcm16ToPacketList(TConstArrayView<int16> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    // Record Streams, CoupledStreams, MappingFamily and DemixingMatrix in Header.
+    void WriteLayout(FOpusStreamHeader& Header) const;
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+    int32 GetStreams() const { return Streams; }
+    int32 GetCoupledStreams() const { return CoupledStreams; }
+
+private:
+    template <typename SampleType>
+    bool EncodeImpl(TConstArrayView<SampleType> Pcm, int32 FrameSizeSamplesPerCh, FOpusPacketList& OutPackets);
+
+    OpusProjectionEncoder* Encoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 Bitrate = 0;
+    int32 Streams = 0;
+    int32 CoupledStreams = 0;
+    TArray<uint8> DemixingMatrix;
+};
+
+/**
+ * Decoder for streams produced by FOpusProjectionEncoder; output is interleaved ACN/SN3D.
+ * Empty packets (missing chunks) are concealed with PLC, like FOpusMultistreamDecoder.
+ */
+class AUDIOREPLICATOR_API FOpusProjectionDecoder
+{
+public:
+    FOpusProjectionDecoder() = default;
+    ~FOpusProjectionDecoder();
+
+    FOpusProjectionDecoder(const FOpusProjectionDecoder&) = delete;
+    FOpusProjectionDecoder& operator=(const FOpusProjectionDecoder&) = delete;
+
+    bool Init(int32 SampleRate, int32 Channels, int32 Streams, int32 CoupledStreams, TConstArrayView<uint8> DemixingMatrix);
+
+    // Use the layout carried by Header, decoding at SampleRate (Header.SampleRate or a lower Opus rate).
+    bool InitFromHeader(const FOpusStreamHeader& Header, int32 SampleRate);
+
+    void Release();
+
+    bool IsValid() const { return Decoder != nullptr; }
+
+    bool Reset();
+
+    bool DecodePacketsToFloat(TConstArrayView<TArrayView<const uint8>> Packets, TArray<float>& OutPcm);
+    bool DecodePacketsToPcm16(TConstArrayView<TArrayView<const uint8>> Packets, TArray<int16>& OutPcm);
+
+    // See FOpusDecoderState::SetConcealFrameSamples.
+    void SetConcealFrameSamples(int32 SamplesPerCh) { ConcealHint = FMath::Max(0, SamplesPerCh); }
+
+    int32 GetSampleRate() const { return SR; }
+    int32 GetChannels() const { return Ch; }
+
+private:
+    template <typename SampleType>
+    bool DecodeImpl(TConstArrayView<TArrayView<const uint8>> Packets, TArray<SampleType>& OutPcm);
+
+    OpusProjectionDecoder* Decoder = nullptr;
+    int32 SR = 48000;
+    int32 Ch = 0;
+    int32 LastFrameSamples = 0;
+    int32 ConcealHint = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+#include "AudioReplicatorDebugTypes.h"
+
+// One measurement of the sender's link, taken just before a frame is encoded.
+struct FOpusRateSample
+{
+    // Audio waiting to go out: frames encoded but not yet sent plus the connection's queued bits, in seconds.
+    double QueueDelaySec = 0.0;
+
+    // Round trip time of the owning connection (0 = unknown).
+    double RttSec = 0.0;
+
+    // Bits per second the connection is getting through (0 = unknown).
+    double ThroughputBps = 0.0;
+
+    float LossPercent = 0.0f;
+};
+
+/**
+ * AIMD bitrate controller for one live session.
+ *
+ * The target grows linearly while the send backlog stays short and the round trip stays near the lowest
+ * one seen. A growing backlog, RTT inflation or packet loss cuts it by a factor, at most once per round
+ * trip so one backlog is not punished repeatedly. While congested, the target is also kept under the
+ * throughput the connection actually achieves.
+ *
+ * Recent decisions are kept for debugging. Not thread-safe.
+ */
+class AUDIOREPLICATOR_API FOpusRateController
+{
+public:
+    // StartBitrate is the session's bitrate; it is also the ceiling unless Settings.MaxBitrate says otherwise.
+    void Init(int32 StartBitrate, const FOpusRateControlSettings& InSettings, double NowSec);
+
+    // Feed one measurement and return the new target bitrate.
+    int32 Update(const FOpusRateSample& Sample, double NowSec);
+
+    int32 GetTargetBitrate() const { return FMath::RoundToInt32(Target); }
+
+    // Recorded decisions, oldest first.
+    void GetHistory(TArray<FAudioReplicatorBitrateSample>& Out) const;
+
+private:
+    void Record(const FOpusRateSample& Sample, bool bCongested, double NowSec);
+
+    FOpusRateControlSettings Settings;
+    double Target = 0.0;
+    double MinTarget = 0.0;
+    double MaxTarget = 0.0;
+
+    double StartSec = 0.0;
+    double LastUpdateSec = -1.0;
+    double LastDecreaseSec = -1.0;
+    double MinRttSec = 0.0;
+
+    // Ring of recent decisions.
+    TArray<FAudioReplicatorBitrateSample> History;
+    int32 HistoryCursor = 0;
+    double LastRecordSec = -1.0;
+};
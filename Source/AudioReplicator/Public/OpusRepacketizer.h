@@ -0,0 +1,48 @@
+#pragma once
+#include "CoreMinimal.h"
+
+struct OpusRepacketizer;
+class FOpusPacketList;
+
+/**
+ * Wrapper over opus_repacketizer for bundling consecutive frames into multi-frame Opus packets.
+ *
+ * A multi-frame packet is still a single valid Opus packet: decoders consume it directly and
+ * produce the same audio as the individual frames, so bundling only changes how audio is chunked
+ * for transport. Opus caps a packet at 120 ms, and frames can only share a packet when they
+ * have the same mode, bandwidth and frame size.
+ */
+class AUDIOREPLICATOR_API FOpusRepacketizer
+{
+public:
+    // Longest duration a single Opus packet may carry.
+    static constexpr int32 MaxPacketDurationMs = 120;
+
+    FOpusRepacketizer();
+    ~FOpusRepacketizer();
+
+    FOpusRepacketizer(const FOpusRepacketizer&) = delete;
+    FOpusRepacketizer& operator=(const FOpusRepacketizer&) = delete;
+
+    /**
+     * Merge runs of up to MaxPacketsPerGroup consecutive packets of In into Out. A run is cut short
+     * whenever the next packet would exceed 120 ms or is not compatible with the run.
+     */
+    bool Merge(const FOpusPacketList& In, int32 MaxPacketsPerGroup, FOpusPacketList& Out);
+
+    // Split every multi-frame packet of In into single-frame packets. Empty packets are passed through.
+    bool Split(const FOpusPacketList& In, FOpusPacketList& Out);
+
+    // Largest group size Merge can honour for FrameMs frames.
+    static int32 GetMaxPacketsPerGroup(float FrameMs)
+    {
+        return (FrameMs > 0.0f) ? FMath::Max(1, FMath::FloorToInt32(MaxPacketDurationMs / FrameMs)) : 1;
+    }
+
+private:
+    bool FlushGroup(FOpusPacketList& Out);
+
+    OpusRepacketizer* State = nullptr;
+    int32 GroupPackets = 0;
+    int32 GroupBytes = 0;
+};
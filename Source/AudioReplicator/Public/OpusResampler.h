@@ -0,0 +1,53 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * Polyphase windowed-sinc sample rate converter used to bring arbitrary input rates
+ * (44.1 kHz, 22.05 kHz, ...) to a rate Opus accepts.
+ *
+ * The ratio is reduced to L/M and a Kaiser-windowed sinc prototype is split into L phases of
+ * TapsPerPhase coefficients each. Every output sample is one dot product over contiguous input,
+ * vectorised through UE's VectorRegister (SSE on x64, NEON on ARM). Clips are converted in one
+ * call: there is no streaming state, and the output is aligned with the input (no filter delay).
+ */
+class AUDIOREPLICATOR_API FOpusResampler
+{
+public:
+    static bool IsOpusRate(int32 SampleRate);
+
+    // Smallest Opus rate >= SampleRate (48 kHz for anything above), so no input bandwidth is lost.
+    static int32 GetOpusRateFor(int32 SampleRate);
+
+    // TapsPerPhase is rounded up to a multiple of 4; 32 gives ~-80 dB stopband, 16 is a cheaper draft quality.
+    bool Init(int32 InRate, int32 OutRate, int32 Channels, int32 TapsPerPhase = 32);
+
+    bool IsValid() const { return Channels > 0; }
+
+    // Resample interleaved PCM. Output length is ceil(In frames * OutRate / InRate) per channel.
+    bool Process(TConstArrayView<float> In, TArray<float>& Out) const;
+    bool Process(TConstArrayView<int16> In, TArray<float>& Out) const;
+
+    // Benchmark hook: run the plain C++ inner loop instead of the vector one.
+    void SetUseVectorKernel(bool bInUseVector) { bUseVector = bInUseVector; }
+
+    int32 GetInRate() const { return InRate; }
+    int32 GetOutRate() const { return OutRate; }
+    int32 GetTapsPerPhase() const { return Taps; }
+
+    // Convenience: resample In to GetOpusRateFor(InRate). Copies unchanged when InRate already is an Opus rate.
+    static bool ResampleToOpusRate(TConstArrayView<float> In, int32 InRate, int32 Channels, TArray<float>& Out, int32& OutRate);
+
+private:
+    bool ProcessChannelMajor(const float* Planar, int32 InFrames, TArray<float>& Out) const;
+
+    int32 InRate = 0;
+    int32 OutRate = 0;
+    int32 Channels = 0;
+    int32 Up = 1;   // L
+    int32 Down = 1; // M
+    int32 Taps = 0;
+    bool bUseVector = true;
+
+    // Up phases x Taps coefficients, each phase stored time-reversed so it lines up with ascending input.
+    TArray<float> Coeffs;
+};
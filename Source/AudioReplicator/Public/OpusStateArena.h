@@ -0,0 +1,46 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-slot arena for in-place Opus encoder/decoder state.
+ *
+ * Memory is carved out of large blocks, so creating thousands of per-session decoders
+ * costs one allocation per block instead of one per decoder. Freed slots are recycled
+ * through an intrusive free list. The arena is not thread-safe and must outlive every
+ * state initialised from it.
+ */
+class AUDIOREPLICATOR_API FOpusStateArena
+{
+public:
+    // Opus state structs contain doubles/SIMD-friendly members; match malloc's guarantee.
+    static constexpr int32 SlotAlignment = 16;
+
+    explicit FOpusStateArena(int32 InSlotSize, int32 InSlotsPerBlock = 64);
+    ~FOpusStateArena();
+
+    FOpusStateArena(const FOpusStateArena&) = delete;
+    FOpusStateArena& operator=(const FOpusStateArena&) = delete;
+
+    // Returns SlotAlignment-aligned memory of at least GetSlotSize() bytes.
+    void* Allocate();
+
+    // Give a slot previously returned by Allocate() back to the arena.
+    void Free(void* Slot);
+
+    int32 GetSlotSize() const { return SlotSize; }
+    int32 GetSlotsInUse() const { return SlotsInUse; }
+    int32 GetNumBlocks() const { return Blocks.Num(); }
+
+private:
+    struct FFreeSlot
+    {
+        FFreeSlot* Next;
+    };
+
+    int32 SlotSize = 0;
+    int32 SlotsPerBlock = 0;
+    int32 NextSlotInBlock = 0;
+    int32 SlotsInUse = 0;
+    TArray<uint8*> Blocks;
+    FFreeSlot* FreeList = nullptr;
+};
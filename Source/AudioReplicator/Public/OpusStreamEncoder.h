@@ -0,0 +1,111 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusCodec.h"
+#include "AudioReplicatorCodecPoolSubsystem.h"
+#include "OpusCustom.h"
+
+class FOpusPacketList;
+
+/**
+ * Incremental Opus encoder for live capture (push-to-talk, submix taps).
+ *
+ * PCM is pushed in whatever block size the capture callback produces. Every frame that
+ * fills up is encoded immediately and appended to the caller's packet list, so latency is
+ * one frame instead of the whole clip. Whole frames inside a push are encoded straight from
+ * the caller's buffer; only the partial remainder is staged in a one-frame buffer that is
+ * allocated once in Init. Flush() pads a pending partial frame with silence.
+ *
+ * With SetStartupFrames the first few frames use a shorter size, so the first packet leaves
+ * sooner; the encoder then settles on the Init frame size for the rest of the stream.
+ *
+ * InitCustom swaps the pooled encoder for an Opus Custom one (FOpusCustomEncoder) for 2.5 / 5 ms frames; the
+ * push/flush interface is the same, but the frame size is fixed for the life of the stream.
+ *
+ * Not thread-safe; drive one instance from a single thread.
+ */
+class AUDIOREPLICATOR_API FOpusStreamEncoder
+{
+public:
+    FOpusStreamEncoder() = default;
+
+    FOpusStreamEncoder(const FOpusStreamEncoder&) = delete;
+    FOpusStreamEncoder& operator=(const FOpusStreamEncoder&) = delete;
+
+    // Borrow an encoder from the codec pool. FrameSizeSamplesPerCh must be a valid Opus frame size for SampleRate.
+    bool Init(int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameSizeSamplesPerCh,
+        EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+
+    // Own an Opus Custom encoder instead (ultra-low-delay mode, see FOpusCustomEncoder). No startup frames.
+    bool InitCustom(int32 SampleRate, int32 Channels, int32 Bitrate, int32 FrameSizeSamplesPerCh,
+        EOpusEncoderProfile Profile = EOpusEncoderProfile::Default);
+
+    /**
+     * Adaptive frame sizing: encode the next NumFrames frames at StartupFrameSizeSamplesPerCh (short, for fast
+     * time-to-first-audio), then continue at the Init frame size. Call right after Init, before any push.
+     */
+    bool SetStartupFrames(int32 StartupFrameSizeSamplesPerCh, int32 NumFrames);
+
+    // Return the encoder to the pool and drop any staged samples.
+    void Release();
+
+    bool IsValid() const { return Encoder.IsValid() || Custom.IsValid(); }
+    bool IsCustom() const { return Custom.IsValid(); }
+
+    /**
+     * Append interleaved PCM (Pcm.Num() must be a multiple of the channel count). Packets for every
+     * completed frame are appended to OutPackets. Returns the number of packets emitted, or INDEX_NONE on error.
+     */
+    int32 PushPcm16(TConstArrayView<int16> Pcm, FOpusPacketList& OutPackets);
+    int32 PushFloat(TConstArrayView<float> Pcm, FOpusPacketList& OutPackets);
+
+    /**
+     * Encode the staged partial frame, padded with silence to a full frame.
+     * Returns 1 if a packet was emitted, 0 if nothing was staged, INDEX_NONE on error.
+     */
+    int32 Flush(FOpusPacketList& OutPackets);
+
+    // Start a new utterance: drop staged samples and clear the encoder history. The frame schedule carries on.
+    bool Reset();
+
+    // Samples per channel waiting for the current frame to fill.
+    int32 GetStagedSamplesPerChannel() const;
+
+    // Silence samples per channel added by Flush calls so far (lets a receiver trim the tail).
+    int64 GetPaddedSamplesPerChannel() const { return PaddedSamplesPerCh; }
+
+    // Retarget the encoder (rate control); applies from the next frame. The pool restores the original on release.
+    bool SetBitrate(int32 Bitrate);
+    int32 GetBitrate() const;
+
+    // Size of the frame currently being filled; differs from the steady size while startup frames remain.
+    int32 GetFrameSize() const { return FrameSize; }
+    int32 GetSteadyFrameSize() const { return SteadyFrameSize; }
+    int32 GetSampleRate() const;
+    int32 GetChannels() const;
+
+private:
+    template <typename SampleType>
+    int32 PushImpl(TConstArrayView<SampleType> Pcm, TArray<SampleType>& Staging, FOpusPacketList& OutPackets);
+
+    template <typename SampleType>
+    int32 FlushImpl(TArray<SampleType>& Staging, FOpusPacketList& OutPackets);
+
+    // Encode one full frame with whichever encoder the stream was initialised with.
+    template <typename SampleType>
+    bool EncodeFrame(TConstArrayView<SampleType> FramePcm, FOpusPacketList& OutPackets);
+
+    // Count one encoded frame against the startup schedule.
+    void AdvanceFrame();
+
+    FOpusEncoderLease Encoder;
+    TUniquePtr<FOpusCustomEncoder> Custom;
+    int32 FrameSize = 0; // per channel
+    int32 SteadyFrameSize = 0;
+    int32 StartupFramesLeft = 0;
+
+    // Partial frame in the format it was pushed in; at most one of these is non-empty.
+    TArray<int16> Staged16;
+    TArray<float> StagedFloat;
+
+    int64 PaddedSamplesPerCh = 0;
+};
@@ -11,6 +11,91 @@ struct FOpusPacket
     TArray<uint8> Data;
 };
 
+// Listener-side decode rate. Any Opus stream can be decoded at a lower rate for a fraction of the CPU and memory.
+UENUM(BlueprintType)
+enum class EOpusDecodeRate : uint8
+{
+    Native  UMETA(DisplayName = "Stream Rate"),
+    Hz24000 UMETA(DisplayName = "24 kHz"),
+    Hz16000 UMETA(DisplayName = "16 kHz"),
+    Hz12000 UMETA(DisplayName = "12 kHz"),
+    Hz8000  UMETA(DisplayName = "8 kHz"),
+};
+
+// Decoder rate for a stream encoded at StreamRate; never above the stream's own rate.
+inline int32 GetOpusDecodeSampleRate(EOpusDecodeRate Rate, int32 StreamRate)
+{
+    switch (Rate)
+    {
+    case EOpusDecodeRate::Hz24000: return FMath::Min(StreamRate, 24000);
+    case EOpusDecodeRate::Hz16000: return FMath::Min(StreamRate, 16000);
+    case EOpusDecodeRate::Hz12000: return FMath::Min(StreamRate, 12000);
+    case EOpusDecodeRate::Hz8000:  return FMath::Min(StreamRate, 8000);
+    default:                       return StreamRate;
+    }
+}
+
+// Every frame duration Opus can encode. Durations above 60 ms come out of the encoder as multi-frame packets.
+inline constexpr float OpusFrameDurationsMs[] = { 2.5f, 5.0f, 10.0f, 20.0f, 40.0f, 60.0f, 80.0f, 100.0f, 120.0f };
+
+inline bool IsValidOpusFrameMs(float FrameMs)
+{
+    for (const float Valid : OpusFrameDurationsMs)
+    {
+        if (FrameMs == Valid)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Nearest duration from OpusFrameDurationsMs.
+inline float SnapOpusFrameMs(float FrameMs)
+{
+    float Best = OpusFrameDurationsMs[0];
+    for (const float Valid : OpusFrameDurationsMs)
+    {
+        if (FMath::Abs(Valid - FrameMs) < FMath::Abs(Best - FrameMs))
+        {
+            Best = Valid;
+        }
+    }
+    return Best;
+}
+
+// Samples per channel in one frame; exact for every Opus rate and duration (2.5 ms at 8 kHz is 20 samples).
+inline int32 GetOpusFrameSamples(int32 SampleRate, float FrameMs)
+{
+    return FMath::RoundToInt32(double(SampleRate) * FrameMs / 1000.0);
+}
+
+// Named encoder configurations, trading encode CPU against bandwidth and latency.
+UENUM(BlueprintType)
+enum class EOpusEncoderProfile : uint8
+{
+    // General audio, VBR, complexity 8.
+    Default          UMETA(DisplayName = "Default"),
+    // RESTRICTED_LOWDELAY (CELT only, 2.5 ms lookahead instead of 6.5 ms), constrained VBR, complexity 5.
+    VoiceLowLatency  UMETA(DisplayName = "Voice (Low Latency)"),
+    // VOIP with DTX: silence costs almost nothing on the wire. Complexity 5.
+    VoiceVoip        UMETA(DisplayName = "Voice (VOIP + DTX)"),
+    // General audio tuned for music, VBR, complexity 10.
+    MusicHighQuality UMETA(DisplayName = "Music (High Quality)"),
+    // General audio at complexity 2, for large offline batches where server CPU matters most.
+    BulkCheap        UMETA(DisplayName = "Bulk (Cheap)"),
+};
+
+// Bitstream a session is coded with. Custom streams can only be decoded by FOpusCustomDecoder.
+UENUM(BlueprintType)
+enum class EOpusCodecMode : uint8
+{
+    // Regular Opus (opus_encode / opus_decode), every rate and frame duration.
+    Standard       UMETA(DisplayName = "Standard"),
+    // Opus Custom (CELT only, no lookahead beyond the MDCT overlap), 2.5 or 5 ms frames at 48 kHz.
+    CustomLowDelay UMETA(DisplayName = "Custom (Ultra Low Delay)"),
+};
+
 USTRUCT(BlueprintType)
 struct FOpusStreamHeader
 {
@@ -25,12 +110,178 @@ struct FOpusStreamHeader
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
     int32 Bitrate = 32000;
 
+    // One of 2.5, 5, 10, 20, 40, 60, 80, 100 or 120.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
-    int32 FrameMs = 20;
+    float FrameMs = 20.0f;
 
     // Optional but handy for client-side buffering and progress tracking.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
     int32 NumPackets = 0;
+
+    // Rate of the source audio before it was resampled to SampleRate for Opus (0 = not resampled).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 SourceSampleRate = 0;
+
+    // Upper bound on FrameMs frames bundled into each packet by the repacketizer (1 = one frame per packet).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 FramesPerPacket = 1;
+
+    // Encoder profile the stream was produced with.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    EOpusEncoderProfile Profile = EOpusEncoderProfile::Default;
+
+    // Adaptive frame sizing: the first StartupFrames packets carry StartupFrameMs frames, the rest FrameMs (0 = fixed).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    float StartupFrameMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 StartupFrames = 0;
+
+    // Multistream layout for more than two channels (see FOpusMultistreamEncoder); Streams == 0 for a single stream.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 Streams = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 CoupledStreams = 0;
+
+    // Decoder output channel -> coded channel, one entry per channel.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    TArray<uint8> ChannelMapping;
+
+    // RFC 7845 channel mapping family of a multistream layout: 1 = surround, 3 = ambisonics (projection).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 MappingFamily = 0;
+
+    // Family 3 only: demixing matrix from the projection encoder (see FOpusProjectionEncoder).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    TArray<uint8> DemixingMatrix;
+
+    // Standard Opus or the Opus Custom low-delay variant (see FOpusCustomEncoder).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    EOpusCodecMode CodecMode = EOpusCodecMode::Standard;
+
+    // Leading samples, at 48 kHz, to discard after decoding (RFC 7845 pre-skip; set for streams read from .opus files).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 PreSkip = 0;
+
+    // Trailing samples, at 48 kHz, to discard after decoding (padding past the final Ogg granule position).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 EndTrim = 0;
+};
+
+// True for every multistream layout, surround and ambisonics alike.
+inline bool IsOpusMultistream(const FOpusStreamHeader& Header)
+{
+    return Header.Streams > 0;
+}
+
+inline bool IsOpusProjection(const FOpusStreamHeader& Header)
+{
+    return Header.Streams > 0 && Header.MappingFamily == 3;
+}
+
+inline bool IsOpusCustom(const FOpusStreamHeader& Header)
+{
+    return Header.CodecMode == EOpusCodecMode::CustomLowDelay;
+}
+
+// Frame duration of packet Index of a one-frame-per-packet stream.
+inline float GetOpusFrameMsAt(const FOpusStreamHeader& Header, int32 Index)
+{
+    return (Header.StartupFrameMs > 0.0f && Index < Header.StartupFrames) ? Header.StartupFrameMs : Header.FrameMs;
+}
+
+// Stream time at which packet Index starts, in seconds.
+inline double GetOpusFrameStartSec(const FOpusStreamHeader& Header, int32 Index)
+{
+    const int32 Startup = (Header.StartupFrameMs > 0.0f) ? FMath::Clamp(Index, 0, Header.StartupFrames) : 0;
+    return (double(Startup) * Header.StartupFrameMs + double(Index - Startup) * Header.FrameMs) / 1000.0;
+}
+
+// Header.PreSkip / Header.EndTrim converted to samples at SampleRate.
+inline int32 GetOpusPreSkipAt(const FOpusStreamHeader& Header, int32 SampleRate)
+{
+    return (int32)((int64)FMath::Max(0, Header.PreSkip) * SampleRate / 48000);
+}
+
+inline int32 GetOpusEndTrimAt(const FOpusStreamHeader& Header, int32 SampleRate)
+{
+    return (int32)((int64)FMath::Max(0, Header.EndTrim) * SampleRate / 48000);
+}
+
+// Drop the pre-skip and end-trim frames from interleaved PCM decoded from the start of the stream at SampleRate.
+template <typename SampleType>
+void TrimOpusDecodedPcm(const FOpusStreamHeader& Header, int32 SampleRate, int32 Channels, TArray<SampleType>& InOutPcm)
+{
+    if (Channels <= 0)
+        return;
+    const int32 NumFrames = InOutPcm.Num() / Channels;
+    const int32 Head = FMath::Min(GetOpusPreSkipAt(Header, SampleRate), NumFrames);
+    const int32 Tail = FMath::Min(GetOpusEndTrimAt(Header, SampleRate), NumFrames - Head);
+    if (Tail > 0)
+    {
+        InOutPcm.SetNum((NumFrames - Tail) * Channels, EAllowShrinking::No);
+    }
+    if (Head > 0)
+    {
+        InOutPcm.RemoveAt(0, Head * Channels, EAllowShrinking::No);
+    }
+}
+
+// Playout buffer tuning for live sessions (see FOpusJitterBuffer).
+USTRUCT(BlueprintType)
+struct FOpusJitterBufferSettings
+{
+    GENERATED_BODY()
+
+    // Lower bound on the adaptive playout delay.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 MinDelayMs = 40;
+
+    // Upper bound on the adaptive playout delay; anything buffered beyond it is dropped.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 MaxDelayMs = 400;
+
+    // Rebuild a lost frame from the in-band FEC carried by the following packet when it is already buffered.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    bool bUseFec = true;
+};
+
+// Live bitrate adaptation tuning (see FOpusRateController).
+USTRUCT(BlueprintType)
+struct FOpusRateControlSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "6000"))
+    int32 MinBitrate = 8000;
+
+    // Ceiling for the target; 0 = the bitrate the session was started with.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 MaxBitrate = 0;
+
+    // Additive increase while the link is clear.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 IncreaseBpsPerSec = 4000;
+
+    // Multiplicative decrease applied at most once per round trip while congested.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0.1", ClampMax = "1.0"))
+    float DecreaseFactor = 0.75f;
+
+    // Send backlog (our unsent frames plus the connection's queued bits) that counts as congestion.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 QueueHighMs = 150;
+
+    // The target only grows while the backlog is below this.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 QueueLowMs = 40;
+
+    // RTT above the lowest one seen by more than this counts as congestion (queues building up along the path).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0"))
+    int32 RttSlackMs = 150;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator", meta = (ClampMin = "0", ClampMax = "100"))
+    float LossHighPercent = 10.0f;
 };
 
 USTRUCT(BlueprintType)
@@ -45,4 +296,9 @@ struct FOpusChunk
     // Single Opus frame payload.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
     FOpusPacket Packet;
+
+    // Silent (DTX) frames right before Index that were not transmitted; receivers conceal them instead of
+    // treating them as lost.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AudioReplicator")
+    int32 ElidedBefore = 0;
 };
@@ -0,0 +1,139 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "OpusTypes.h"
+#include "OpusPacketList.h"
+#include "MappedFile.h"
+
+/**
+ * Versioned container for encoded clips, the successor of Chunking::PackWithLengths.
+ *
+ * Layout (all integers little endian, "varint" = unsigned LEB128, signed header fields zigzag encoded):
+ *   "ARPK" | version u8 | flags u8 | varint header size | FOpusStreamHeader fields
+ *   | varint packet count | varint packets per block | [index: (varint block bytes, varint block samples) x blocks]
+ *   | [CRC32C u32 of everything before it] | blocks: (varint length, payload) x packets per block | [CRC32C u32 of the block]
+ *
+ * A typical voice packet (< 128 bytes) costs one length byte instead of two, packets of any size fit,
+ * and the checksums make validation on load one hardware CRC pass per block. The optional block index
+ * lets FPackedClipReader jump to any time without walking the packets before it. Readers accept the
+ * legacy headerless format as well.
+ */
+namespace PackedClip
+{
+    constexpr uint8 FormatVersion = 1;
+
+    struct FPackOptions
+    {
+        // Packets covered by each block checksum.
+        int32 PacketsPerBlock = 64;
+
+        // Write CRC32C for the preamble and every block.
+        bool bChecksums = true;
+
+        // Write the block index used for seeking (a few bytes per block).
+        bool bIndex = true;
+    };
+
+    // Where a block starts in the buffer and in the stream.
+    struct FBlockIndexEntry
+    {
+        int32 Offset = 0;      // bytes from the start of the buffer
+        int32 Size = 0;        // bytes, checksum included
+        int64 FirstSample = 0; // per channel at the stream rate
+    };
+
+    // Decoder warm-up to start before a seek target (RFC 7845 recommends at least 80 ms).
+    constexpr float SeekPreRollMs = 80.0f;
+
+    // True if Buffer starts with the container magic; anything else is treated as the legacy format.
+    bool IsContainer(TConstArrayView<uint8> Buffer);
+
+    void Pack(const FOpusStreamHeader& Header, const FOpusPacketList& Packets, TArray<uint8>& OutBuffer, const FPackOptions& Options = FPackOptions());
+
+    // The unpack functions read both formats. InOutHeader is replaced by the embedded header;
+    // legacy buffers carry none and leave it as passed in.
+
+    // Borrowed views into Buffer, valid only while Buffer is.
+    bool UnpackViews(TConstArrayView<uint8> Buffer, FOpusStreamHeader& InOutHeader, TArray<FOpusPacketView>& OutViews);
+
+    bool Unpack(TConstArrayView<uint8> Buffer, FOpusStreamHeader& InOutHeader, FOpusPacketList& OutPackets);
+
+    // Zero-copy: OutPackets views the payloads inside Buffer and keeps it alive.
+    bool Unpack(const FOpusPacketList::FSharedBuffer& Buffer, FOpusStreamHeader& InOutHeader, FOpusPacketList& OutPackets);
+
+    // Pack and write to disk; relative paths resolve like PcmWav::ResolveProjectPath_V3. Read back with FMappedPackedClip.
+    bool SaveToFile(const FString& Path, const FOpusStreamHeader& Header, const FOpusPacketList& Packets, const FPackOptions& Options = FPackOptions());
+}
+
+/**
+ * Random access into a packed clip container. Open reads only the preamble and block index, then ReadRange
+ * parses (and checksums) just the blocks that overlap the requested span, so cost follows the range rather
+ * than the clip length. Containers written without an index are indexed once on Open; legacy buffers carry
+ * no timing and cannot be opened.
+ *
+ * The reader borrows the buffer, which must outlive it.
+ */
+class AUDIOREPLICATOR_API FPackedClipReader
+{
+public:
+    bool Open(TConstArrayView<uint8> InBuffer);
+
+    bool IsOpen() const { return Buffer.Num() > 0; }
+
+    const FOpusStreamHeader& GetHeader() const { return Header; }
+    int32 GetNumPackets() const { return Header.NumPackets; }
+
+    // Decoded length in samples per channel at GetHeader().SampleRate.
+    int64 GetTotalSamples() const { return TotalSamples; }
+
+    // Playable span [GetPlayStartSample(), GetPlayEndSample()) of the decoded clip: the header's PreSkip and
+    // EndTrim cut off. GetDurationSec is its length.
+    int64 GetPlayStartSample() const { return FMath::Min<int64>(GetOpusPreSkipAt(Header, Header.SampleRate), TotalSamples); }
+    int64 GetPlayEndSample() const { return FMath::Max<int64>(GetPlayStartSample(), TotalSamples - GetOpusEndTrimAt(Header, Header.SampleRate)); }
+    double GetDurationSec() const { return double(GetPlayEndSample() - GetPlayStartSample()) / FMath::Max(1, Header.SampleRate); }
+
+    /**
+     * Views of the packets overlapping [StartSample, EndSample) (per channel at the stream rate), clamped to the
+     * clip. OutFirstPacket and OutFirstSample locate the first returned packet, which may start before StartSample.
+     */
+    bool ReadRange(int64 StartSample, int64 EndSample, TArray<FOpusPacketView>& OutViews, int32& OutFirstPacket, int64& OutFirstSample) const;
+
+    // Duration of packet PacketIndex in samples per channel at the stream rate, counted the way the index is.
+    int32 GetPacketSampleCount(int32 PacketIndex, FOpusPacketView Packet) const;
+
+private:
+    TConstArrayView<uint8> Buffer;
+    FOpusStreamHeader Header;
+    bool bChecksums = false;
+    int32 PacketsPerBlock = 0;
+    int64 TotalSamples = 0;
+    TArray<PackedClip::FBlockIndexEntry> Blocks;
+};
+
+/**
+ * FPackedClipReader over a container file on disk. The file is memory-mapped, so Open costs the preamble and
+ * block index only and ReadRange pages in just the blocks it parses: an archive of any length opens at once and
+ * its payload never lands on the heap. Files that cannot be mapped are read into memory instead.
+ *
+ * Views returned by the reader point into the mapping and are valid until Close.
+ */
+class AUDIOREPLICATOR_API FMappedPackedClip
+{
+public:
+    // Relative paths resolve like PcmWav::ResolveProjectPath_V3. Containers must be under 2 GB.
+    bool Open(const FString& Path);
+    void Close();
+
+    bool IsOpen() const { return Reader.IsOpen(); }
+    bool IsMapped() const { return File.IsOpen(); }
+
+    const FPackedClipReader& GetReader() const { return Reader; }
+
+    // The whole container, e.g. for PackedClip::UnpackViews.
+    TConstArrayView<uint8> GetBuffer() const { return Buffer; }
+
+private:
+    FMappedFileView File;
+    TArray<uint8> Bytes; // only when the file could not be mapped
+    TConstArrayView<uint8> Buffer;
+    FPackedClipReader Reader;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "CoreMinimal.h"
+#include "MappedFile.h"
 
 namespace PcmWav
 {
@@ -12,12 +13,58 @@ namespace PcmWav
     FString ResolveProjectPath_V3(const FString& Path);
 
     /**
-     * Load a WAV (RIFF PCM 16-bit) file and output interleaved PCM16 samples.
+     * Load a WAV (RIFF PCM 16-bit, 1..8 channels) file and output interleaved PCM16 samples.
      */
     bool LoadWavFileToPcm16(const FString& Path, TArray<int16>& OutPcm, int32& OutSR, int32& OutCh);
 
+    /**
+     * Load a WAV (16-bit PCM or 32-bit IEEE float) file and output interleaved float samples in [-1, 1].
+     */
+    bool LoadWavFileToFloat(const FString& Path, TArray<float>& OutPcm, int32& OutSR, int32& OutCh);
+
+    /**
+     * A WAV file whose samples are read in place. The RIFF chunks are parsed straight over a memory mapping of
+     * the file and the data chunk is exposed as a view, so opening a long recording neither copies nor reads it.
+     * Files that cannot be mapped are loaded into memory once instead; the views work the same either way.
+     */
+    class AUDIOREPLICATOR_API FWavFileView
+    {
+    public:
+        // 16-bit PCM, plus 32-bit IEEE float when bAllowFloat is set. Context prefixes warnings.
+        bool Open(const FString& Path, bool bAllowFloat = true, const TCHAR* Context = TEXT("FWavFileView"));
+        void Close();
+
+        bool IsOpen() const { return SampleRate > 0; }
+        bool IsMapped() const { return Mapping.IsOpen(); }
+
+        int32 GetSampleRate() const { return SampleRate; }
+        int32 GetChannels() const { return Channels; }
+        bool IsFloat() const { return bFloat; }
+
+        // Interleaved samples in the data chunk.
+        int32 GetNumSamples() const { return NumSamples; }
+
+        // Interleaved samples in place; empty when the file holds the other format. Float data that is not 4-byte
+        // aligned within the file (an odd-sized fmt chunk) is not exposed as a view either, use ToFloat.
+        TConstArrayView<int16> GetPcm16() const;
+        TConstArrayView<float> GetFloat() const;
+
+        // Samples as float in [-1, 1], converting PCM16 and copying float data.
+        void ToFloat(TArray<float>& OutPcm) const;
+
+    private:
+        FMappedFileView Mapping;
+        TArray<uint8> Bytes; // whole file, only when it could not be mapped
+        const uint8* Data = nullptr;
+        int32 NumSamples = 0;
+        int32 SampleRate = 0;
+        int32 Channels = 0;
+        bool bFloat = false;
+    };
+
     /**
      * Serialize interleaved PCM16 samples to a standard WAV (RIFF PCM 16-bit) file.
+     * More than two channels are written as WAVE_FORMAT_EXTENSIBLE.
      */
     bool SavePcm16ToWavFile(const FString& Path, const TArray<int16>& Pcm, int32 SR, int32 Ch);
 }
@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+#
+# Reproducible static libopus build for Linux (x86_64 and arm64).
+#
+# Produces:
+#   Lib/Linux/x86_64-unknown-linux-gnu/libopus.a
+#   Lib/Linux/aarch64-unknown-linux-gnueabi/libopus.a
+#
+# The libraries are built with runtime CPU detection (OPUS_HAVE_RTCD): SSE4.1 and AVX2
+# kernels are compiled in on x86_64 and selected at startup, NEON is always on for arm64.
+# Custom modes are enabled so opus_custom_* is available alongside the regular API.
+#
+# Usage:
+#   ./BuildLinux.sh [x86_64|arm64|all]
+#
+# When LINUX_MULTIARCH_ROOT points at the Unreal cross-compile toolchain (as set up by the
+# engine's Linux SDK installer), its clang and sysroots are used so the archives match what
+# UnrealBuildTool links against. Otherwise the host clang/gcc is used for the host arch only.
+#
+# Requirements: cmake >= 3.16, ninja or make, curl, sha256sum, tar.
+
+set -euo pipefail
+
+OPUS_VERSION="${OPUS_VERSION:-1.5.2}"
+OPUS_SHA256="${OPUS_SHA256:-65c1d2f78b9f2fb20082c38cbe47c951ad5839345876e46941612ee87f9a7ce1}"
+OPUS_URL="https://downloads.xiph.org/releases/opus/opus-${OPUS_VERSION}.tar.gz"
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+WORK="${ROOT}/Intermediate/Linux"
+SRC="${WORK}/opus-${OPUS_VERSION}"
+TARGETS="${1:-all}"
+
+fetch_source()
+{
+    mkdir -p "${WORK}"
+    local Tarball="${WORK}/opus-${OPUS_VERSION}.tar.gz"
+
+    if [[ ! -f "${Tarball}" ]]; then
+        curl -fsSL "${OPUS_URL}" -o "${Tarball}"
+    fi
+    echo "${OPUS_SHA256}  ${Tarball}" | sha256sum -c -
+
+    rm -rf "${SRC}"
+    tar -xzf "${Tarball}" -C "${WORK}"
+}
+
+# build_arch <UE triple> <cmake processor>
+build_arch()
+{
+    local Triple="$1"
+    local Processor="$2"
+    local BuildDir="${WORK}/build-${Triple}"
+    local OutDir="${ROOT}/Lib/Linux/${Triple}"
+    local -a Toolchain=()
+
+    if [[ -n "${LINUX_MULTIARCH_ROOT:-}" ]]; then
+        local Sysroot="${LINUX_MULTIARCH_ROOT%/}/${Triple}"
+        Toolchain=(
+            -DCMAKE_SYSTEM_NAME=Linux
+            -DCMAKE_SYSTEM_PROCESSOR="${Processor}"
+            -DCMAKE_SYSROOT="${Sysroot}"
+            -DCMAKE_C_COMPILER="${Sysroot}/bin/clang"
+            -DCMAKE_C_COMPILER_TARGET="${Triple}"
+            -DCMAKE_AR="${Sysroot}/bin/llvm-ar"
+            -DCMAKE_RANLIB="${Sysroot}/bin/llvm-ranlib"
+        )
+    elif [[ "$(uname -m)" != "${Processor}" ]]; then
+        echo "Skipping ${Triple}: cross-compiling needs LINUX_MULTIARCH_ROOT" >&2
+        return 0
+    fi
+
+    local -a SimdOptions=()
+    if [[ "${Processor}" == "x86_64" ]]; then
+        # MAY_HAVE = compile the kernels and dispatch at runtime. Only SSE/SSE2 (baseline x86_64) are presumed,
+        # so the lib still runs on CPUs without SSE4.1/AVX2.
+        SimdOptions=(
+            -DOPUS_X86_MAY_HAVE_SSE=ON
+            -DOPUS_X86_MAY_HAVE_SSE2=ON
+            -DOPUS_X86_MAY_HAVE_SSE4_1=ON
+            -DOPUS_X86_MAY_HAVE_AVX2=ON
+            -DOPUS_X86_PRESUME_SSE=ON
+            -DOPUS_X86_PRESUME_SSE2=ON
+        )
+    else
+        # NEON is mandatory on AArch64; dotprod kernels are still picked at runtime.
+        SimdOptions=(
+            -DOPUS_MAY_HAVE_NEON=ON
+            -DOPUS_PRESUME_NEON=ON
+        )
+    fi
+
+    rm -rf "${BuildDir}"
+    cmake -S "${SRC}" -B "${BuildDir}" \
+        "${Toolchain[@]}" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DCMAKE_POSITION_INDEPENDENT_CODE=ON \
+        -DCMAKE_C_FLAGS="-fvisibility=hidden" \
+        -DBUILD_SHARED_LIBS=OFF \
+        -DOPUS_BUILD_SHARED_LIBRARY=OFF \
+        -DOPUS_BUILD_TESTING=OFF \
+        -DOPUS_BUILD_PROGRAMS=OFF \
+        -DOPUS_INSTALL_PKG_CONFIG_MODULE=OFF \
+        -DOPUS_INSTALL_CMAKE_CONFIG_MODULE=OFF \
+        -DOPUS_FIXED_POINT=OFF \
+        -DOPUS_ENABLE_FLOAT_API=ON \
+        -DOPUS_CUSTOM_MODES=ON \
+        -DOPUS_DRED=OFF \
+        -DOPUS_OSCE=OFF \
+        -DOPUS_STACK_PROTECTOR=OFF \
+        -DOPUS_DISABLE_INTRINSICS=OFF \
+        "${SimdOptions[@]}"
+
+    cmake --build "${BuildDir}" --config Release -j"$(nproc)"
+
+    # Fail loudly if configure silently dropped runtime dispatch (e.g. compiler without AVX2 support).
+    if [[ "${Processor}" == "x86_64" ]] && ! grep -rqs "OPUS_HAVE_RTCD" "${BuildDir}"; then
+        echo "OPUS_HAVE_RTCD was not enabled for ${Triple}" >&2
+        exit 1
+    fi
+
+    mkdir -p "${OutDir}"
+    cp "${BuildDir}/libopus.a" "${OutDir}/libopus.a"
+    echo "Built ${OutDir}/libopus.a"
+}
+
+fetch_source
+
+case "${TARGETS}" in
+    x86_64) build_arch x86_64-unknown-linux-gnu x86_64 ;;
+    arm64)  build_arch aarch64-unknown-linux-gnueabi aarch64 ;;
+    all)
+        build_arch x86_64-unknown-linux-gnu x86_64
+        build_arch aarch64-unknown-linux-gnueabi aarch64
+        ;;
+    *)
+        echo "Usage: $0 [x86_64|arm64|all]" >&2
+        exit 1
+        ;;
+esac
@@ -14,10 +14,28 @@ public class Opus : ModuleRules
         {
             string LibPath = Path.Combine(Root, "Lib", "Win64", "Release");
             PublicAdditionalLibraries.Add(Path.Combine(LibPath, "opus.lib"));
+            //  opus.lib   OPUS_CUSTOM_MODES
+            PublicDefinitions.Add("WITH_OPUS_CUSTOM=0");
+        }
+        else if (Target.Platform == UnrealTargetPlatform.Linux || Target.Platform == UnrealTargetPlatform.LinuxArm64)
+        {
+            //  libopus  RTCD (SSE4.1/AVX2/NEON),   BuildLinux.sh
+            string Triple = Target.Architecture == UnrealArch.Arm64
+                ? "aarch64-unknown-linux-gnueabi"
+                : "x86_64-unknown-linux-gnu";
+            string LibFile = Path.Combine(Root, "Lib", "Linux", Triple, "libopus.a");
+            if (!File.Exists(LibFile))
+            {
+                throw new BuildException("Opus: missing {0}. Run Source/ThirdParty/Opus/BuildLinux.sh first.", LibFile);
+            }
+            PublicAdditionalLibraries.Add(LibFile);
+            // BuildLinux.sh  OPUS_CUSTOM_MODES (opus_custom_*  FOpusCustomEncoder/Decoder)
+            PublicDefinitions.Add("WITH_OPUS_CUSTOM=1");
         }
         else
         {
-            // TODO:  Linux/Mac/Android   
+            // TODO:  Mac/Android   
+            PublicDefinitions.Add("WITH_OPUS_CUSTOM=0");
         }
 
         //      :